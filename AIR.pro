@@ -14,15 +14,31 @@ INCLUDEPATH += src \
 # Input Files
 HEADERS += \
     src/db/DatabaseManager.h \
+    src/db/StorageProfile.h \
+    src/db/AsyncQuery.h \
+    src/db/ReportJobQueue.h \
+    src/db/ConnectionPool.h \
+    src/db/RowSignature.h \
+    src/db/IntegrityVerifier.h \
+    src/db/MerkleIndex.h \
+    src/db/LedgerCache.h \
+    src/db/LedgerBalanceEngine.h \
+    src/db/Mass.h \
     src/ui/MainWindow.h \
     src/ui/views/HomeWidget.h \
     src/ui/views/ReceiptWidget.h \
     src/utils/ReportGenerator.h \
+    src/utils/PdfReportWriter.h \
+    src/utils/RowSource.h \
+    src/utils/RowTemplate.h \
+    src/utils/TableWriter.h \
+    src/utils/LIICsvImporter.h \
     src/ui/views/NLIWidget.h \
     src/ui/views/TrainingWidget.h \
     src/ui/views/GeneralLedgerWidget.h \
     src/db/UserDatabaseManager.h \
     src/ui/dialogs/LoginDialog.h \
+    src/ui/dialogs/LIIImportDialog.h \
     src/ui/dialogs/AIR_SplashScreen.h \
     src/ui/views/MaterialCodeDialog.h \
     src/ui/views/AdminWidget.h \
@@ -30,26 +46,52 @@ HEADERS += \
     src/ui/views/LIIWidget.h \
     src/ui/views/MBRWidget.h \
     src/ui/views/PinDialog.h \
+    src/ui/views/SqlPageModel.h \
+    src/ui/views/IntegrityAuditWidget.h \
+    src/ui/views/ReportJobsPanel.h \
+    src/ui/views/SignatureStatus.h \
+    src/ui/views/LedgerTableModel.h \
     
     
 
 SOURCES += \
     src/main.cpp \
     src/db/DatabaseManager.cpp \
+    src/db/StorageProfile.cpp \
+    src/db/AsyncQuery.cpp \
+    src/db/ReportJobQueue.cpp \
+    src/db/ConnectionPool.cpp \
+    src/db/RowSignature.cpp \
+    src/db/IntegrityVerifier.cpp \
+    src/db/MerkleIndex.cpp \
+    src/db/LedgerCache.cpp \
+    src/db/LedgerBalanceEngine.cpp \
+    src/db/Mass.cpp \
     src/ui/MainWindow.cpp \
     src/ui/views/HomeWidget.cpp \
     src/ui/views/ReceiptWidget.cpp \
     src/utils/ReportGenerator.cpp \
+    src/utils/PdfReportWriter.cpp \
+    src/utils/RowSource.cpp \
+    src/utils/RowTemplate.cpp \
+    src/utils/TableWriter.cpp \
+    src/utils/LIICsvImporter.cpp \
     src/ui/views/NLIWidget.cpp \
     src/ui/views/TrainingWidget.cpp \
     src/ui/views/GeneralLedgerWidget.cpp \
     src/db/UserDatabaseManager.cpp \
     src/ui/dialogs/LoginDialog.cpp \
+    src/ui/dialogs/LIIImportDialog.cpp \
     src/ui/dialogs/AIR_SplashScreen.cpp \
     src/ui/views/AdminWidget.cpp \
     src/ui/views/BackupRestoreWidget.cpp \
     src/ui/views/LIIWidget.cpp \
     src/ui/views/MBRWidget.cpp \
+    src/ui/views/SqlPageModel.cpp \
+    src/ui/views/IntegrityAuditWidget.cpp \
+    src/ui/views/ReportJobsPanel.cpp \
+    src/ui/views/SignatureStatus.cpp \
+    src/ui/views/LedgerTableModel.cpp \
     
 
 RESOURCES += resources.qrc
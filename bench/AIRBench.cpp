@@ -0,0 +1,414 @@
+#include <QtTest>
+#include <QFile>
+#include <QMap>
+#include <QPrinter>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTextDocument>
+#include <QVariant>
+#include "../src/db/DatabaseManager.h"
+#include "../src/db/StorageProfile.h"
+#include "../src/db/RowSignature.h"
+#include "../src/db/LedgerBalanceEngine.h"
+#include "../src/utils/ReportGenerator.h"
+#include "../src/utils/RowTemplate.h"
+
+// Each pair times the path a change replaced against the one that replaced
+// it, on the same data, so the two lines of output read as before / after.
+class AIRBench : public QObject {
+    Q_OBJECT
+
+private slots:
+    // =========================================================
+    // ROW SIGNATURES (one chained ledger row signed)
+    // =========================================================
+    void codecText();
+    void codecBinary();
+
+    // =========================================================
+    // PDF REPORTS (a 100k-line General Ledger; run one per process,
+    // e.g. `AIRBench pdfStreaming`, for a clean peak memory figure)
+    // =========================================================
+    void pdfHtmlDocument();
+    void pdfStreaming();
+
+    // =========================================================
+    // REPORT ROWS (10,000 General Ledger lines rendered to cell text;
+    // divide by 10,000 for the cost of a row)
+    // =========================================================
+    void rowsHtml();
+    void rowsTemplate();
+
+    // =========================================================
+    // SPREADSHEET EXPORT (a million-line General Ledger, timed
+    // once, with peak memory; one case per process as for PDFs)
+    // =========================================================
+    void tableCsv();
+    void tableSpreadsheetML();
+
+    // =========================================================
+    // STORAGE PROFILES (a temp database opened under each profile:
+    // 1,000 ledger lines inserted in one batch where it is writable,
+    // and a full General Ledger + ICR read in each)
+    // =========================================================
+    void profileInsert_data();
+    void profileInsert();
+    void profileReport_data();
+    void profileReport();
+
+private:
+    static QMap<QString, QVariant> ledgerRow();
+};
+
+// =========================================================
+// DATA
+// =========================================================
+
+namespace {
+const int PDF_ROWS = 100000;
+const int ROW_BATCH = 10000;
+const int TABLE_ROWS = 1000000;
+const int LEDGER_BATCH = 1000;
+const int REPORT_LINES = 100000;
+const int REPORT_RECEIPTS = 20000;
+
+// manual_ledger rows made up as they are read, so the source itself holds
+// nothing whatever the row count
+class LedgerRows : public RowSource {
+public:
+    explicit LedgerRows(int rows) : rows(rows) {}
+
+    int field(const QString &name) const override { return FIELDS.indexOf(name); }
+    bool next() override { return ++cursor < rows; }
+    QVariant value(int field) const override {
+        static const QString TYPES[] = { "Receipt", "Shipment", "Other Increase", "Nuclear Loss" };
+        static const QString CODES[] = { "RD", "SD", "GA", "LN" };
+        const int kind = cursor % 4;
+        switch (field) {
+        case 0:  return cursor + 1;                                 // id
+        case 1:  return QStringLiteral("2026-03-14");               // date
+        case 2:  return QStringLiteral("ICD-%1").arg(cursor / 10);  // ref
+        case 3:  return CODES[kind];                                // code
+        case 4:  return TYPES[kind];                                // type
+        case 5:  return qint64(1250375 + cursor);                   // u_weight (mg)
+        case 6:  return qint64(49012 + cursor % 1000);              // u235_weight
+        case 7:  return 1 + cursor % 12;                            // items
+        case 8:  return qint64(cursor) * 1000;                      // bal_u
+        case 9:  return qint64(cursor) * 40;                        // bal_u235
+        case 10: return cursor;                                     // bal_items
+        }
+        return QVariant();
+    }
+
+private:
+    inline static const QStringList FIELDS = { "id", "date", "ref", "code", "type", "u_weight", "u235_weight",
+                                               "items", "bal_u", "bal_u235", "bal_items" };
+    int rows;
+    int cursor = -1;
+};
+
+// Linux only: peak resident memory since the last reset, in KiB (-1 elsewhere)
+void resetPeakMemory() {
+    QFile clear("/proc/self/clear_refs");
+    if (clear.open(QIODevice::WriteOnly)) clear.write("5");
+}
+
+qint64 peakMemoryKb() {
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) return -1;
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+
+// The replaced report path: one General Ledger line appended to the
+// report's HTML, a temporary per cell. Fields by LedgerRows' numbering.
+void appendGlHtmlRow(QString &html, RowSource &data, int line) {
+    const LedgerBalanceEngine::Type type = LedgerBalanceEngine::typeOf(data.text(4));
+    const QString u = data.mass(5).toString();
+    const QString u235 = data.mass(6).toString();
+    const int items = int(data.count(7));
+
+    html += "<tr>";
+    html += "<td>" + QString::number(line) + "</td>";
+    html += "<td>" + data.text(1) + "</td>";
+    html += "<td>" + data.text(2) + "</td>";
+    html += "<td>" + data.text(3) + "</td>";
+    html += "<td>" + (LedgerBalanceEngine::movesItems(type) && items > 0 ? QString::number(items) : QString()) + "</td>";
+    QString cells[8];
+    switch (LedgerBalanceEngine::columnOf(type)) {
+    case LedgerBalanceEngine::Receipts:       cells[0] = u; cells[1] = u235; break;
+    case LedgerBalanceEngine::OtherIncreases: cells[2] = u; cells[3] = u235; break;
+    case LedgerBalanceEngine::Shipments:      cells[4] = u; cells[5] = u235; break;
+    case LedgerBalanceEngine::OtherDecreases: cells[6] = u; cells[7] = u235; break;
+    case LedgerBalanceEngine::NoColumn:                                      break;
+    }
+    for (const QString &c : cells) html += "<td>" + c + "</td>";
+    html += "<td style='background-color:#e8f5e9'>" + data.mass(8).toString() + "</td>";
+    html += "<td style='background-color:#e8f5e9'>" + data.mass(9).toString() + "</td>";
+    html += "<td style='background-color:#e8f5e9'>" + QString::number(data.count(10)) + "</td>";
+    html += "</tr>";
+}
+
+// Ledger lines as the General Ledger form enters them (weights in grams)
+QList<QMap<QString, QVariant>> ledgerBatch(int lines) {
+    static const QString TYPES[] = { "Receipt", "Shipment", "Other Increase", "Nuclear Loss" };
+    QList<QMap<QString, QVariant>> batch;
+    batch.reserve(lines);
+    for (int i = 0; i < lines; ++i) {
+        batch.append({ { "date", "2026-03-14" }, { "ref", QString("ICD-%1").arg(i / 10) }, { "code", "RD" },
+                       { "type", TYPES[i % 4] }, { "u_weight", 1250.375 }, { "u235_weight", 49.012 },
+                       { "items", 1 + i % 12 } });
+    }
+    return batch;
+}
+
+// One database with a 100k-line ledger and 20k receipts, made once (through
+// DatabaseManager, Operational) and read by every profileReport case
+QString reportDatabase() {
+    static QTemporaryDir dir;
+    static QString path;
+    if (!path.isEmpty()) return path;
+
+    DatabaseManager &dm = DatabaseManager::instance();
+    if (!dm.connect(dir.filePath("report.db"))) return QString();
+    for (int done = 0; done < REPORT_LINES; done += LEDGER_BATCH) dm.addManualLedgerEntries(ledgerBatch(LEDGER_BATCH));
+    for (int i = 0; i < REPORT_RECEIPTS; ++i) {
+        dm.registerReceipt({ { "batch_number", QString("B-%1").arg(i) }, { "to_mba", "XA01" }, { "from_mba", "XB02" },
+                             { "kmp", "A" }, { "building", "1" }, { "room", "101" }, { "physical_form", "Plate" },
+                             { "chemical_form", "U3O8" }, { "element", "Enriched Uranium" }, { "weight_u", 1250.375 },
+                             { "weight_u235", 49.012 }, { "unit", "g" }, { "manufacturer", "Bench" },
+                             { "count", 1 }, { "date", "2026-03-14" } });
+    }
+    // Fold the WAL into the file, so the read-only case reads the same pages
+    QSqlQuery("PRAGMA wal_checkpoint(TRUNCATE)");
+    path = dir.filePath("report.db");
+    return path;
+}
+
+const QMap<QString, QString> GL_HEADER = { { "facility", "Bench Facility" }, { "mba", "XA01" },
+                                           { "desc", "LEU fuel" }, { "elemCode", "E" },
+                                           { "isoCode", "G" }, { "unit", "g" } };
+}
+
+// =========================================================
+// ROW SIGNATURES
+// =========================================================
+
+QMap<QString, QVariant> AIRBench::ledgerRow() {
+    return { { "date", "2026-03-14" }, { "ref", "RCPT-000418" }, { "code", "RD" }, { "type", "RECEIPT" },
+             { "u_weight", qint64(1250375) }, { "u235_weight", qint64(49012) }, { "items", 12 } };
+}
+
+void AIRBench::codecText() {
+    // Before: "a|b|%.4f|..." built with chained QString::arg, chained as text
+    const QMap<QString, QVariant> row = ledgerRow();
+    QString prev;
+    QBENCHMARK {
+        prev = RowSignature::textChain(prev, RowSignature::textCanonical(RowSignature::Ledger, row));
+    }
+    QCOMPARE(prev.size(), 64);
+}
+
+void AIRBench::codecBinary() {
+    // After: typed fields encoded into the Hasher's reused buffer
+    const QMap<QString, QVariant> row = ledgerRow();
+    RowSignature::Hasher hasher(RowSignature::Ledger);
+    QByteArray prev;
+    QBENCHMARK {
+        prev = hasher.sign(prev, row);
+    }
+    QCOMPARE(prev.size(), 64);
+}
+
+// =========================================================
+// PDF REPORTS
+// =========================================================
+
+void AIRBench::pdfHtmlDocument() {
+    // Before: the whole report as HTML, parsed into a QTextDocument, printed
+    QTemporaryDir dir;
+    resetPeakMemory();
+    QBENCHMARK_ONCE {
+        LedgerRows data(PDF_ROWS);
+        QString html = "<html><body><h2>General Ledger</h2><table><tbody>";
+        int line = 1;
+        while (data.next()) appendGlHtmlRow(html, data, line++);
+        html += "</tbody></table></body></html>";
+
+        QTextDocument document;
+        document.setHtml(html);
+        QPrinter printer(QPrinter::PrinterResolution);
+        printer.setOutputFormat(QPrinter::PdfFormat);
+        printer.setPageSize(QPageSize::A4);
+        printer.setPageOrientation(QPageLayout::Landscape);
+        printer.setOutputFileName(dir.filePath("gl.pdf"));
+        document.print(&printer);
+    }
+    qInfo("%d lines, peak memory %lld KiB", PDF_ROWS, peakMemoryKb());
+    QVERIFY(QFileInfo(dir.filePath("gl.pdf")).size() > 0);
+}
+
+void AIRBench::pdfStreaming() {
+    // After: PdfReportWriter, one page held at a time
+    QTemporaryDir dir;
+    resetPeakMemory();
+    bool ok = false;
+    QBENCHMARK_ONCE {
+        LedgerRows data(PDF_ROWS);
+        ok = ReportGenerator::generateGL_PDF(dir.filePath("gl.pdf"), GL_HEADER, data);
+    }
+    qInfo("%d lines, peak memory %lld KiB", PDF_ROWS, peakMemoryKb());
+    QVERIFY(ok);
+}
+
+// =========================================================
+// REPORT ROWS
+// =========================================================
+
+void AIRBench::rowsHtml() {
+    // Before: concatenated into the report's HTML, as generateGL_HTML did
+    qsizetype chars = 0;
+    QBENCHMARK {
+        LedgerRows data(ROW_BATCH);
+        QString html;
+        int line = 1;
+        while (data.next()) appendGlHtmlRow(html, data, line++);
+        chars += html.size();
+    }
+    QVERIFY(chars > 0);
+}
+
+void AIRBench::rowsTemplate() {
+    // After: the General Ledger's RowTemplate, formatted in place into one Row
+    static const RowTemplate layout({ "{count}", "{text}", "{text}", "{text}", "{count}",
+                                      "{mass}", "{mass}", "{mass}", "{mass}",
+                                      "{mass}", "{mass}", "{mass}", "{mass}",
+                                      "{mass}", "{mass}", "{count}" });
+    qsizetype chars = 0;
+    QBENCHMARK {
+        LedgerRows data(ROW_BATCH);
+        RowTemplate::Row row = layout.row();
+        int line = 1;
+        while (data.next()) {
+            const LedgerBalanceEngine::Type type = LedgerBalanceEngine::typeOf(data.text(4));
+            const qint64 items = data.count(7);
+            row.setCount(0, line++);
+            row.setText(1, data.text(1));
+            row.setText(2, data.text(2));
+            row.setText(3, data.text(3));
+            if (LedgerBalanceEngine::movesItems(type) && items > 0) row.setCount(4, items);
+            else row.clear(4);
+            int pair = -1;
+            switch (LedgerBalanceEngine::columnOf(type)) {
+            case LedgerBalanceEngine::Receipts:       pair = 5;  break;
+            case LedgerBalanceEngine::OtherIncreases: pair = 7;  break;
+            case LedgerBalanceEngine::Shipments:      pair = 9;  break;
+            case LedgerBalanceEngine::OtherDecreases: pair = 11; break;
+            case LedgerBalanceEngine::NoColumn:                  break;
+            }
+            for (int c = 5; c <= 12; ++c) {
+                if (c == pair) row.setMass(c, data.mass(5));
+                else if (c == pair + 1) row.setMass(c, data.mass(6));
+                else row.clear(c);
+            }
+            row.setMass(13, data.mass(8));
+            row.setMass(14, data.mass(9));
+            row.setCount(15, data.count(10));
+            chars += row.cells().at(13).size();
+        }
+    }
+    QVERIFY(chars > 0);
+}
+
+// =========================================================
+// SPREADSHEET EXPORT
+// =========================================================
+
+static void exportTable(const QString &name) {
+    QTemporaryDir dir;
+    const QString file = dir.filePath(name);
+    resetPeakMemory();
+    bool ok = false;
+    QBENCHMARK_ONCE {
+        LedgerRows data(TABLE_ROWS);
+        ok = ReportGenerator::generateGL_Table(file, data);
+    }
+    qInfo("%d lines, %lld bytes, peak memory %lld KiB", TABLE_ROWS, QFileInfo(file).size(), peakMemoryKb());
+    QVERIFY(ok);
+}
+
+void AIRBench::tableCsv() {
+    exportTable("gl.csv");
+}
+
+void AIRBench::tableSpreadsheetML() {
+    exportTable("gl.xml");
+}
+
+// =========================================================
+// STORAGE PROFILES
+// =========================================================
+
+void AIRBench::profileInsert_data() {
+    QTest::addColumn<int>("role");
+    QTest::newRow("Operational") << int(StorageProfile::Operational);
+    QTest::newRow("Training") << int(StorageProfile::Training);
+}
+
+void AIRBench::profileInsert() {
+    // One addManualLedgerEntries batch: one transaction, a balance update,
+    // a signature and a Merkle leaf per line
+    QFETCH(int, role);
+    QTemporaryDir dir;
+    QVERIFY(DatabaseManager::instance().connect(dir.filePath("insert.db"), StorageProfile::Role(role)));
+    const QList<QMap<QString, QVariant>> batch = ledgerBatch(LEDGER_BATCH);
+    int written = 0;
+    QBENCHMARK {
+        for (const RowResult &r : DatabaseManager::instance().addManualLedgerEntries(batch)) written += r.ok;
+    }
+    QVERIFY(written >= LEDGER_BATCH);
+}
+
+void AIRBench::profileReport_data() {
+    QTest::addColumn<int>("role");
+    QTest::newRow("Operational") << int(StorageProfile::Operational);
+    QTest::newRow("Training") << int(StorageProfile::Training);
+    QTest::newRow("ReadOnlyArchive") << int(StorageProfile::ReadOnlyArchive);
+}
+
+void AIRBench::profileReport() {
+    // Every row of the General Ledger and the ICR, read as the reports read
+    // them, on a connection of its own opened under the profile
+    QFETCH(int, role);
+    const QString path = reportDatabase();
+    QVERIFY(!path.isEmpty());
+
+    const QString name = "AIR_bench_profile";
+    qint64 rows = 0;
+    {
+        QSqlDatabase conn = QSqlDatabase::addDatabase("QSQLITE", name);
+        conn.setDatabaseName(path);
+        conn.setConnectOptions(StorageProfile::connectOptions(StorageProfile::Role(role)));
+        QVERIFY(conn.open());
+        QVERIFY(StorageProfile::apply(conn, StorageProfile::Role(role)));
+        qInfo("%s", qPrintable(StorageProfile::describe(conn).join(", ")));
+
+        QBENCHMARK {
+            rows = 0;
+            qint64 total = 0;
+            QSqlQuery gl = DatabaseManager::instance().getManualLedgerEntries(conn);
+            while (gl.next()) { total += gl.value("bal_u").toLongLong(); ++rows; }
+            QSqlQuery icr = DatabaseManager::instance().getICRData("XA01", "2000-01-01", "2099-12-31", conn);
+            while (icr.next()) { total += icr.value("increase_u").toLongLong(); ++rows; }
+            QVERIFY(total != 0);
+        }
+        conn.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+    QCOMPARE(rows, qint64(REPORT_LINES + REPORT_RECEIPTS));
+}
+
+QTEST_MAIN(AIRBench)
+#include "AIRBench.moc"
@@ -0,0 +1,62 @@
+# Microbenchmarks for AIR's hot paths (QTest QBENCHMARK), built apart from
+# the application:
+#
+#   cd bench && qmake && make && ../bin/AIRBench
+#
+# (QT_QPA_PLATFORM=offscreen where there is no display.) Row cases time one
+# row (signed, rendered, ...), report cases a whole report, with its peak
+# memory on Linux, profile cases a temp database under each StorageProfile.
+# QTest's own options apply, e.g. `AIRBench -tickcounter`
+# or `AIRBench rowsHtml rowsTemplate` for just those cases.
+TEMPLATE = app
+TARGET = AIRBench
+QT += core gui widgets sql printsupport testlib
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../src \
+               ../src/db \
+               ../src/utils
+
+HEADERS += \
+    ../src/db/DatabaseManager.h \
+    ../src/db/StorageProfile.h \
+    ../src/db/AsyncQuery.h \
+    ../src/db/ReportJobQueue.h \
+    ../src/db/ConnectionPool.h \
+    ../src/db/IntegrityVerifier.h \
+    ../src/db/MerkleIndex.h \
+    ../src/db/LedgerCache.h \
+    ../src/db/RowSignature.h \
+    ../src/db/Mass.h \
+    ../src/db/LedgerBalanceEngine.h \
+    ../src/utils/ReportGenerator.h \
+    ../src/utils/PdfReportWriter.h \
+    ../src/utils/RowSource.h \
+    ../src/utils/RowTemplate.h \
+    ../src/utils/TableWriter.h \
+
+SOURCES += \
+    AIRBench.cpp \
+    ../src/db/DatabaseManager.cpp \
+    ../src/db/StorageProfile.cpp \
+    ../src/db/AsyncQuery.cpp \
+    ../src/db/ReportJobQueue.cpp \
+    ../src/db/ConnectionPool.cpp \
+    ../src/db/IntegrityVerifier.cpp \
+    ../src/db/MerkleIndex.cpp \
+    ../src/db/LedgerCache.cpp \
+    ../src/db/RowSignature.cpp \
+    ../src/db/Mass.cpp \
+    ../src/db/LedgerBalanceEngine.cpp \
+    ../src/utils/ReportGenerator.cpp \
+    ../src/utils/PdfReportWriter.cpp \
+    ../src/utils/RowSource.cpp \
+    ../src/utils/RowTemplate.cpp \
+    ../src/utils/TableWriter.cpp \
+
+# Output Setup
+DESTDIR = ../bin
+OBJECTS_DIR = ../build/bench/obj
+MOC_DIR = ../build/bench/moc
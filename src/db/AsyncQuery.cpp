@@ -0,0 +1,121 @@
+#include "AsyncQuery.h"
+#include "ConnectionPool.h"
+#include <QCoreApplication>
+#include <QPointer>
+#include <QSqlRecord>
+#include <QSqlError>
+#include <QDebug>
+
+static AsyncQuery *s_instance = nullptr;
+
+// =========================================================
+// QUERY RESULT
+// =========================================================
+
+QueryResult QueryResult::fromQuery(QSqlQuery &query) {
+    QueryResult r;
+    if (!query.isActive()) {
+        r.error = query.lastError().text();
+        return r;
+    }
+    const QSqlRecord rec = query.record();
+    for (int i = 0; i < rec.count(); ++i) r.columns << rec.fieldName(i);
+
+    while (query.next()) {
+        QVariantList row;
+        row.reserve(r.columns.size());
+        for (int i = 0; i < r.columns.size(); ++i) row << query.value(i);
+        r.rows << row;
+    }
+    return r;
+}
+
+QVariant QueryResult::value(int column) const {
+    if (cursor < 0 || cursor >= rows.size() || column < 0) return QVariant();
+    return rows.at(cursor).value(column);
+}
+
+QVariant QueryResult::valueAt(int row, const QString &column) const {
+    if (row < 0 || row >= rows.size()) return QVariant();
+    return rows.at(row).value(columns.indexOf(column));
+}
+
+// =========================================================
+// SERVICE
+// =========================================================
+
+AsyncQuery &AsyncQuery::instance() {
+    // Parented to the application so the thread is joined before QCoreApplication goes away
+    if (!s_instance) s_instance = new AsyncQuery(QCoreApplication::instance());
+    return *s_instance;
+}
+
+AsyncQuery::AsyncQuery(QObject *parent) : QObject(parent), worker(new QObject) {
+    thread.setObjectName("AIR async reader");
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    thread.start();
+}
+
+AsyncQuery::~AsyncQuery() {
+    releaseConnection();
+    thread.quit();
+    thread.wait();
+    s_instance = nullptr;
+}
+
+QString AsyncQuery::key(QObject *receiver, const QString &tag) {
+    return QString::number(quintptr(receiver), 16) + "/" + tag;
+}
+
+bool AsyncQuery::isCurrent(const QString &k, quint64 ticket) {
+    QMutexLocker lock(&mutex);
+    return latest.value(k) == ticket;
+}
+
+void AsyncQuery::submit(QObject *receiver, const QString &tag, Reader read, Handler done) {
+    const QString k = key(receiver, tag);
+    const QPointer<QObject> target(receiver); // the receiver may be gone by the time the rows are
+    quint64 ticket;
+    {
+        QMutexLocker lock(&mutex);
+        ticket = ++nextTicket;
+        latest[k] = ticket;
+    }
+
+    QMetaObject::invokeMethod(worker, [=]() {
+        if (!isCurrent(k, ticket)) return; // superseded before it started
+
+        QSqlDatabase conn = ConnectionPool::instance().reader();
+        QueryResult result;
+        if (!conn.isOpen()) {
+            qWarning() << "AsyncQuery: cannot open reader connection:" << conn.lastError().text();
+        } else {
+            QSqlQuery q = read(conn);
+            result = QueryResult::fromQuery(q);
+        }
+
+        // Delivered through this object, which outlives every receiver, and
+        // dropped if the receiver was destroyed in the meantime
+        QMetaObject::invokeMethod(this, [=]() {
+            {
+                QMutexLocker lock(&mutex);
+                if (latest.value(k) != ticket) return; // superseded while running
+                latest.remove(k);
+            }
+            if (target) done(result);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void AsyncQuery::cancel(QObject *receiver, const QString &tag) {
+    QMutexLocker lock(&mutex);
+    latest.remove(key(receiver, tag));
+}
+
+void AsyncQuery::releaseConnection() {
+    if (!s_instance || !s_instance->thread.isRunning()) return;
+    QMetaObject::invokeMethod(s_instance->worker, []() {
+        ConnectionPool::instance().releaseThread();
+    }, Qt::BlockingQueuedConnection);
+}
@@ -0,0 +1,77 @@
+#ifndef ASYNCQUERY_H
+#define ASYNCQUERY_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QVariant>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <functional>
+
+// Detached copy of a result set. Unlike QSqlQuery it is not tied to a
+// connection, so it can be built on the worker thread and read on the GUI
+// thread. The cursor API mirrors QSqlQuery (next()/value()) so view code
+// reads the same either way.
+class QueryResult {
+public:
+    static QueryResult fromQuery(QSqlQuery &query);
+
+    bool next() { return ++cursor < rows.size(); }
+    QVariant value(int column) const;
+    QVariant value(const QString &column) const { return value(columns.indexOf(column)); }
+    QVariant valueAt(int row, const QString &column) const; // random access, ignores the cursor
+    QStringList columnNames() const { return columns; }
+    int size() const { return rows.size(); }
+    bool isOk() const { return error.isEmpty(); }
+    QString lastError() const { return error; }
+
+private:
+    QStringList columns;
+    QList<QVariantList> rows;
+    QString error;
+    int cursor = -1;
+};
+
+// Runs read queries on a background thread, using that thread's pooled
+// reader connection (see ConnectionPool).
+// Each request is identified by (receiver, tag); submitting again under the
+// same pair supersedes the older request, which is skipped if it has not
+// started yet and its result is dropped if it has.
+class AsyncQuery : public QObject {
+    Q_OBJECT
+
+public:
+    using Reader = std::function<QSqlQuery(const QSqlDatabase &)>;
+    using Handler = std::function<void(QueryResult)>;
+
+    static AsyncQuery &instance();
+    ~AsyncQuery();
+
+    // `read` runs on the worker; `done` runs on the GUI thread (this
+    // object's), where receivers live, and not at all once receiver is gone.
+    void submit(QObject *receiver, const QString &tag, Reader read, Handler done);
+    void cancel(QObject *receiver, const QString &tag);
+
+    // Closes the worker's pooled connections (blocking) so the main file can
+    // be closed, replaced or deleted. They reopen on the next request.
+    static void releaseConnection();
+
+private:
+    explicit AsyncQuery(QObject *parent);
+
+    static QString key(QObject *receiver, const QString &tag);
+    bool isCurrent(const QString &key, quint64 ticket);
+
+    QThread thread;
+    QObject *worker;          // lives in `thread`; queued lambdas run in its context
+
+    QMutex mutex;
+    QHash<QString, quint64> latest; // key -> newest ticket
+    quint64 nextTicket = 0;
+};
+
+#endif // ASYNCQUERY_H
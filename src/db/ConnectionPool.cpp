@@ -0,0 +1,168 @@
+#include "ConnectionPool.h"
+#include <QObject>
+#include <QSqlError>
+#include <QDebug>
+
+ConnectionPool &ConnectionPool::instance() {
+    static ConnectionPool pool;
+    return pool;
+}
+
+// =========================================================
+// TARGET
+// =========================================================
+
+void ConnectionPool::setTarget(const QSqlDatabase &main, StorageProfile::Role r) {
+    QMutexLocker lock(&mutex);
+    mainThread = QThread::currentThread();
+    mainConnection = main.connectionName();
+    path = main.databaseName();
+    options = StorageProfile::connectOptions(r);
+    role = r;
+    ++targetGeneration;
+}
+
+void ConnectionPool::invalidate() {
+    Slot *own;
+    {
+        QMutexLocker lock(&mutex);
+        ++targetGeneration;
+        own = threadSlots.value(QThread::currentThread(), nullptr);
+    }
+    // Other threads notice the new generation on their next call
+    if (own) closeSlot(own);
+}
+
+void ConnectionPool::releaseThread() {
+    Slot *own;
+    {
+        QMutexLocker lock(&mutex);
+        own = threadSlots.value(QThread::currentThread(), nullptr);
+    }
+    if (own) closeSlot(own);
+}
+
+quint64 ConnectionPool::generation() const {
+    QMutexLocker lock(&mutex);
+    return targetGeneration;
+}
+
+// =========================================================
+// PER-THREAD SLOTS
+// =========================================================
+
+ConnectionPool::Slot *ConnectionPool::slotForCurrentThread() {
+    QThread *t = QThread::currentThread();
+    QMutexLocker lock(&mutex);
+    Slot *slot = threadSlots.value(t, nullptr);
+    if (!slot) {
+        slot = new Slot;
+        slot->context = new QObject; // affinity: t
+        QObject::connect(t, &QThread::finished, slot->context, [this, t]() { dropThread(t); },
+                         Qt::DirectConnection);
+        threadSlots.insert(t, slot);
+    }
+    const bool stale = slot->generation != targetGeneration;
+    lock.unlock();
+
+    if (stale) {
+        closeSlot(slot);
+        openSlot(slot);
+    }
+    return slot;
+}
+
+void ConnectionPool::openSlot(Slot *slot) {
+    QString p, opts, mainName;
+    StorageProfile::Role r;
+    quint64 gen;
+    bool isMain;
+    {
+        QMutexLocker lock(&mutex);
+        p = path; opts = options; mainName = mainConnection; r = role;
+        gen = targetGeneration;
+        isMain = QThread::currentThread() == mainThread;
+    }
+
+    slot->generation = gen;
+    slot->ownsConnections = !isMain;
+    if (isMain) {
+        // The GUI thread reads and writes through DatabaseManager's connection
+        slot->writerName = slot->readerName = mainName;
+        return;
+    }
+
+    const QString tag = QString::number(quintptr(QThread::currentThread()), 16);
+    slot->writerName = "AIR_writer_" + tag;
+    slot->readerName = "AIR_reader_" + tag;
+
+    for (const QString &name : {slot->writerName, slot->readerName}) {
+        QSqlDatabase conn = QSqlDatabase::addDatabase("QSQLITE", name);
+        conn.setDatabaseName(p);
+        conn.setConnectOptions(opts);
+        if (!conn.open()) {
+            qWarning() << "ConnectionPool: cannot open" << name << ":" << conn.lastError().text();
+            continue;
+        }
+        StorageProfile::apply(conn, r);
+    }
+    QSqlQuery(QSqlDatabase::database(slot->readerName, false)).exec("PRAGMA query_only = 1");
+}
+
+void ConnectionPool::closeSlot(Slot *slot) {
+    // Prepared handles must go before their connection
+    qDeleteAll(slot->statements);
+    slot->statements.clear();
+    slot->generation = 0;
+
+    if (!slot->ownsConnections) return;
+    for (const QString &name : {slot->writerName, slot->readerName}) {
+        if (name.isEmpty() || !QSqlDatabase::contains(name)) continue;
+        {
+            QSqlDatabase conn = QSqlDatabase::database(name, false);
+            conn.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+void ConnectionPool::dropThread(QThread *thread) {
+    // Runs on `thread` itself as it finishes
+    Slot *slot;
+    {
+        QMutexLocker lock(&mutex);
+        slot = threadSlots.take(thread);
+    }
+    if (!slot) return;
+    closeSlot(slot);
+    delete slot->context;
+    delete slot;
+}
+
+// =========================================================
+// CONNECTIONS & STATEMENTS
+// =========================================================
+
+QSqlDatabase ConnectionPool::writer() {
+    return QSqlDatabase::database(slotForCurrentThread()->writerName, false);
+}
+
+QSqlDatabase ConnectionPool::reader() {
+    return QSqlDatabase::database(slotForCurrentThread()->readerName, false);
+}
+
+QSqlQuery &ConnectionPool::cachedQuery(const QString &sql) {
+    Slot *slot = slotForCurrentThread();
+    QSqlQuery *query = slot->statements.value(sql, nullptr);
+    if (!query) {
+        query = new QSqlQuery(QSqlDatabase::database(slot->writerName, false));
+        if (!query->prepare(sql)) {
+            qWarning() << "Prepare failed:" << query->lastError().text() << sql;
+        }
+        slot->statements.insert(sql, query);
+    } else {
+        // Drop the previous result set so the handle can be re-bound
+        query->finish();
+    }
+    return *query;
+}
@@ -0,0 +1,74 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QHash>
+#include <QMutex>
+#include <QRecursiveMutex>
+#include <QString>
+#include <QThread>
+#include "StorageProfile.h"
+
+// Thread-aware connections to the active database.
+//
+// A QSqlDatabase may only be used on the thread that opened it, so every
+// thread gets its own pair: a writer (with its own prepared-statement cache)
+// and a query_only reader. The GUI thread's pair is DatabaseManager's main
+// connection. Writes from all threads are serialised through writeLock(),
+// so only one writer is active at a time.
+//
+// DatabaseManager calls setTarget() whenever the main connection is
+// (re)opened and invalidate() before it is closed; pooled connections on
+// other threads then reopen against the new file on their next use.
+// Long-lived workers that must let go of the file immediately (AsyncQuery)
+// call releaseThread() on their own thread.
+class ConnectionPool {
+public:
+    static ConnectionPool &instance();
+
+    void setTarget(const QSqlDatabase &main, StorageProfile::Role role);
+    void invalidate();
+    void releaseThread();
+    quint64 generation() const;
+
+    QSqlDatabase writer();
+    QSqlDatabase reader();
+
+    // Prepared statement on the calling thread's writer, keyed by SQL text.
+    // The reference stays valid until the connection is invalidated.
+    QSqlQuery &cachedQuery(const QString &sql);
+
+    // Held for the duration of every write or write transaction
+    QRecursiveMutex &writeLock() { return writeMutex; }
+
+private:
+    ConnectionPool() {} // Singleton
+
+    struct Slot {
+        QString writerName;
+        QString readerName;
+        quint64 generation = 0;     // target generation the connections were opened for
+        bool ownsConnections = true; // false for the GUI thread (main connection)
+        QHash<QString, QSqlQuery*> statements;
+        QObject *context = nullptr; // lives on the slot's thread
+    };
+
+    Slot *slotForCurrentThread();
+    void openSlot(Slot *slot);
+    void closeSlot(Slot *slot);
+    void dropThread(QThread *thread);
+
+    mutable QMutex mutex;          // guards the fields below
+    QHash<QThread*, Slot*> threadSlots;
+    QThread *mainThread = nullptr;
+    QString mainConnection;
+    QString path;
+    QString options;
+    StorageProfile::Role role = StorageProfile::Operational;
+    quint64 targetGeneration = 1;
+
+    QRecursiveMutex writeMutex;
+};
+
+#endif // CONNECTIONPOOL_H
@@ -1,36 +1,212 @@
 #include "DatabaseManager.h"
+#include "AsyncQuery.h"
+#include "ReportJobQueue.h"
+#include "IntegrityVerifier.h"
+#include "ConnectionPool.h"
+#include "MerkleIndex.h"
+#include "LedgerCache.h"
+#include "Mass.h"
+#include <QJsonDocument>
+#include <QDate>
 #include <QDateTime>
 #include <QCoreApplication>
 #include <QDir>
 #include <QStandardPaths>
 #include <QFile>
-#include <QCryptographicHash> // <--- REQUIRED FOR TAMPER-EVIDENT HASHING
+#include <QSaveFile>
 #include <QDebug>
 #include <QSqlError>
+#include <QSqlRecord>
+#include <QVector>
+#include <limits>
 
+// =========================================================
+// QUERY TEXT (shared by the accessors and the plan audit)
+// =========================================================
+
+static const char *SQL_ICR_DATA =
+    "SELECT h.record_date, h.change_type, h.items_count, b.batch_number, "
+    "b.physical_form, b.element, h.increase_u, h.decrease_u, h.description "
+    "FROM history h "
+    "JOIN batches b ON h.batch_id = b.id "
+    "WHERE b.mba = :mba "
+    "AND h.record_date >= :start AND h.record_date <= :end "
+    "ORDER BY h.id ASC";
+
+// Listed unpaged (getReceipts) or through a keyset window (receiptsKeysetSql)
+static const char *SQL_RECEIPTS_SELECT =
+    "SELECT h.id, h.batch_id, h.record_date, h.change_type, b.batch_number, h.items_count, "
+    "b.element, h.increase_u, b.weight_u235 "
+    "FROM history h JOIN batches b ON h.batch_id = b.id ";
+static const QString SQL_RECEIPTS_BASE = QString(SQL_RECEIPTS_SELECT) + "WHERE h.change_type IN ('RD', 'RF', 'RN') ";
+static const char *RECEIPT_CODES[] = { "RD", "RF", "RN" };
+// Every receipt: history walked in id order, the code a filter on each row
+// (the unary + keeps the planner off the change_type index and its sort)
+static const QString SQL_RECEIPTS_ALL = QString(SQL_RECEIPTS_SELECT)
+    + "WHERE +h.change_type IN ('RD', 'RF', 'RN') ORDER BY h.id ASC";
+
+// A receipt line as getReceiptsPage lists it, read back after registerReceipt
+static const QString SQL_RECEIPT_WRITTEN = SQL_RECEIPTS_BASE + "AND h.id = ?";
+
+static const char *SQL_LII_DATA =
+    "SELECT kmp, building, room, batch_number, physical_form, chemical_form, "
+    "weight_u, weight_u235, weight_pu, weight_th "
+    "FROM batches "
+    "WHERE mba = ? AND status = 'Active' "
+    "ORDER BY kmp, batch_number";
+
+static const char *SQL_GL_DATA =
+    "SELECT h.record_date, b.batch_number, h.change_type, h.element_code, "
+    "h.items_count, h.increase_u, h.decrease_u, "
+    "b.weight_u, b.weight_u235 "
+    "FROM history h "
+    "JOIN batches b ON h.batch_id = b.id "
+    "WHERE b.mba = :mba ";
+
+// Keyset window over a listing. `base` is a SELECT that may already end in a
+// WHERE clause (hasWhere). Binds: 0 = cursor id, 1 = page size. Rows always
+// come back in ascending id order, whichever way the window moves.
+static QString keysetSql(const QString &base, const QString &idCol, bool hasWhere, const PageRequest &page) {
+    const bool back = page.direction == PageRequest::Backward;
+    QString sql = base + (hasWhere ? "AND " : "WHERE ") + idCol + (back ? " < ? " : " > ? ")
+                + "ORDER BY " + idCol + (back ? " DESC" : " ASC") + " LIMIT ?";
+    if (back) sql = "SELECT * FROM (" + sql + ") ORDER BY id ASC";
+    return sql;
+}
+
+// Keyset window over the receipts. Filtering with IN on change_type hands
+// the rows back in code order, so every page sorted all the receipts past
+// the cursor; instead each code takes its own ordered seek on
+// idx_history_change_type, at most one page long, and the page is the
+// first rows of those ids (a sorted IN list: no sort). Same binds as
+// keysetSql, referenced by number.
+static QString receiptsKeysetSql(const PageRequest &page) {
+    const bool back = page.direction == PageRequest::Backward;
+    QStringList arms;
+    for (const char *code : RECEIPT_CODES) {
+        arms << QString("SELECT id FROM (SELECT id FROM history WHERE change_type = '%1' AND id %2 ?1 "
+                        "ORDER BY id %3 LIMIT ?2)").arg(code, back ? "<" : ">", back ? "DESC" : "ASC");
+    }
+    QString sql = SQL_RECEIPTS_BASE + "AND h.id IN (" + arms.join(" UNION ALL ") + ") "
+                + "ORDER BY h.id" + (back ? " DESC" : " ASC") + " LIMIT ?2";
+    if (back) sql = "SELECT * FROM (" + sql + ") ORDER BY id ASC";
+    return sql;
+}
+
+// Secondary indexes owned by initTables(). Every query issued by this class
+// must be answerable through one of these (or the rowid) - see auditQueryPlans().
+struct ManagedIndex {
+    const char *name;
+    const char *ddl;
+};
+
+static const ManagedIndex MANAGED_INDEXES[] = {
+    // ICR / GL: join from the MBA's batches into their history, date-bounded
+    { "idx_history_batch_date",
+      "CREATE INDEX IF NOT EXISTS idx_history_batch_date ON history(batch_id, record_date)" },
+    // Receipt listing: one seek per receipt code, in id order (receiptsKeysetSql)
+    { "idx_history_change_type",
+      "CREATE INDEX IF NOT EXISTS idx_history_change_type ON history(change_type, id)" },
+    { "idx_batches_mba_status",
+      "CREATE INDEX IF NOT EXISTS idx_batches_mba_status ON batches(mba, status)" },
+    // LII: only active batches are listed, sorted by KMP then batch number
+    { "idx_batches_active",
+      "CREATE INDEX IF NOT EXISTS idx_batches_active ON batches(mba, kmp, batch_number) "
+      "WHERE status = 'Active'" },
+    // GL element filter uses LIKE 'Prefix%', which needs a NOCASE index
+    { "idx_batches_mba_element",
+      "CREATE INDEX IF NOT EXISTS idx_batches_mba_element ON batches(mba, element COLLATE NOCASE)" },
+    { "idx_backups_created",
+      "CREATE INDEX IF NOT EXISTS idx_backups_created ON backups(created_date)" },
+    // Merkle leaf lookup by row (proofs, rebuild after delete)
+    { "idx_merkle_leaf_row",
+      "CREATE INDEX IF NOT EXISTS idx_merkle_leaf_row ON merkle_nodes(table_name, row_id)" },
+    // balanceAsOf: last ledger line dated on or before a date
+    { "idx_manual_ledger_date",
+      "CREATE INDEX IF NOT EXISTS idx_manual_ledger_date ON manual_ledger(date, id)" },
+};
+
+// Scheduled full re-verification of a signature chain
+static const int FULL_CHECK_INTERVAL_SECS = 24 * 60 * 60;
+
+// Column name -> value for the current row of `q`
+static QMap<QString, QVariant> recordMap(const QSqlQuery &q) {
+    QMap<QString, QVariant> row;
+    const QSqlRecord rec = q.record();
+    for (int i = 0; i < rec.count(); ++i) row.insert(rec.fieldName(i), rec.value(i));
+    return row;
+}
+
+// A checkpoint is written every this many ledger lines; it bounds the replay
+// in balanceAsOf() to at most one interval.
+static const int LEDGER_CHECKPOINT_INTERVAL = 500;
+
+static const char *SQL_LEDGER_LAST_ON =
+    "SELECT id FROM manual_ledger WHERE date <= ? ORDER BY date DESC, id DESC LIMIT 1";
+
+static const char *SQL_LEDGER_CHECKPOINT_AT =
+    "SELECT ledger_id, bal_u, bal_u235, bal_items FROM ledger_checkpoints "
+    "WHERE ledger_id <= ? ORDER BY ledger_id DESC LIMIT 1";
+
+static const char *SQL_LEDGER_REPLAY =
+    "SELECT id, date, type, u_weight, u235_weight, items FROM manual_ledger "
+    "WHERE id > ? ORDER BY id ASC";
+
+static const char *SQL_LEDGER_REPLAY_TO =
+    "SELECT id, type, u_weight, u235_weight, items FROM manual_ledger "
+    "WHERE id > ? AND id <= ? ORDER BY id ASC";
+
+// Ledger dates are stored as ISO text (yyyy-MM-dd), so they sort and compare
+// as dates. Older lines and imports may carry yyMMdd. Empty if neither.
+static QString ledgerDate(const QString &text) {
+    QDate d = QDate::fromString(text, Qt::ISODate);
+    if (!d.isValid() && text.size() == 6) d = QDate::fromString("20" + text, "yyyyMMdd");
+    return d.isValid() ? d.toString(Qt::ISODate) : QString();
+}
+
+// Everything LedgerCache keeps, from a given line on (column order matters)
+static const char *SQL_LEDGER_FROM =
+    "SELECT id, date, ref, code, type, u_weight, u235_weight, items, bal_u, bal_u235, bal_items "
+    "FROM manual_ledger WHERE id >= ? ORDER BY id ASC";
 
 DatabaseManager& DatabaseManager::instance() {
     static DatabaseManager _instance;
     return _instance;
 }
 
-bool DatabaseManager::connect() {
+bool DatabaseManager::connect(const QString &path, StorageProfile::Role role) {
+    beginConnectionChange();
     db = QSqlDatabase::addDatabase("QSQLITE");
     
     // --- THE MAC FIX: Save inventory DB to the Documents folder ---
     QString dbPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/air_inventory.db";
+    if (!path.isEmpty()) dbPath = path;
     db.setDatabaseName(dbPath);
     // --------------------------------------------------------------
+    db.setConnectOptions(StorageProfile::connectOptions(role));
     
     if (!db.open()) {
         qCritical() << "DB Connection Error:" << db.lastError().text();
         return false;
     }
+    activeProfile = role;
+    StorageProfile::apply(db, activeProfile);
+    ConnectionPool::instance().setTarget(db, activeProfile);
     initTables();
+
+#ifdef QT_DEBUG
+    // Debug builds refuse to stay silent about a query that lost its index;
+    // the gate that fails is `AIR --audit-query-plans` (main.cpp)
+    QStringList findings;
+    if (!auditQueryPlans(&findings)) {
+        for (const QString &f : findings) qCritical().noquote() << "Query plan regression:" << f;
+    }
+#endif
     return true;
 }
 
 void DatabaseManager::initTables() {
+    // Original (version 0) layout; migrateSchema() brings it up to date
     QSqlQuery query;
     // 1. Batches Table
     query.exec("CREATE TABLE IF NOT EXISTS batches ("
@@ -80,23 +256,592 @@ void DatabaseManager::initTables() {
                "continuation TEXT, entry_name TEXT, element TEXT, "
                "weight REAL, unit TEXT, fissile REAL, "
                "isotope TEXT, report_no TEXT, signature TEXT)"); // <--- NEW COLUMN
-               
+
+    // 10. Later schema changes (versioned), then secondary indexes
+    migrateSchema();
+    ensureIndexes();
+}
+
+// =========================================================
+// SCHEMA MIGRATIONS
+// =========================================================
+
+// Schema changes made after the original CREATE TABLEs. PRAGMA user_version
+// records the last step applied, so each step runs once per database file,
+// inside its own transaction.
+void DatabaseManager::migrateSchema() {
+    struct Step {
+        int version;
+        bool (DatabaseManager::*apply)();
+        const char *what;
+    };
+    static const Step STEPS[] = {
+        { 1, &DatabaseManager::migrateLedgerBalances, "materialized ledger balances" },
+        { 2, &DatabaseManager::migrateSignatureChains, "chained row signatures" },
+        { 3, &DatabaseManager::migrateMerkleIndex, "Merkle integrity index" },
+        { 4, &DatabaseManager::migrateBinaryRowCodec, "binary row signatures" },
+        { 5, &DatabaseManager::migrateReportTableSignatures, "batch, history, LII and NLI signatures" },
+        { 6, &DatabaseManager::migrateFixedPointMass, "weights stored as whole milligrams" },
+        { 7, &DatabaseManager::migrateLedgerIsoDates, "ledger dates stored as yyyy-MM-dd" },
+    };
+
+    QSqlQuery q(db);
+    q.exec("PRAGMA user_version");
+    int version = q.next() ? q.value(0).toInt() : 0;
+
+    for (const Step &step : STEPS) {
+        if (version >= step.version) continue;
+        db.transaction();
+        bool ok = (this->*step.apply)()
+               && QSqlQuery(db).exec(QString("PRAGMA user_version = %1").arg(step.version))
+               && db.commit();
+        if (!ok) {
+            qCritical() << "Schema migration" << step.version << "(" << step.what << ") failed:"
+                        << db.lastError().text();
+            db.rollback();
+            return;
+        }
+        version = step.version;
+        qDebug() << "Schema migrated to version" << version << "-" << step.what;
+    }
+}
+
+// v1: running balance stored on every ledger line, plus periodic checkpoints
+bool DatabaseManager::migrateLedgerBalances() {
+    QSqlQuery q(db);
+    if (!q.exec("ALTER TABLE manual_ledger ADD COLUMN bal_u REAL")) return false;
+    if (!q.exec("ALTER TABLE manual_ledger ADD COLUMN bal_u235 REAL")) return false;
+    if (!q.exec("ALTER TABLE manual_ledger ADD COLUMN bal_items INTEGER")) return false;
+    if (!q.exec("CREATE TABLE IF NOT EXISTS ledger_checkpoints ("
+                "ledger_id INTEGER PRIMARY KEY, date TEXT, "
+                "bal_u REAL, bal_u235 REAL, bal_items INTEGER)")) return false;
+    return updateLedgerBalancesFrom(0);
+}
+
+// v2: per-row signatures become a hash chain. Rows whose old signature does
+// not match (forged or edited) keep it, so they still show as tampered.
+bool DatabaseManager::migrateSignatureChains() {
+    QSqlQuery q(db);
+    if (!q.exec("CREATE TABLE IF NOT EXISTS integrity_state ("
+                "table_name TEXT PRIMARY KEY, verified_id INTEGER, "
+                "verified_sig TEXT, last_full_check TEXT)")) return false;
+    if (!q.exec("CREATE TABLE IF NOT EXISTS integrity_breaks ("
+                "table_name TEXT, row_id INTEGER, PRIMARY KEY (table_name, row_id))")) return false;
+
+    for (RowSignature::Table table : { RowSignature::Ledger, RowSignature::MBR }) {
+        const QString name = RowSignature::tableName(table);
+        QSqlQuery rows(db);
+        rows.setForwardOnly(true);
+        if (!rows.exec("SELECT * FROM " + name + " ORDER BY id ASC")) return false;
+
+        QSqlQuery upd(db);
+        upd.prepare("UPDATE " + name + " SET signature = ? WHERE id = ?");
+        QString prev;
+        while (rows.next()) {
+            const QString canon = RowSignature::textCanonical(table, recordMap(rows));
+            const QString stored = rows.value("signature").toString();
+            const QString sig = stored == RowSignature::legacy(canon) ? RowSignature::textChain(prev, canon) : stored;
+            if (sig != stored) {
+                upd.bindValue(0, sig);
+                upd.bindValue(1, rows.value("id"));
+                if (!upd.exec()) return false;
+            }
+            prev = sig;
+        }
+    }
+    return true;
+}
+
+// v3: Merkle tree over the signed tables, built from the (chained) signatures
+bool DatabaseManager::migrateMerkleIndex() {
+    QSqlQuery q(db);
+    if (!q.exec("CREATE TABLE IF NOT EXISTS merkle_nodes ("
+                "table_name TEXT, level INTEGER, idx INTEGER, row_id INTEGER, hash BLOB, "
+                "PRIMARY KEY (table_name, level, idx))")) return false;
+    return MerkleIndex::rebuildFrom(db, RowSignature::Ledger, 0)
+        && MerkleIndex::rebuildFrom(db, RowSignature::MBR, 0);
+}
+
+// v4: signatures move from the '|'-joined text form to the binary row codec.
+// Rows that verified under the text chain are re-signed; the rest keep
+// their (invalid) signature. Merkle leaves and watermarks follow.
+bool DatabaseManager::migrateBinaryRowCodec() {
+    for (RowSignature::Table table : { RowSignature::Ledger, RowSignature::MBR }) {
+        const QString name = RowSignature::tableName(table);
+        QSqlQuery rows(db);
+        rows.setForwardOnly(true);
+        if (!rows.exec("SELECT * FROM " + name + " ORDER BY id ASC")) return false;
+
+        QSqlQuery upd(db);
+        upd.prepare("UPDATE " + name + " SET signature = ? WHERE id = ?");
+        RowSignature::Hasher hasher(table, RowSignature::Hasher::DoubleWeights);
+        hasher.bind(rows);
+        QString oldPrev;
+        QByteArray newPrev;
+        while (rows.next()) {
+            const QString stored = rows.value("signature").toString();
+            const bool wasValid = stored == RowSignature::textChain(oldPrev, RowSignature::textCanonical(table, recordMap(rows)));
+            const QByteArray sig = wasValid ? hasher.sign(newPrev, rows) : stored.toLatin1();
+            if (sig != stored.toLatin1()) {
+                upd.bindValue(0, QString::fromLatin1(sig));
+                upd.bindValue(1, rows.value("id"));
+                if (!upd.exec()) return false;
+            }
+            oldPrev = stored;
+            newPrev = sig;
+        }
+        if (!MerkleIndex::rebuildFrom(db, table, 0)) return false;
+    }
+    // Stored watermark signatures are in the old form: next check starts over
+    return QSqlQuery(db).exec("DELETE FROM integrity_state");
+}
+
+// v5: the tables behind the ICR, LII and NLI reports get the same signature
+// chain and Merkle index. Existing rows are trusted as they stand and signed
+// in one pass per table (one prepared UPDATE, inside the step's transaction).
+bool DatabaseManager::migrateReportTableSignatures() {
+    for (RowSignature::Table table : { RowSignature::Batches, RowSignature::History,
+                                       RowSignature::LII, RowSignature::NLI }) {
+        const QString name = RowSignature::tableName(table);
+        QSqlQuery q(db);
+        if (!q.exec("ALTER TABLE " + name + " ADD COLUMN signature TEXT")) return false;
+
+        QSqlQuery rows(db);
+        rows.setForwardOnly(true);
+        if (!rows.exec("SELECT * FROM " + name + " ORDER BY id ASC")) return false;
+
+        QSqlQuery upd(db);
+        upd.prepare("UPDATE " + name + " SET signature = ? WHERE id = ?");
+        RowSignature::Hasher hasher(table, RowSignature::Hasher::DoubleWeights);
+        hasher.bind(rows);
+        QByteArray prev;
+        while (rows.next()) {
+            prev = hasher.sign(prev, rows);
+            upd.bindValue(0, QString::fromLatin1(prev));
+            upd.bindValue(1, rows.value("id"));
+            if (!upd.exec()) return false;
+        }
+        if (!MerkleIndex::rebuildFrom(db, table, 0)) return false;
+    }
+    return true;
+}
+
+// v6 layout of the tables that hold weights: the same columns, weights as
+// INTEGER milligrams instead of REAL grams
+struct MassTable {
+    RowSignature::Table table;
+    const char *columns;   // column definitions, for CREATE TABLE
+    QStringList masses;    // weight columns converted
+};
+
+static const QList<MassTable> &massTables() {
+    static const QList<MassTable> tables = {
+        { RowSignature::Batches,
+          "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+          "batch_number TEXT UNIQUE, mba TEXT, kmp TEXT, building TEXT, room TEXT, "
+          "physical_form TEXT, chemical_form TEXT, element TEXT, isotope TEXT, "
+          "weight_u INTEGER, weight_u235 INTEGER, weight_pu INTEGER, weight_th INTEGER, "
+          "unit TEXT, manufacturer TEXT, insertion_date TEXT, status TEXT, signature TEXT",
+          { "weight_u", "weight_u235", "weight_pu", "weight_th" } },
+        { RowSignature::History,
+          "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+          "batch_id INTEGER, change_type TEXT, element_code TEXT, "
+          "items_count INTEGER, increase_u INTEGER, decrease_u INTEGER, "
+          "record_date TEXT, description TEXT, signature TEXT, "
+          "FOREIGN KEY(batch_id) REFERENCES batches(id)",
+          { "increase_u", "decrease_u" } },
+        { RowSignature::Ledger,
+          "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+          "date TEXT, ref TEXT, code TEXT, type TEXT, "
+          "u_weight INTEGER, u235_weight INTEGER, items INTEGER, signature TEXT, "
+          "bal_u INTEGER, bal_u235 INTEGER, bal_items INTEGER",
+          { "u_weight", "u235_weight" } }, // balances are recomputed
+        { RowSignature::LII,
+          "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+          "kmp TEXT, position TEXT, batch TEXT, desc TEXT, "
+          "weight_elem INTEGER, weight_fissile INTEGER, weight_pu INTEGER, "
+          "burnup REAL, cooling REAL, signature TEXT",
+          { "weight_elem", "weight_fissile", "weight_pu" } },
+        { RowSignature::NLI,
+          "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+          "batch TEXT, items INTEGER, code TEXT, "
+          "u_elem_code TEXT, u_iso_code TEXT, u_weight INTEGER, u_iso_weight INTEGER, "
+          "p_elem_code TEXT, p_weight INTEGER, signature TEXT",
+          { "u_weight", "u_iso_weight", "p_weight" } },
+        { RowSignature::MBR,
+          "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+          "continuation TEXT, entry_name TEXT, element TEXT, "
+          "weight INTEGER, unit TEXT, fissile INTEGER, "
+          "isotope TEXT, report_no TEXT, signature TEXT",
+          { "weight", "fissile" } },
+    };
+    return tables;
+}
+
+// v6: weights move from REAL grams to INTEGER milligrams (see Mass), so
+// sums and balances are exact. SQLite cannot change a column's type in
+// place: each table is rebuilt under its v6 layout and its rows copied
+// across, rounded to the nearest milligram. Signatures move to the
+// fixed-point codec as in v4 - rows that verified before are re-signed,
+// the rest keep their (invalid) signature - and the running balances and
+// checkpoints are recomputed from the converted lines.
+// Ids of the rows of `table` whose signature verifies under `codec`, taken
+// before a migration rewrites their values
+static bool verifiedRows(const QSqlDatabase &db, RowSignature::Table table,
+                         RowSignature::Hasher::Codec codec, QSet<qint64> *valid) {
+    QSqlQuery rows(db);
+    rows.setForwardOnly(true);
+    if (!rows.exec("SELECT * FROM " + RowSignature::tableName(table) + " ORDER BY id ASC")) return false;
+    RowSignature::Hasher hasher(table, codec);
+    hasher.bind(rows);
+    QByteArray prev;
+    while (rows.next()) {
+        const QByteArray stored = rows.value("signature").toString().toLatin1();
+        if (stored == hasher.sign(prev, rows)) valid->insert(rows.value("id").toLongLong());
+        prev = stored;
+    }
+    return true;
+}
+
+// Re-signs the `valid` rows of `table` in the current codec, chained over
+// the rewritten values, and rebuilds its Merkle tree. Rows that were broken
+// keep their signature, so they still show as tampered.
+static bool resignRows(const QSqlDatabase &db, RowSignature::Table table, const QSet<qint64> &valid) {
+    const QString name = RowSignature::tableName(table);
+    QSqlQuery rows(db);
+    rows.setForwardOnly(true);
+    if (!rows.exec("SELECT * FROM " + name + " ORDER BY id ASC")) return false;
+    QSqlQuery upd(db);
+    upd.prepare("UPDATE " + name + " SET signature = ? WHERE id = ?");
+    RowSignature::Hasher hasher(table);
+    hasher.bind(rows);
+    QByteArray prev;
+    while (rows.next()) {
+        const QByteArray stored = rows.value("signature").toString().toLatin1();
+        const QByteArray sig = valid.contains(rows.value("id").toLongLong()) ? hasher.sign(prev, rows) : stored;
+        if (sig != stored) {
+            upd.bindValue(0, QString::fromLatin1(sig));
+            upd.bindValue(1, rows.value("id"));
+            if (!upd.exec()) return false;
+        }
+        prev = sig;
+    }
+    return MerkleIndex::rebuildFrom(db, table, 0);
+}
+
+bool DatabaseManager::migrateFixedPointMass() {
+    QSqlQuery q(db);
+    for (const MassTable &mt : massTables()) {
+        const QString name = RowSignature::tableName(mt.table);
+
+        // 1. Which rows verify under the double codec, before their values change
+        QSet<qint64> valid;
+        if (!verifiedRows(db, mt.table, RowSignature::Hasher::DoubleWeights, &valid)) return false;
+
+        // 2. Rebuild: copy every column, weights rounded to whole milligrams
+        QStringList columns;
+        if (!q.exec("PRAGMA table_info(" + name + ")")) return false;
+        while (q.next()) columns << q.value(1).toString();
+        QStringList values;
+        for (const QString &c : columns)
+            values << (mt.masses.contains(c) ? QString("CAST(ROUND(%1 * 1000) AS INTEGER)").arg(c) : c);
+
+        QVariant sequence; // AUTOINCREMENT high-water mark, so deleted ids stay unused
+        if (q.exec("SELECT seq FROM sqlite_sequence WHERE name = '" + name + "'") && q.next())
+            sequence = q.value(0);
+
+        const QString rebuilt = name + "_v6";
+        if (!q.exec("CREATE TABLE " + rebuilt + " (" + mt.columns + ")")) return false;
+        if (!q.exec("INSERT INTO " + rebuilt + " (" + columns.join(", ") + ") SELECT "
+                    + values.join(", ") + " FROM " + name + " ORDER BY id ASC")) return false;
+        if (!q.exec("DROP TABLE " + name)) return false;
+        if (!q.exec("ALTER TABLE " + rebuilt + " RENAME TO " + name)) return false;
+        if (sequence.isValid()) {
+            // An empty copy may leave no row to raise; sqlite_sequence has no
+            // key on name, so INSERT OR REPLACE would only add a second one
+            q.prepare("UPDATE sqlite_sequence SET seq = MAX(seq, ?) WHERE name = ?");
+            q.addBindValue(sequence);
+            q.addBindValue(name);
+            if (!q.exec()) return false;
+            if (q.numRowsAffected() == 0) {
+                q.prepare("INSERT INTO sqlite_sequence (name, seq) VALUES (?, ?)");
+                q.addBindValue(name);
+                q.addBindValue(sequence);
+                if (!q.exec()) return false;
+            }
+        }
+
+        // 3. Re-sign the rows that were valid, chained in the new codec
+        if (!resignRows(db, mt.table, valid)) return false;
+    }
+
+    // 4. Balances and checkpoints, exact from here on
+    if (!q.exec("DROP TABLE ledger_checkpoints")) return false;
+    if (!q.exec("CREATE TABLE ledger_checkpoints ("
+                "ledger_id INTEGER PRIMARY KEY, date TEXT, "
+                "bal_u INTEGER, bal_u235 INTEGER, bal_items INTEGER)")) return false;
+    if (!updateLedgerBalancesFrom(0)) return false;
+
+    // Stored watermark signatures are in the old form: next check starts over
+    return q.exec("DELETE FROM integrity_state");
+}
+
+// v7: ledger dates in one sortable form. yyMMdd lines become yyyy-MM-dd;
+// the date is signed, so lines that verified are re-signed.
+bool DatabaseManager::migrateLedgerIsoDates() {
+    QSet<qint64> valid;
+    if (!verifiedRows(db, RowSignature::Ledger, RowSignature::Hasher::FixedPoint, &valid)) return false;
+
+    static const char *TO_ISO =
+        " SET date = '20' || substr(date, 1, 2) || '-' || substr(date, 3, 2) || '-' || substr(date, 5, 2)"
+        " WHERE length(date) = 6 AND date NOT GLOB '*[^0-9]*'";
+    QSqlQuery q(db);
+    if (!q.exec(QString("UPDATE manual_ledger") + TO_ISO)) return false;
+    if (!q.exec(QString("UPDATE ledger_checkpoints") + TO_ISO)) return false;
+    if (!resignRows(db, RowSignature::Ledger, valid)) return false;
+
+    // The checkpoint date index gives way to idx_manual_ledger_date
+    if (!q.exec("DROP INDEX IF EXISTS idx_ledger_checkpoints_date")) return false;
+    return q.exec("DELETE FROM integrity_state");
+}
+
+void DatabaseManager::ensureIndexes() {
+    QSqlQuery query(db);
+    for (const ManagedIndex &idx : MANAGED_INDEXES) {
+        if (!query.exec(idx.ddl)) {
+            qWarning() << "Could not create index" << idx.name << ":" << query.lastError().text();
+        }
+    }
+    // Refresh planner statistics for the tables that changed since last time
+    query.exec("PRAGMA optimize");
+}
+
+// =========================================================
+// STATEMENT CACHE
+// =========================================================
+
+// Prepared statements live with the calling thread's writer connection,
+// so the same write path works from the GUI thread and from workers.
+QSqlQuery &DatabaseManager::cachedQuery(const QString &sql) {
+    return ConnectionPool::instance().cachedQuery(sql);
+}
+
+// =========================================================
+// QUERY PLAN AUDIT
+// =========================================================
+
+bool DatabaseManager::auditQueryPlans(QStringList *findings) {
+    // What a query may do besides seeking: a listing that returns the whole
+    // table may scan it, and a report that returns every row of its filter
+    // may sort them. Nothing else may scan (table or full index) or sort.
+    enum Allowance { SeeksOnly = 0, WholeTable = 1, SortsResult = 2 };
+    struct PlanCase {
+        QString label;
+        QString sql;
+        QVariantList binds;
+        int allow;
+    };
+
+    const QString glSql = QString(SQL_GL_DATA) + "ORDER BY h.record_date ASC, h.id ASC";
+    const QString glFilteredSql = QString(SQL_GL_DATA)
+        + "AND b.element LIKE 'Enriched%' ORDER BY h.record_date ASC, h.id ASC";
+
+    const QList<PlanCase> cases = {
+        { "getICRData",             SQL_ICR_DATA,  { "MBA", "2000-01-01", "2099-12-31" }, SortsResult },
+        { "getReceipts",            SQL_RECEIPTS_ALL, {}, WholeTable },
+        { "getReceiptsPage",        receiptsKeysetSql(PageRequest()), { 0, 200 }, SeeksOnly },
+        { "getManualLedgerPage",    keysetSql("SELECT * FROM manual_ledger ", "id", false, PageRequest()), { 0, 200 }, SeeksOnly },
+        { "getManualLedgerFrom",    SQL_LEDGER_FROM, { 1 }, SeeksOnly },
+        { "readWrittenRow (receipt)", SQL_RECEIPT_WRITTEN, { 1 }, SeeksOnly },
+        { "readWrittenRow (ledger)", "SELECT * FROM manual_ledger WHERE id = ?", { 1 }, SeeksOnly },
+        { "getLIIEntriesPage",      keysetSql("SELECT * FROM lii_manual ", "id", false, PageRequest()), { 0, 200 }, SeeksOnly },
+        { "getNLIEntriesPage",      keysetSql("SELECT * FROM nli_manual ", "id", false, PageRequest()), { 0, 200 }, SeeksOnly },
+        { "getMBREntriesPage",      keysetSql("SELECT * FROM mbr_entries ", "id", false, PageRequest()), { 0, 200 }, SeeksOnly },
+        { "balanceAsOf (line)",     SQL_LEDGER_LAST_ON, { "2099-12-31" }, SeeksOnly },
+        { "balanceAsOf (checkpoint)", SQL_LEDGER_CHECKPOINT_AT, { 1 }, SeeksOnly },
+        { "balanceAsOf (replay)",   SQL_LEDGER_REPLAY_TO, { 0, 1 }, SeeksOnly },
+        { "lastSignature",          "SELECT signature FROM manual_ledger WHERE id = (SELECT MAX(id) FROM manual_ledger)", {}, SeeksOnly },
+        { "verifySignatures (state)", "SELECT verified_id, verified_sig, last_full_check FROM integrity_state WHERE table_name = ?", { "manual_ledger" }, SeeksOnly },
+        { "verifySignatures (rows)", "SELECT * FROM manual_ledger WHERE id > ? ORDER BY id ASC", { 0 }, SeeksOnly },
+        { "merkleRoot",             "SELECT hash FROM merkle_nodes WHERE table_name = ? AND idx = 0 ORDER BY level DESC LIMIT 1", { "manual_ledger" }, SeeksOnly },
+        { "merkle leaf by row",     "SELECT idx FROM merkle_nodes WHERE table_name = ? AND level = 0 AND row_id >= ? ORDER BY row_id ASC LIMIT 1", { "manual_ledger", 1 }, SeeksOnly },
+        { "merkle node",            "SELECT hash FROM merkle_nodes WHERE table_name = ? AND level = ? AND idx = ?", { "manual_ledger", 0, 0 }, SeeksOnly },
+        { "merkle height",          "SELECT MAX(level) FROM merkle_nodes WHERE table_name = ?", { "manual_ledger" }, SeeksOnly },
+        { "merkle prune",           "DELETE FROM merkle_nodes WHERE table_name = ? AND level = ? AND idx >= ?", { "manual_ledger", 1, 0 }, SeeksOnly },
+        { "chain anchor",           "SELECT signature FROM manual_ledger WHERE id < ? ORDER BY id DESC LIMIT 1", { 1 }, SeeksOnly },
+        { "verifySignatures (breaks)", "SELECT row_id FROM integrity_breaks WHERE table_name = ?", { "manual_ledger" }, SeeksOnly },
+        { "getLIIData",             SQL_LII_DATA,  { "MBA" }, SeeksOnly },
+        { "getGeneralLedgerData",   glSql,         { "MBA" }, SortsResult },
+        { "getGeneralLedgerData (element)", glFilteredSql, { "MBA" }, SortsResult },
+        { "getManualLedgerEntries", "SELECT * FROM manual_ledger ORDER BY id ASC", {}, WholeTable },
+        { "getLIIEntries",          "SELECT * FROM lii_manual ORDER BY id ASC", {}, WholeTable },
+        { "getNLIEntries",          "SELECT * FROM nli_manual ORDER BY id ASC", {}, WholeTable },
+        { "getMBREntries",          "SELECT * FROM mbr_entries ORDER BY id ASC", {}, WholeTable },
+        { "getBackups",             "SELECT * FROM backups ORDER BY created_date DESC", {}, WholeTable },
+        { "restoreBackup",          "SELECT filename FROM backups WHERE id = ?", { 1 }, SeeksOnly },
+        { "deleteReceipt",          "DELETE FROM history WHERE id = ?", { 1 }, SeeksOnly },
+        { "deleteManualLedgerEntry","DELETE FROM manual_ledger WHERE id = ?", { 1 }, SeeksOnly },
+        { "deleteLIIEntry",         "DELETE FROM lii_manual WHERE id = ?", { 1 }, SeeksOnly },
+        { "deleteNLIEntry",         "DELETE FROM nli_manual WHERE id = ?", { 1 }, SeeksOnly },
+        { "deleteMBREntry",         "DELETE FROM mbr_entries WHERE id = ?", { 1 }, SeeksOnly },
+    };
+
+    bool clean = true;
+    for (const PlanCase &c : cases) {
+        QSqlQuery plan(db);
+        if (!plan.prepare("EXPLAIN QUERY PLAN " + c.sql)) {
+            clean = false;
+            if (findings) *findings << QString("%1: %2").arg(c.label, plan.lastError().text());
+            continue;
+        }
+        for (int i = 0; i < c.binds.size(); ++i) plan.bindValue(i, c.binds[i]);
+        if (!plan.exec()) {
+            clean = false;
+            if (findings) *findings << QString("%1: %2").arg(c.label, plan.lastError().text());
+            continue;
+        }
+
+        // Column 3 is the human-readable step, e.g. "SCAN h",
+        // "SCAN h USING INDEX idx_history_change_type" (every entry of the
+        // index), "USE TEMP B-TREE FOR ORDER BY" or
+        // "SEARCH b USING INDEX idx_batches_mba_status (mba=?)"
+        while (plan.next()) {
+            const QString detail = plan.value(3).toString();
+            // Reading back a subquery's own (bounded) rows is not a table scan
+            const bool coroutine = detail.startsWith("SCAN (subquery") || detail.startsWith("SCAN CONSTANT ROW");
+            const bool scan = detail.startsWith("SCAN ") && !coroutine;
+            const bool sort = detail.startsWith("USE TEMP B-TREE");
+            if ((scan && !(c.allow & WholeTable)) || (sort && !(c.allow & SortsResult))) {
+                clean = false;
+                if (findings) *findings << QString("%1: %2").arg(c.label, detail);
+            }
+        }
+    }
+    return clean;
+}
+
+// =========================================================
+// BATCH INSERTS (GROUP COMMIT)
+// =========================================================
+
+static bool isNumber(const QVariant &v, bool allowNegative = false) {
+    bool ok = false;
+    double d = v.toDouble(&ok);
+    return ok && (allowNegative || d >= 0) && qAbs(d) <= Mass::MaxGrams;
+}
+
+// The row as stored: the given weight columns, in grams, become whole milligrams
+static QMap<QString, QVariant> withStoredMasses(QMap<QString, QVariant> row, const QStringList &masses) {
+    for (const QString &column : masses) row[column] = Mass::fromGrams(row.value(column).toDouble()).mg();
+    return row;
+}
+
+static bool isCount(const QVariant &v) {
+    bool ok = false;
+    int n = v.toInt(&ok);
+    return ok && n >= 0;
+}
+
+QString DatabaseManager::validateManualLedgerRow(const QMap<QString, QVariant> &data) {
+    if (data.value("date").toString().isEmpty()) return "Date is required.";
+    if (ledgerDate(data.value("date").toString()).isEmpty())
+        return QString("Date '%1' is not a valid date (yyyy-MM-dd).").arg(data.value("date").toString());
+    if (LedgerBalanceEngine::typeOf(data.value("type").toString()) == LedgerBalanceEngine::Unknown)
+        return QString("Unknown transaction type '%1'.").arg(data.value("type").toString());
+    if (!isNumber(data.value("u_weight")))    return "U weight must be a non-negative number.";
+    if (!isNumber(data.value("u235_weight"))) return "U-235 weight must be a non-negative number.";
+    if (!isCount(data.value("items")))        return "Items must be a non-negative whole number.";
+    return QString();
+}
+
+QString DatabaseManager::validateLIIRow(const QMap<QString, QVariant> &data) {
+    if (data.value("kmp").toString().isEmpty())   return "KMP is required.";
+    if (data.value("batch").toString().isEmpty()) return "Batch is required.";
+    if (!isNumber(data.value("weight_elem")))     return "Element weight must be a non-negative number.";
+    if (!isNumber(data.value("weight_fissile")))  return "Fissile weight must be a non-negative number.";
+    if (!isNumber(data.value("weight_pu")))       return "Plutonium weight must be a non-negative number.";
+    if (!isNumber(data.value("burnup")))          return "Burnup must be a non-negative number.";
+    return QString();
+}
+
+QString DatabaseManager::validateNLIRow(const QMap<QString, QVariant> &data) {
+    if (data.value("batch").toString().isEmpty()) return "Batch is required.";
+    if (!isCount(data.value("items")))            return "Items must be a non-negative whole number.";
+    if (!isNumber(data.value("u_weight")))        return "U weight must be a non-negative number.";
+    if (!isNumber(data.value("u_iso_weight")))    return "U isotope weight must be a non-negative number.";
+    if (!isNumber(data.value("p_weight")))        return "Pu weight must be a non-negative number.";
+    return QString();
+}
+
+QString DatabaseManager::validateMBRRow(const QMap<QString, QVariant> &data) {
+    if (data.value("entry_name").toString().isEmpty()) return "Entry name is required.";
+    if (data.value("element").toString().isEmpty())    return "Element is required.";
+    // MBR adjustments may be negative
+    if (!isNumber(data.value("weight"), true))         return "Weight must be a number.";
+    if (!isNumber(data.value("fissile"), true))        return "Fissile weight must be a number.";
+    return QString();
+}
+
+QList<RowResult> DatabaseManager::insertBatch(const QList<QMap<QString, QVariant>> &rows,
+                                              RowValidator validate, RowInserter insert) {
+    QList<RowResult> results(rows.size());
+
+    // 1. Validate everything up front so a bad row never opens a transaction for nothing
+    int valid = 0;
+    for (int i = 0; i < rows.size(); ++i) {
+        results[i].error = validate(rows[i]);
+        if (results[i].error.isEmpty()) ++valid;
+    }
+    if (valid == 0) return results;
+
+    // 2. One transaction, one fsync. A failing INSERT only undoes its own
+    //    statement in SQLite, so the remaining rows still commit.
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    if (!conn.transaction()) {
+        const QString err = "Could not start transaction: " + conn.lastError().text();
+        for (RowResult &r : results) if (r.error.isEmpty()) r.error = err;
+        return results;
+    }
+
+    for (int i = 0; i < rows.size(); ++i) {
+        if (!results[i].error.isEmpty()) continue;
+        QString err;
+        qint64 id = (this->*insert)(rows[i], &err);
+        if (id > 0) {
+            results[i].ok = true;
+            results[i].id = id;
+        } else {
+            results[i].error = err.isEmpty() ? QString("Insert failed.") : err;
+        }
+    }
+
+    if (!conn.commit()) {
+        const QString err = "Commit failed: " + conn.lastError().text();
+        conn.rollback();
+        for (RowResult &r : results) {
+            if (r.ok) { r.ok = false; r.id = 0; r.error = err; }
+        }
+    }
+    return results;
 }
 
 // =========================================================
 // OPERATIONS
 // =========================================================
 
-bool DatabaseManager::registerReceipt(const QMap<QString, QVariant> &data) {
-    QSqlDatabase::database().transaction();
+bool DatabaseManager::registerReceipt(const QMap<QString, QVariant> &data, WrittenRow *written) {
+    // Batch + history rows commit together on this thread's writer
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    if (!conn.transaction()) return false;
+
+    QSqlQuery &query = cachedQuery("INSERT INTO batches (batch_number, mba, kmp, building, room, "
+                                   "physical_form, chemical_form, element, weight_u, weight_u235, "
+                                   "unit, manufacturer, insertion_date, status) "
+                                   "VALUES (:bn, :mba, :kmp, :bldg, :room, :pf, :cf, :el, "
+                                   ":wu, :wu235, :unit, :mfg, :date, 'Active')");
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO batches (batch_number, mba, kmp, building, room, "
-                  "physical_form, chemical_form, element, weight_u, weight_u235, "
-                  "unit, manufacturer, insertion_date, status) "
-                  "VALUES (:bn, :mba, :kmp, :bldg, :room, :pf, :cf, :el, "
-                  ":wu, :wu235, :unit, :mfg, :date, 'Active')");
-    
     query.bindValue(":bn", data["batch_number"]);
     query.bindValue(":mba", data["to_mba"]);
     query.bindValue(":kmp", data["kmp"]);
@@ -105,34 +850,41 @@ bool DatabaseManager::registerReceipt(const QMap<QString, QVariant> &data) {
     query.bindValue(":pf", data["physical_form"]);
     query.bindValue(":cf", data["chemical_form"]);
     query.bindValue(":el", data["element"]);
-    query.bindValue(":wu", data["weight_u"]);
-    query.bindValue(":wu235", data["weight_u235"]);
+    const QMap<QString, QVariant> row = withStoredMasses(data, { "weight_u", "weight_u235" });
+    query.bindValue(":wu", row["weight_u"]);
+    query.bindValue(":wu235", row["weight_u235"]);
     query.bindValue(":unit", data["unit"]);
     query.bindValue(":mfg", data["manufacturer"]);
     query.bindValue(":date", data["date"]);
 
     if(!query.exec()) {
-        QSqlDatabase::database().rollback();
+        conn.rollback();
         return false;
     }
 
     int batchId = query.lastInsertId().toInt();
-    QSqlQuery hQuery;
-    hQuery.prepare("INSERT INTO history (batch_id, change_type, element_code, items_count, increase_u, decrease_u, record_date, description) "
-                   "VALUES (?, ?, ?, ?, ?, 0, ?, ?)");
-    hQuery.addBindValue(batchId);
-    hQuery.addBindValue(data["receipt_code"]); 
-    hQuery.addBindValue("D"); 
-    hQuery.addBindValue(data["count"]);
-    hQuery.addBindValue(data["weight_u"]);
-    hQuery.addBindValue(data["date"]);
-    hQuery.addBindValue("Receipt from " + data["from_mba"].toString());
-
-    if(!hQuery.exec()) {
-        QSqlDatabase::database().rollback();
+    if (!sealRow(RowSignature::Batches, batchId)) {
+        conn.rollback();
+        return false;
+    }
+
+    QSqlQuery &hQuery = cachedQuery("INSERT INTO history (batch_id, change_type, element_code, items_count, increase_u, decrease_u, record_date, description) "
+                                    "VALUES (?, ?, ?, ?, ?, 0, ?, ?)");
+    hQuery.bindValue(0, batchId);
+    hQuery.bindValue(1, data["receipt_code"]); 
+    hQuery.bindValue(2, "D"); 
+    hQuery.bindValue(3, data["count"]);
+    hQuery.bindValue(4, row["weight_u"]);
+    hQuery.bindValue(5, data["date"]);
+    hQuery.bindValue(6, "Receipt from " + data["from_mba"].toString());
+
+    if(!hQuery.exec() || !sealRow(RowSignature::History, hQuery.lastInsertId().toLongLong())) {
+        conn.rollback();
         return false;
     }
-    QSqlDatabase::database().commit();
+    const qint64 historyId = hQuery.lastInsertId().toLongLong();
+    if (!conn.commit()) return false;
+    readWrittenRow(SQL_RECEIPT_WRITTEN, historyId, written);
     return true;
 }
 
@@ -141,53 +893,596 @@ bool DatabaseManager::registerReceipt(const QMap<QString, QVariant> &data) {
 // NEW MANUAL LEDGER FUNCTIONS (WITH CYBER SECURITY)
 // =========================================================
 
-bool DatabaseManager::addManualLedgerEntry(const QMap<QString, QVariant> &data) {
-    // 1. TAMPER EVIDENT LOGIC: Hash the exact data before saving
-    QString rawGL = QString("%1|%2|%3|%4|%5|%6|%7")
-        .arg(data["date"].toString())
-        .arg(data["ref"].toString())
-        .arg(data["code"].toString())
-        .arg(data["type"].toString())
-        .arg(data["u_weight"].toDouble(), 0, 'f', 4)
-        .arg(data["u235_weight"].toDouble(), 0, 'f', 4)
-        .arg(data["items"].toInt());
-        
-    QString hashSig = QCryptographicHash::hash(rawGL.toUtf8(), QCryptographicHash::Sha256).toHex();
+bool DatabaseManager::addManualLedgerEntry(const QMap<QString, QVariant> &data, WrittenRow *written) {
+    // Line + its running balance (+ checkpoint) land together
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    if (!conn.transaction()) return false;
+    const qint64 id = insertManualLedgerRow(data, nullptr);
+    if (id > 0 && conn.commit()) {
+        // The committed line, balance included, goes straight into the cache
+        WrittenRow line;
+        if (readWrittenRow("SELECT * FROM manual_ledger WHERE id = ?", id, &line))
+            LedgerCache::instance().appendWritten(line);
+        else
+            LedgerCache::instance().invalidateFrom(id);
+        if (written) *written = line;
+        return true;
+    }
+    conn.rollback();
+    return false;
+}
 
-    // 2. Save
-    QSqlQuery query;
-    query.prepare("INSERT INTO manual_ledger (date, ref, code, type, u_weight, u235_weight, items, signature) "
-                  "VALUES (:d, :r, :c, :t, :u, :u235, :i, :sig)");
-    query.bindValue(":d", data["date"]);
-    query.bindValue(":r", data["ref"]);
-    query.bindValue(":c", data["code"]);
-    query.bindValue(":t", data["type"]);
-    query.bindValue(":u", data["u_weight"]);
-    query.bindValue(":u235", data["u235_weight"]);
-    query.bindValue(":i", data["items"]);
+QList<RowResult> DatabaseManager::addManualLedgerEntries(const QList<QMap<QString, QVariant>> &rows) {
+    const QList<RowResult> results = insertBatch(rows, &validateManualLedgerRow, &DatabaseManager::insertManualLedgerRow);
+    for (const RowResult &r : results) {
+        if (r.ok) { LedgerCache::instance().invalidateFrom(r.id); break; } // ids ascend
+    }
+    return results;
+}
+
+qint64 DatabaseManager::insertManualLedgerRow(const QMap<QString, QVariant> &data, QString *error) {
+    // 1. TAMPER EVIDENT LOGIC: Chain the exact data onto the previous line's signature
+    QMap<QString, QVariant> row = withStoredMasses(data, { "u_weight", "u235_weight" });
+    row["date"] = ledgerDate(row.value("date").toString());
+    if (row["date"].toString().isEmpty()) {
+        if (error) *error = "Date is not a valid date.";
+        return 0;
+    }
+    QString hashSig = RowSignature::sign(RowSignature::Ledger, lastSignature(RowSignature::Ledger), row);
+
+    // 2. Save. The line, its running balance and its Merkle leaf go in
+    //    together or not at all, also inside a batch transaction.
+    QSqlQuery sp(ConnectionPool::instance().writer());
+    sp.exec("SAVEPOINT ledger_row");
+    auto fail = [&](const QString &why) -> qint64 {
+        if (error) *error = why;
+        sp.exec("ROLLBACK TO ledger_row");
+        sp.exec("RELEASE ledger_row");
+        return 0;
+    };
+    QSqlQuery &query = cachedQuery("INSERT INTO manual_ledger (date, ref, code, type, u_weight, u235_weight, items, signature) "
+                                   "VALUES (:d, :r, :c, :t, :u, :u235, :i, :sig)");
+    query.bindValue(":d", row["date"]);
+    query.bindValue(":r", row["ref"]);
+    query.bindValue(":c", row["code"]);
+    query.bindValue(":t", row["type"]);
+    // Numbers bound as the exact values that were signed
+    query.bindValue(":u", row["u_weight"].toLongLong());
+    query.bindValue(":u235", row["u235_weight"].toLongLong());
+    query.bindValue(":i", row["items"].toLongLong());
     query.bindValue(":sig", hashSig); // Save Hash
-    return query.exec();
+    if (!query.exec()) return fail(query.lastError().text());
+    const qint64 id = query.lastInsertId().toLongLong();
+
+    // 3. New lines append, so only this line's balance and one Merkle path change
+    if (!updateLedgerBalancesFrom(id)) return fail("Could not update running balance.");
+    if (!MerkleIndex::append(ConnectionPool::instance().writer(), RowSignature::Ledger, id, hashSig))
+        return fail("Could not update integrity index.");
+    sp.exec("RELEASE ledger_row");
+    return id;
+}
+
+QSqlQuery DatabaseManager::getManualLedgerEntries(const QSqlDatabase &conn) {
+    return QSqlQuery("SELECT * FROM manual_ledger ORDER BY id ASC", pick(conn));
+}
+
+
+// =========================================================
+// LEDGER BALANCES
+// =========================================================
+
+// Recomputes bal_* for every line with id >= fromId, starting from the stored
+// balance of the line before it, and rebuilds the checkpoints in that range.
+// Appends touch one line; a delete touches only the suffix after it.
+// Runs on the calling thread's writer; the caller owns the transaction.
+bool DatabaseManager::updateLedgerBalancesFrom(qint64 fromId) {
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+
+    // 1. Anchor: stored balance of the previous line (none = start of ledger)
+    LedgerBalance bal;
+    QSqlQuery prev(conn);
+    prev.prepare("SELECT id, bal_u, bal_u235, bal_items FROM manual_ledger "
+                 "WHERE id < ? ORDER BY id DESC LIMIT 1");
+    prev.bindValue(0, fromId);
+    if (!prev.exec()) return false;
+    if (prev.next()) {
+        bal.ledgerId = prev.value(0).toLongLong();
+        bal.u = Mass::fromStored(prev.value(1));
+        bal.u235 = Mass::fromStored(prev.value(2));
+        bal.items = prev.value(3).toInt();
+    }
+
+    // 2. Checkpoints past the anchor are stale; count lines since the last good one
+    QSqlQuery cp(conn);
+    cp.prepare("DELETE FROM ledger_checkpoints WHERE ledger_id > ?");
+    cp.bindValue(0, bal.ledgerId);
+    if (!cp.exec()) return false;
+    cp.prepare("SELECT COUNT(*) FROM manual_ledger WHERE id <= ? AND id > "
+               "COALESCE((SELECT MAX(ledger_id) FROM ledger_checkpoints), 0)");
+    cp.bindValue(0, bal.ledgerId);
+    if (!cp.exec() || !cp.next()) return false;
+    int sinceCheckpoint = cp.value(0).toInt();
+
+    // 3. Read the suffix column by column, types mapped once
+    QSqlQuery rows(conn);
+    rows.setForwardOnly(true);
+    rows.prepare(SQL_LEDGER_REPLAY);
+    rows.bindValue(0, fromId - 1);
+    if (!rows.exec()) return false;
+
+    QVector<qint64> ids;
+    QVector<QString> dates;
+    QVector<LedgerBalanceEngine::Type> types;
+    QVector<Mass> us, u235s;
+    QVector<int> items;
+    while (rows.next()) {
+        ids   << rows.value(0).toLongLong();
+        dates << rows.value(1).toString();
+        types << LedgerBalanceEngine::typeOf(rows.value(2).toString());
+        us    << Mass::fromStored(rows.value(3));
+        u235s << Mass::fromStored(rows.value(4));
+        items << rows.value(5).toInt();
+    }
+
+    // 4. Balances in one pass over the columns
+    const int n = ids.size();
+    QVector<Mass> balUs(n), balU235s(n);
+    QVector<int> balItems(n);
+    LedgerBalanceEngine engine(bal);
+    engine.run(n, ids.constData(), types.constData(), us.constData(), u235s.constData(),
+               items.constData(), balUs.data(), balU235s.data(), balItems.data());
+
+    // 5. Store them, with a checkpoint every LEDGER_CHECKPOINT_INTERVAL lines
+    QSqlQuery &upd = cachedQuery("UPDATE manual_ledger SET bal_u = ?, bal_u235 = ?, bal_items = ? WHERE id = ?");
+    QSqlQuery &mark = cachedQuery("INSERT OR REPLACE INTO ledger_checkpoints "
+                                  "(ledger_id, date, bal_u, bal_u235, bal_items) VALUES (?, ?, ?, ?, ?)");
+    for (int i = 0; i < n; ++i) {
+        upd.bindValue(0, balUs[i].mg());
+        upd.bindValue(1, balU235s[i].mg());
+        upd.bindValue(2, balItems[i]);
+        upd.bindValue(3, ids[i]);
+        if (!upd.exec()) return false;
+
+        if (++sinceCheckpoint >= LEDGER_CHECKPOINT_INTERVAL) {
+            mark.bindValue(0, ids[i]);
+            mark.bindValue(1, dates[i]);
+            mark.bindValue(2, balUs[i].mg());
+            mark.bindValue(3, balU235s[i].mg());
+            mark.bindValue(4, balItems[i]);
+            if (!mark.exec()) return false;
+            sinceCheckpoint = 0;
+        }
+    }
+    return true;
+}
+
+LedgerBalance DatabaseManager::balanceAsOf(const QString &date, const QSqlDatabase &conn) {
+    QSqlDatabase c = pick(conn);
+    LedgerBalance bal;
+
+    // 1. Last line dated on or before `date`, by the (date, id) index. A
+    //    back-dated line still counts by its date, not by where it was entered.
+    QSqlQuery line(c);
+    line.prepare(SQL_LEDGER_LAST_ON);
+    line.bindValue(0, ledgerDate(date));
+    if (!line.exec() || !line.next()) return bal;
+    const qint64 lastId = line.value(0).toLongLong();
+
+    // 2. Newest checkpoint at or before that line (primary key)
+    QSqlQuery cp(c);
+    cp.prepare(SQL_LEDGER_CHECKPOINT_AT);
+    cp.bindValue(0, lastId);
+    if (cp.exec() && cp.next()) {
+        bal.ledgerId = cp.value(0).toLongLong();
+        bal.u = Mass::fromStored(cp.value(1));
+        bal.u235 = Mass::fromStored(cp.value(2));
+        bal.items = cp.value(3).toInt();
+    }
+
+    // 3. Replay the lines between them: fewer than one checkpoint interval
+    QSqlQuery rows(c);
+    rows.setForwardOnly(true);
+    rows.prepare(SQL_LEDGER_REPLAY_TO);
+    rows.bindValue(0, bal.ledgerId);
+    rows.bindValue(1, lastId);
+    if (!rows.exec()) return bal;
+
+    LedgerBalanceEngine engine(bal);
+    while (rows.next()) {
+        engine.apply(rows.value(0).toLongLong(), LedgerBalanceEngine::typeOf(rows.value(1).toString()),
+                     Mass::fromStored(rows.value(2)), Mass::fromStored(rows.value(3)), rows.value(4).toInt());
+    }
+    return engine.balance();
+}
+
+// =========================================================
+// SIGNATURE CHAINS
+// =========================================================
+
+QString DatabaseManager::lastSignature(RowSignature::Table table) {
+    // MAX(id) is one seek to the end of the rowid tree
+    const QString name = RowSignature::tableName(table);
+    QSqlQuery &q = cachedQuery("SELECT signature FROM " + name + " WHERE id = (SELECT MAX(id) FROM " + name + ")");
+    return q.exec() && q.next() ? q.value(0).toString() : QString();
+}
+
+// Signs a row just inserted without a signature, exactly as stored, onto
+// the row before it, and adds its Merkle leaf. Caller owns the transaction.
+bool DatabaseManager::sealRow(RowSignature::Table table, qint64 id) {
+    const QString name = RowSignature::tableName(table);
+    QSqlQuery &prev = cachedQuery("SELECT signature FROM " + name + " WHERE id < ? ORDER BY id DESC LIMIT 1");
+    prev.bindValue(0, id);
+    if (!prev.exec()) return false;
+    const QByteArray prevSig = prev.next() ? prev.value(0).toString().toLatin1() : QByteArray();
+    prev.finish();
+
+    QSqlQuery &row = cachedQuery("SELECT * FROM " + name + " WHERE id = ?");
+    row.bindValue(0, id);
+    if (!row.exec() || !row.next()) return false;
+    RowSignature::Hasher hasher(table);
+    hasher.bind(row);
+    const QString sig = QString::fromLatin1(hasher.sign(prevSig, row));
+    row.finish();
+
+    QSqlQuery &upd = cachedQuery("UPDATE " + name + " SET signature = ? WHERE id = ?");
+    upd.bindValue(0, sig);
+    upd.bindValue(1, id);
+    return upd.exec() && MerkleIndex::append(ConnectionPool::instance().writer(), table, id, sig);
+}
+
+// Deletes a row of a signed table, re-links the chain across it and
+// rebuilds the Merkle tree from its position, all in one transaction
+bool DatabaseManager::deleteSignedRow(RowSignature::Table table, qint64 id) {
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    const QString name = RowSignature::tableName(table);
+    if (!conn.transaction()) return false;
+
+    QSqlQuery &sig = cachedQuery("SELECT signature FROM " + name + " WHERE id = ?");
+    sig.bindValue(0, id);
+    const QString deletedSig = sig.exec() && sig.next() ? sig.value(0).toString() : QString();
+    sig.finish();
+
+    QSqlQuery &query = cachedQuery("DELETE FROM " + name + " WHERE id = ?");
+    query.bindValue(0, id);
+    if (query.exec() && rechainSignaturesFrom(table, id, deletedSig)
+        && MerkleIndex::rebuildFrom(conn, table, id) && conn.commit()) return true;
+    conn.rollback();
+    return false;
+}
+
+bool DatabaseManager::readWrittenRow(const QString &sql, qint64 id, WrittenRow *written) {
+    if (!written) return true;
+    *written = WrittenRow();
+    // Primary-key lookup on the writer, so the row is seen even before a
+    // reader's snapshot catches up
+    QSqlQuery &q = cachedQuery(sql);
+    q.bindValue(0, id);
+    if (!q.exec() || !q.next()) return false;
+    const QSqlRecord rec = q.record();
+    for (int i = 0; i < rec.count(); ++i) written->values.insert(rec.fieldName(i), q.value(i));
+    written->id = id;
+    q.finish();
+    return true;
+}
+
+// Re-links the chain across a deleted row. Only rows that chained correctly
+// before the delete are re-signed; a row that was already broken keeps its
+// signature so the delete cannot launder it. Caller owns the transaction.
+bool DatabaseManager::rechainSignaturesFrom(RowSignature::Table table, qint64 deletedId,
+                                            const QString &deletedSig) {
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    const QString name = RowSignature::tableName(table);
+
+    // 1. The row now in front of the gap
+    qint64 anchorId = 0;
+    QString newPrev;
+    QSqlQuery prev(conn);
+    prev.prepare("SELECT id, signature FROM " + name + " WHERE id < ? ORDER BY id DESC LIMIT 1");
+    prev.bindValue(0, deletedId);
+    if (!prev.exec()) return false;
+    if (prev.next()) {
+        anchorId = prev.value(0).toLongLong();
+        newPrev = prev.value(1).toString();
+    }
+
+    // 2. Re-sign the suffix
+    QSqlQuery rows(conn);
+    rows.setForwardOnly(true);
+    rows.prepare("SELECT * FROM " + name + " WHERE id > ? ORDER BY id ASC");
+    rows.bindValue(0, deletedId);
+    if (!rows.exec()) return false;
+
+    QSqlQuery &upd = cachedQuery("UPDATE " + name + " SET signature = ? WHERE id = ?");
+    RowSignature::Hasher hasher(table);
+    hasher.bind(rows);
+    QByteArray oldPrev = deletedSig.toLatin1();
+    QByteArray resigned = newPrev.toLatin1();
+    while (rows.next()) {
+        const QByteArray stored = rows.value("signature").toString().toLatin1();
+        const bool wasValid = stored == hasher.sign(oldPrev, rows);
+        const QByteArray sig = wasValid ? hasher.sign(resigned, rows) : stored;
+        if (sig != stored) {
+            upd.bindValue(0, QString::fromLatin1(sig));
+            upd.bindValue(1, rows.value("id"));
+            if (!upd.exec()) return false;
+        }
+        oldPrev = stored;
+        resigned = sig;
+    }
+
+    // 3. Pull the watermark back in front of the gap; breaks past it are
+    //    found again by the next check
+    QSqlQuery st(conn);
+    st.prepare("UPDATE integrity_state SET verified_id = ?, verified_sig = ? "
+               "WHERE table_name = ? AND verified_id >= ?");
+    st.bindValue(0, anchorId);
+    st.bindValue(1, newPrev);
+    st.bindValue(2, name);
+    st.bindValue(3, deletedId);
+    if (!st.exec()) return false;
+    st.prepare("DELETE FROM integrity_breaks WHERE table_name = ? AND row_id >= ?");
+    st.bindValue(0, name);
+    st.bindValue(1, deletedId);
+    return st.exec();
+}
+
+IntegrityStatus DatabaseManager::verifySignatures(RowSignature::Table table, VerifyMode mode) {
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    const QString name = RowSignature::tableName(table);
+    IntegrityStatus status;
+
+    // 1. Watermark, and whether the scheduled full check is due
+    qint64 fromId = 0;
+    QString prevSig;
+    QString lastFull;
+    QSqlQuery st(conn);
+    st.prepare("SELECT verified_id, verified_sig, last_full_check FROM integrity_state WHERE table_name = ?");
+    st.bindValue(0, name);
+    if (st.exec() && st.next()) {
+        fromId = st.value(0).toLongLong();
+        prevSig = st.value(1).toString();
+        lastFull = st.value(2).toString();
+    }
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime lastFullAt = QDateTime::fromString(lastFull, Qt::ISODate);
+    // Without a full check on record there is no watermark to go on (new
+    // database, or a migration cleared integrity_state): nothing is hashed
+    // here, the whole chain is the background sweep's job
+    bool anchored = lastFullAt.isValid();
+    if (mode == Incremental)
+        status.fullCheckDue = !anchored || lastFullAt.secsTo(now) > FULL_CHECK_INTERVAL_SECS;
+
+    // 2. The last verified row must still be there, unchanged. If it is not,
+    //    rows behind the watermark were rewritten or removed outside AIR, and
+    //    rows after it cannot be chained onto it.
+    qint64 lostTail = 0;
+    if (mode == Incremental && anchored && fromId > 0) {
+        QSqlQuery tail(conn);
+        tail.prepare("SELECT signature FROM " + name + " WHERE id = ?");
+        tail.bindValue(0, fromId);
+        if (!tail.exec() || !tail.next()) lostTail = fromId;
+        if (lostTail || tail.value(0).toString() != prevSig) {
+            qWarning() << "Integrity:" << name << "changed behind verified row" << fromId;
+            anchored = false;
+            status.fullCheckDue = true;
+        }
+    }
+
+    if (!conn.transaction()) return status;
+    QSqlQuery w(conn);
+    if (mode == Full) {
+        fromId = 0;
+        prevSig.clear();
+        lastFull = now.toString(Qt::ISODate);
+        // Breaks on rows that no longer exist are the only trace of a removal: keep them
+        w.prepare("DELETE FROM integrity_breaks WHERE table_name = ? AND row_id IN (SELECT id FROM " + name + ")");
+        w.bindValue(0, name);
+        w.exec();
+    }
+    w.prepare("INSERT OR IGNORE INTO integrity_breaks (table_name, row_id) VALUES (?, ?)");
+    if (lostTail) {
+        w.bindValue(0, name);
+        w.bindValue(1, lostTail);
+        w.exec();
+    }
+
+    // 3. Hash forward from the watermark. Each row is checked against its
+    //    stored predecessor, so one bad row does not flag everything after it.
+    QSqlQuery rows(conn);
+    rows.setForwardOnly(true);
+    rows.prepare("SELECT * FROM " + name + " WHERE id > ? ORDER BY id ASC");
+    rows.bindValue(0, fromId);
+    if ((mode == Full || anchored) && rows.exec()) {
+        RowSignature::Hasher hasher(table);
+        hasher.bind(rows);
+        const int idCol = rows.record().indexOf("id");
+        const int sigCol = rows.record().indexOf("signature");
+        QByteArray prev = prevSig.toLatin1();
+        while (rows.next()) {
+            const QByteArray stored = rows.value(sigCol).toString().toLatin1();
+            const qint64 id = rows.value(idCol).toLongLong();
+            if (stored != hasher.sign(prev, rows)) {
+                w.bindValue(0, name);
+                w.bindValue(1, id);
+                w.exec();
+            }
+            prev = stored;
+            fromId = id;
+            ++status.rowsChecked;
+        }
+        prevSig = QString::fromLatin1(prev);
+    }
+
+    // 4. Advance the watermark
+    w.prepare("INSERT OR REPLACE INTO integrity_state (table_name, verified_id, verified_sig, last_full_check) "
+              "VALUES (?, ?, ?, ?)");
+    w.bindValue(0, name);
+    w.bindValue(1, fromId);
+    w.bindValue(2, prevSig);
+    w.bindValue(3, lastFull);
+    if (!w.exec() || !conn.commit()) {
+        qWarning() << "Integrity: could not save state for" << name << ":" << conn.lastError().text();
+        conn.rollback();
+    }
+
+    w.prepare("SELECT row_id FROM integrity_breaks WHERE table_name = ?");
+    w.bindValue(0, name);
+    if (w.exec()) {
+        while (w.next()) status.brokenIds.insert(w.value(0).toLongLong());
+    }
+    status.verifiedUpTo = fromId;
+    status.fullCheck = mode == Full;
+    return status;
+}
+
+bool DatabaseManager::recordFullVerification(RowSignature::Table table, const QSet<qint64> &brokenIds,
+                                             qint64 lastId, const QString &lastSig) {
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    const QString name = RowSignature::tableName(table);
+    if (!conn.transaction()) return false;
+
+    QSqlQuery w(conn);
+    w.prepare("DELETE FROM integrity_breaks WHERE table_name = ? AND row_id <= ? "
+              "AND row_id IN (SELECT id FROM " + name + ")");
+    w.bindValue(0, name);
+    w.bindValue(1, lastId);
+    bool ok = w.exec();
+
+    w.prepare("INSERT OR IGNORE INTO integrity_breaks (table_name, row_id) VALUES (?, ?)");
+    for (qint64 id : brokenIds) {
+        w.bindValue(0, name);
+        w.bindValue(1, id);
+        ok = ok && w.exec();
+    }
+
+    w.prepare("INSERT OR REPLACE INTO integrity_state (table_name, verified_id, verified_sig, last_full_check) "
+              "VALUES (?, ?, ?, ?)");
+    w.bindValue(0, name);
+    w.bindValue(1, lastId);
+    w.bindValue(2, lastSig);
+    w.bindValue(3, QDateTime::currentDateTime().toString(Qt::ISODate));
+    ok = ok && w.exec();
+
+    if (ok && conn.commit()) return true;
+    conn.rollback();
+    return false;
+}
+
+QByteArray DatabaseManager::integrityRoot(RowSignature::Table table, qint64 *leafCount,
+                                         const QSqlDatabase &conn) {
+    return MerkleIndex::root(pick(conn), table, leafCount);
+}
+
+bool DatabaseManager::exportIntegrityProof(RowSignature::Table table, qint64 firstId, qint64 lastId,
+                                           const QString &path) {
+    // Streamed, row by row; an existing file is only replaced by a complete proof
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    if (!MerkleIndex::writeRangeProof(pick(QSqlDatabase()), table, firstId, lastId, &file)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool DatabaseManager::verifyIntegrityProof(const QString &path, QString *detail) {
+    auto report = [detail](const QString &text) { if (detail) *detail = text; };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) { report("Cannot open " + path); return false; }
+    MerkleIndex::RangeProof proof;
+    if (!MerkleIndex::fromJson(QJsonDocument::fromJson(file.readAll()).object(), &proof)) {
+        report("Not an AIR integrity proof.");
+        return false;
+    }
+
+    // 1. The rows in the file must hash up to the root recorded with them
+    const QByteArray computed = MerkleIndex::rootFromProof(proof);
+    if (computed.isEmpty() || computed != proof.root) {
+        report(QString("The %1 rows in the file do not match the root they were exported with.")
+               .arg(proof.ids.size()));
+        return false;
+    }
+
+    // 2. ... and that root must be the one this database publishes
+    qint64 leaves = 0;
+    const QByteArray current = integrityRoot(proof.table, &leaves);
+    if (current != proof.root || leaves != proof.leafCount) {
+        report(QString("Rows are consistent with root %1 (%2 rows), but the database is now at %3 (%4 rows). "
+                       "Compare against the root published for the export date.")
+               .arg(QString::fromLatin1(proof.root.toHex())).arg(proof.leafCount)
+               .arg(QString::fromLatin1(current.toHex())).arg(leaves));
+        return false;
+    }
+    report(QString("%1 rows verified against root %2.")
+           .arg(proof.ids.size()).arg(QString::fromLatin1(current.toHex())));
+    return true;
+}
+
+// =========================================================
+// KEYSET PAGING
+// =========================================================
+
+QSqlQuery DatabaseManager::pageQuery(const QString &base, const QString &idCol, bool hasWhere,
+                                     const PageRequest &page, const QSqlDatabase &conn) {
+    return pageQuery(keysetSql(base, idCol, hasWhere, page), page, conn);
+}
+
+QSqlQuery DatabaseManager::pageQuery(const QString &windowSql, const PageRequest &page, const QSqlDatabase &conn) {
+    // No cursor yet: start at the near edge of the chosen direction
+    qint64 cursor = page.afterId;
+    if (cursor <= 0) cursor = page.direction == PageRequest::Backward ? std::numeric_limits<qint64>::max() : 0;
+
+    QSqlQuery query(pick(conn));
+    query.prepare(windowSql);
+    query.bindValue(0, cursor);
+    query.bindValue(1, qMax(1, page.pageSize));
+    query.exec();
+    return query;
 }
 
-QSqlQuery DatabaseManager::getManualLedgerEntries() {
-    return QSqlQuery("SELECT * FROM manual_ledger ORDER BY id ASC");
+QSqlQuery DatabaseManager::getReceiptsPage(const PageRequest &page, const QSqlDatabase &conn) {
+    return pageQuery(receiptsKeysetSql(page), page, conn);
 }
 
+QSqlQuery DatabaseManager::getManualLedgerPage(const PageRequest &page, const QSqlDatabase &conn) {
+    return pageQuery("SELECT * FROM manual_ledger ", "id", false, page, conn);
+}
+
+QSqlQuery DatabaseManager::getManualLedgerFrom(qint64 fromId, const QSqlDatabase &conn) {
+    QSqlQuery query(pick(conn));
+    query.setForwardOnly(true);
+    query.prepare(SQL_LEDGER_FROM);
+    query.addBindValue(fromId);
+    query.exec();
+    return query;
+}
+
+QSqlQuery DatabaseManager::getLIIEntriesPage(const PageRequest &page, const QSqlDatabase &conn) {
+    return pageQuery("SELECT * FROM lii_manual ", "id", false, page, conn);
+}
+
+QSqlQuery DatabaseManager::getNLIEntriesPage(const PageRequest &page, const QSqlDatabase &conn) {
+    return pageQuery("SELECT * FROM nli_manual ", "id", false, page, conn);
+}
+
+QSqlQuery DatabaseManager::getMBREntriesPage(const PageRequest &page, const QSqlDatabase &conn) {
+    return pageQuery("SELECT * FROM mbr_entries ", "id", false, page, conn);
+}
 
 // =========================================================
 // REPORTING
 // =========================================================
 
-QSqlQuery DatabaseManager::getICRData(const QString &mba, const QString &startDate, const QString &endDate) {
-    QSqlQuery query;
-    query.prepare("SELECT h.record_date, h.change_type, h.items_count, b.batch_number, "
-                  "b.physical_form, b.element, h.increase_u, h.decrease_u, h.description "
-                  "FROM history h "
-                  "JOIN batches b ON h.batch_id = b.id "
-                  "WHERE b.mba = :mba "
-                  "AND h.record_date >= :start AND h.record_date <= :end " 
-                  "ORDER BY h.id ASC");
-                  
+QSqlQuery DatabaseManager::getICRData(const QString &mba, const QString &startDate, const QString &endDate,
+                                      const QSqlDatabase &conn) {
+    QSqlQuery query(pick(conn));
+    query.prepare(SQL_ICR_DATA);
+
     query.bindValue(":mba", mba);
     query.bindValue(":start", startDate);
     query.bindValue(":end", endDate);
@@ -195,82 +1490,119 @@ QSqlQuery DatabaseManager::getICRData(const QString &mba, const QString &startDa
     return query;
 }
 
-QSqlQuery DatabaseManager::getReceipts() {
-    QSqlQuery query(db); 
-    query.prepare("SELECT h.id, h.record_date, h.change_type, b.batch_number, h.items_count, "
-                  "b.element, h.increase_u, b.weight_u235 "
-                  "FROM history h JOIN batches b ON h.batch_id = b.id "
-                  "WHERE h.change_type IN ('RD', 'RF', 'RN') "
-                  "ORDER BY h.id ASC LIMIT 50");
+QSqlQuery DatabaseManager::getReceipts(const QSqlDatabase &conn) {
+    QSqlQuery query(pick(conn));
+    query.prepare(SQL_RECEIPTS_ALL);
     query.exec();
     return query;
 }
 
 
-QSqlQuery DatabaseManager::getLIIData(const QString &mba, const QString &date) {
+QSqlQuery DatabaseManager::getLIIData(const QString &mba, const QString &date, const QSqlDatabase &conn) {
     Q_UNUSED(date); 
     
-    QSqlQuery query;
-    query.prepare("SELECT kmp, building, room, batch_number, physical_form, chemical_form, "
-                  "weight_u, weight_u235, weight_pu, weight_th "
-                  "FROM batches "
-                  "WHERE mba = ? AND status = 'Active' "
-                  "ORDER BY kmp, batch_number");
+    QSqlQuery query(pick(conn));
+    query.prepare(SQL_LII_DATA);
     query.addBindValue(mba);
     query.exec();
     return query;
 }
 
-bool DatabaseManager::addLIIEntry(const QMap<QString, QVariant> &data) {
-    QSqlQuery query;
-    query.prepare("INSERT INTO lii_manual (kmp, position, batch, desc, weight_elem, weight_fissile, weight_pu, burnup, cooling) "
-                  "VALUES (:k, :p, :b, :d, :we, :wf, :wp, :bu, :co)");
+bool DatabaseManager::addLIIEntry(const QMap<QString, QVariant> &data, WrittenRow *written) {
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    const qint64 id = insertLIIRow(data, nullptr);
+    if (id <= 0) return false;
+    readWrittenRow("SELECT * FROM lii_manual WHERE id = ?", id, written);
+    return true;
+}
+
+QList<RowResult> DatabaseManager::addLIIEntries(const QList<QMap<QString, QVariant>> &rows) {
+    return insertBatch(rows, &validateLIIRow, &DatabaseManager::insertLIIRow);
+}
+
+qint64 DatabaseManager::insertLIIRow(const QMap<QString, QVariant> &data, QString *error) {
+    // The item and its signature go in together, also inside a batch transaction
+    QSqlQuery sp(ConnectionPool::instance().writer());
+    sp.exec("SAVEPOINT lii_row");
+    auto fail = [&](const QString &why) -> qint64 {
+        if (error) *error = why;
+        sp.exec("ROLLBACK TO lii_row");
+        sp.exec("RELEASE lii_row");
+        return 0;
+    };
+    QSqlQuery &query = cachedQuery("INSERT INTO lii_manual (kmp, position, batch, desc, weight_elem, weight_fissile, weight_pu, burnup, cooling) "
+                                   "VALUES (:k, :p, :b, :d, :we, :wf, :wp, :bu, :co)");
     query.bindValue(":k", data["kmp"]);
     query.bindValue(":p", data["position"]);
     query.bindValue(":b", data["batch"]);
     query.bindValue(":d", data["desc"]);
-    query.bindValue(":we", data["weight_elem"]);
-    query.bindValue(":wf", data["weight_fissile"]);
-    query.bindValue(":wp", data["weight_pu"]);
+    const QMap<QString, QVariant> row = withStoredMasses(data, { "weight_elem", "weight_fissile", "weight_pu" });
+    query.bindValue(":we", row["weight_elem"]);
+    query.bindValue(":wf", row["weight_fissile"]);
+    query.bindValue(":wp", row["weight_pu"]);
     query.bindValue(":bu", data["burnup"]);
     query.bindValue(":co", 0.0);
-    return query.exec();
+    if (!query.exec()) return fail(query.lastError().text());
+    const qint64 id = query.lastInsertId().toLongLong();
+    if (!sealRow(RowSignature::LII, id)) return fail("Could not sign the item.");
+    sp.exec("RELEASE lii_row");
+    return id;
 }
 
-QSqlQuery DatabaseManager::getLIIEntries() {
-    return QSqlQuery("SELECT * FROM lii_manual ORDER BY id ASC");
+QSqlQuery DatabaseManager::getLIIEntries(const QSqlDatabase &conn) {
+    return QSqlQuery("SELECT * FROM lii_manual ORDER BY id ASC", pick(conn));
 }
 
-bool DatabaseManager::addNLIEntry(const QMap<QString, QVariant> &data) {
-    QSqlQuery query;
-    query.prepare("INSERT INTO nli_manual (batch, items, code, "
-                  "u_elem_code, u_iso_code, u_weight, u_iso_weight, "
-                  "p_elem_code, p_weight) "
-                  "VALUES (:b, :i, :c, :ue, :ui, :uw, :uiw, :pe, :pw)");
+bool DatabaseManager::addNLIEntry(const QMap<QString, QVariant> &data, WrittenRow *written) {
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    const qint64 id = insertNLIRow(data, nullptr);
+    if (id <= 0) return false;
+    readWrittenRow("SELECT * FROM nli_manual WHERE id = ?", id, written);
+    return true;
+}
+
+QList<RowResult> DatabaseManager::addNLIEntries(const QList<QMap<QString, QVariant>> &rows) {
+    return insertBatch(rows, &validateNLIRow, &DatabaseManager::insertNLIRow);
+}
+
+qint64 DatabaseManager::insertNLIRow(const QMap<QString, QVariant> &data, QString *error) {
+    QSqlQuery sp(ConnectionPool::instance().writer());
+    sp.exec("SAVEPOINT nli_row");
+    auto fail = [&](const QString &why) -> qint64 {
+        if (error) *error = why;
+        sp.exec("ROLLBACK TO nli_row");
+        sp.exec("RELEASE nli_row");
+        return 0;
+    };
+    QSqlQuery &query = cachedQuery("INSERT INTO nli_manual (batch, items, code, "
+                                   "u_elem_code, u_iso_code, u_weight, u_iso_weight, "
+                                   "p_elem_code, p_weight) "
+                                   "VALUES (:b, :i, :c, :ue, :ui, :uw, :uiw, :pe, :pw)");
     query.bindValue(":b", data["batch"]);
     query.bindValue(":i", data["items"]);
     query.bindValue(":c", data["code"]);
     query.bindValue(":ue", data["u_elem_code"]);
     query.bindValue(":ui", data["u_iso_code"]);
-    query.bindValue(":uw", data["u_weight"]);
-    query.bindValue(":uiw", data["u_iso_weight"]);
+    const QMap<QString, QVariant> row = withStoredMasses(data, { "u_weight", "u_iso_weight", "p_weight" });
+    query.bindValue(":uw", row["u_weight"]);
+    query.bindValue(":uiw", row["u_iso_weight"]);
     query.bindValue(":pe", data["p_elem_code"]);
-    query.bindValue(":pw", data["p_weight"]);
-    return query.exec();
+    query.bindValue(":pw", row["p_weight"]);
+    if (!query.exec()) return fail(query.lastError().text());
+    const qint64 id = query.lastInsertId().toLongLong();
+    if (!sealRow(RowSignature::NLI, id)) return fail("Could not sign the entry.");
+    sp.exec("RELEASE nli_row");
+    return id;
 }
 
-QSqlQuery DatabaseManager::getNLIEntries() {
-    return QSqlQuery("SELECT * FROM nli_manual ORDER BY id ASC");
+QSqlQuery DatabaseManager::getNLIEntries(const QSqlDatabase &conn) {
+    return QSqlQuery("SELECT * FROM nli_manual ORDER BY id ASC", pick(conn));
 }
 
-QSqlQuery DatabaseManager::getGeneralLedgerData(const QString &mba, const QString &elementFilter) {
-    QSqlQuery query;
-    QString sql = "SELECT h.record_date, b.batch_number, h.change_type, h.element_code, "
-                  "h.items_count, h.increase_u, h.decrease_u, "
-                  "b.weight_u, b.weight_u235 "
-                  "FROM history h "
-                  "JOIN batches b ON h.batch_id = b.id "
-                  "WHERE b.mba = :mba ";
+QSqlQuery DatabaseManager::getGeneralLedgerData(const QString &mba, const QString &elementFilter,
+                                                const QSqlDatabase &conn) {
+    QSqlQuery query(pick(conn));
+    QString sql = SQL_GL_DATA;
     
     if (elementFilter == "Depleted Uranium") sql += "AND b.element LIKE 'Depleted%' ";
     else if (elementFilter == "Natural Uranium") sql += "AND b.element LIKE 'Natural%' ";
@@ -291,49 +1623,63 @@ QSqlQuery DatabaseManager::getGeneralLedgerData(const QString &mba, const QStrin
 // MBR FUNCTIONS (WITH CYBER SECURITY)
 // =========================================================
 
-bool DatabaseManager::addMBREntry(const QMap<QString, QVariant> &data) {
-    // 1. TAMPER EVIDENT LOGIC: Hash data
-    QString rawMBR = QString("%1|%2|%3|%4|%5|%6|%7|%8")
-        .arg(data["continuation"].toString())
-        .arg(data["entry_name"].toString())
-        .arg(data["element"].toString())
-        .arg(data["weight"].toDouble(), 0, 'f', 4)
-        .arg(data["unit"].toString())
-        .arg(data["fissile"].toDouble(), 0, 'f', 4)
-        .arg(data["isotope"].toString())
-        .arg(data["report_no"].toString());
-        
-    QString hashSig = QCryptographicHash::hash(rawMBR.toUtf8(), QCryptographicHash::Sha256).toHex();
+bool DatabaseManager::addMBREntry(const QMap<QString, QVariant> &data, WrittenRow *written) {
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    const qint64 id = insertMBRRow(data, nullptr);
+    if (id <= 0) return false;
+    readWrittenRow("SELECT * FROM mbr_entries WHERE id = ?", id, written);
+    return true;
+}
 
-    // 2. Save
-    QSqlQuery query(db);
-    query.prepare("INSERT INTO mbr_entries (continuation, entry_name, element, weight, unit, fissile, isotope, report_no, signature) "
-                  "VALUES (:cont, :name, :elem, :wt, :unit, :fis, :iso, :rep, :sig)");
-    query.bindValue(":cont", data["continuation"]);
-    query.bindValue(":name", data["entry_name"]);
-    query.bindValue(":elem", data["element"]);
-    query.bindValue(":wt", data["weight"]);
-    query.bindValue(":unit", data["unit"]);
-    query.bindValue(":fis", data["fissile"]);
-    query.bindValue(":iso", data["isotope"]);
-    query.bindValue(":rep", data["report_no"]);
+QList<RowResult> DatabaseManager::addMBREntries(const QList<QMap<QString, QVariant>> &rows) {
+    return insertBatch(rows, &validateMBRRow, &DatabaseManager::insertMBRRow);
+}
+
+qint64 DatabaseManager::insertMBRRow(const QMap<QString, QVariant> &data, QString *error) {
+    // 1. TAMPER EVIDENT LOGIC: Chain data onto the previous entry's signature
+    const QMap<QString, QVariant> row = withStoredMasses(data, { "weight", "fissile" });
+    QString hashSig = RowSignature::sign(RowSignature::MBR, lastSignature(RowSignature::MBR), row);
+
+    // 2. Save, together with the entry's Merkle leaf
+    QSqlQuery sp(ConnectionPool::instance().writer());
+    sp.exec("SAVEPOINT mbr_row");
+    auto fail = [&](const QString &why) -> qint64 {
+        if (error) *error = why;
+        sp.exec("ROLLBACK TO mbr_row");
+        sp.exec("RELEASE mbr_row");
+        return 0;
+    };
+    QSqlQuery &query = cachedQuery("INSERT INTO mbr_entries (continuation, entry_name, element, weight, unit, fissile, isotope, report_no, signature) "
+                                   "VALUES (:cont, :name, :elem, :wt, :unit, :fis, :iso, :rep, :sig)");
+    query.bindValue(":cont", row["continuation"]);
+    query.bindValue(":name", row["entry_name"]);
+    query.bindValue(":elem", row["element"]);
+    query.bindValue(":wt", row["weight"].toLongLong()); // exact signed values
+    query.bindValue(":unit", row["unit"]);
+    query.bindValue(":fis", row["fissile"].toLongLong());
+    query.bindValue(":iso", row["isotope"]);
+    query.bindValue(":rep", row["report_no"]);
     query.bindValue(":sig", hashSig); // Save Hash
-    return query.exec();
+    if (!query.exec()) return fail(query.lastError().text());
+    const qint64 id = query.lastInsertId().toLongLong();
+
+    if (!MerkleIndex::append(ConnectionPool::instance().writer(), RowSignature::MBR, id, hashSig))
+        return fail("Could not update integrity index.");
+    sp.exec("RELEASE mbr_row");
+    return id;
 }
 
-QSqlQuery DatabaseManager::getMBREntries(int limit) {
+QSqlQuery DatabaseManager::getMBREntries(int limit, const QSqlDatabase &conn) {
     QString sql = "SELECT * FROM mbr_entries ORDER BY id ASC";
     if (limit > 0) {
         sql = QString("SELECT * FROM (SELECT * FROM mbr_entries ORDER BY id DESC LIMIT %1) ORDER BY id ASC").arg(limit);
     }
-    return QSqlQuery(sql, db);
+    return QSqlQuery(sql, pick(conn));
 }
 
 bool DatabaseManager::deleteMBREntry(int id) {
-    QSqlQuery query(db);
-    query.prepare("DELETE FROM mbr_entries WHERE id = ?");
-    query.addBindValue(id);
-    return query.exec();
+    // The entry after the deleted one chained onto its signature
+    return deleteSignedRow(RowSignature::MBR, id);
 }
 
 // =========================================================
@@ -369,10 +1715,37 @@ bool DatabaseManager::createBackup(const QString &title, const QString &descript
     return metaQ.exec();
 }
 
+// Opens a backup read-only (ReadOnlyArchive) and checks it is a sound AIR
+// database before anything is swapped out for it
+static bool archiveIsSound(const QString &path) {
+    const QString name = "AIR_archive_check";
+    bool ok = false;
+    {
+        QSqlDatabase archive = QSqlDatabase::addDatabase("QSQLITE", name);
+        archive.setDatabaseName(path);
+        archive.setConnectOptions(StorageProfile::connectOptions(StorageProfile::ReadOnlyArchive));
+        if (archive.open()) {
+            StorageProfile::apply(archive, StorageProfile::ReadOnlyArchive);
+            QSqlQuery q(archive);
+            ok = q.exec("PRAGMA quick_check") && q.next() && q.value(0).toString() == "ok";
+            if (ok) {
+                ok = q.exec("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name IN ('batches', 'history')")
+                     && q.next() && q.value(0).toInt() == 2;
+            }
+            if (!ok) qWarning() << "Backup" << path << "is not a sound AIR database";
+            q.finish();
+            archive.close();
+        } else {
+            qWarning() << "Cannot open backup" << path << ":" << archive.lastError().text();
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    return ok;
+}
+
 bool DatabaseManager::restoreBackup(int backupId) {
-    QSqlQuery q;
-    q.prepare("SELECT filename FROM backups WHERE id = ?");
-    q.addBindValue(backupId);
+    QSqlQuery &q = cachedQuery("SELECT filename FROM backups WHERE id = ?");
+    q.bindValue(0, backupId);
     if(!q.exec() || !q.next()) return false;
     
     QString filename = q.value(0).toString();
@@ -380,46 +1753,58 @@ bool DatabaseManager::restoreBackup(int backupId) {
     QString backupPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/AIR_Backups/" + filename;
     QString currentDb = db.databaseName();
 
-    if(!QFile::exists(backupPath)) return false;
+    if(!QFile::exists(backupPath) || !archiveIsSound(backupPath)) return false;
 
+    beginConnectionChange();
+    // Fold the WAL back into the main file so the .old copy is complete
+    QSqlQuery(db).exec("PRAGMA wal_checkpoint(TRUNCATE)");
     db.close();
 
     QFile::remove(currentDb + ".old");
     QFile::rename(currentDb, currentDb + ".old"); 
+    // A leftover WAL/SHM pair would be replayed onto the restored file
+    QFile::remove(currentDb + "-wal");
+    QFile::remove(currentDb + "-shm");
 
     if(QFile::copy(backupPath, currentDb)) {
-        db.open();
+        if (db.open()) StorageProfile::apply(db, activeProfile);
+        ConnectionPool::instance().setTarget(db, activeProfile);
+        // Backups taken before a schema change need catching up, and may
+        // predate indexes the current queries rely on
+        migrateSchema();
+        ensureIndexes();
         return true;
     } else {
         QFile::rename(currentDb + ".old", currentDb);
-        db.open();
+        if (db.open()) StorageProfile::apply(db, activeProfile);
+        ConnectionPool::instance().setTarget(db, activeProfile);
         return false;
     }
 }
 
 // --- THIS WAS THE MISSING FUNCTION! ---
-QSqlQuery DatabaseManager::getBackups() {
-    return QSqlQuery("SELECT * FROM backups ORDER BY created_date DESC");
+QSqlQuery DatabaseManager::getBackups(const QSqlDatabase &conn) {
+    return QSqlQuery("SELECT * FROM backups ORDER BY created_date DESC", pick(conn));
 }
 // --------------------------------------
 
 bool DatabaseManager::deleteBackup(int backupId) {
-    QSqlQuery q;
-    q.prepare("SELECT filename FROM backups WHERE id = ?");
-    q.addBindValue(backupId);
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlQuery &q = cachedQuery("SELECT filename FROM backups WHERE id = ?");
+    q.bindValue(0, backupId);
     if(q.exec() && q.next()) {
         // Delete backups safely from the Documents folder
         QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/AIR_Backups/" + q.value(0).toString();
         QFile::remove(path);
     }
     
-    QSqlQuery del;
-    del.prepare("DELETE FROM backups WHERE id = ?");
-    del.addBindValue(backupId);
+    QSqlQuery &del = cachedQuery("DELETE FROM backups WHERE id = ?");
+    del.bindValue(0, backupId);
     return del.exec();
 }
 
 void DatabaseManager::connectToScenario(const QString &scenarioName) {
+    beginConnectionChange();
     if (db.isOpen()) {
         db.close();
     }
@@ -435,10 +1820,14 @@ void DatabaseManager::connectToScenario(const QString &scenarioName) {
     
     // 2. Connect to the new empty database
     db.setDatabaseName(sessionPath);
+    db.setConnectOptions(StorageProfile::connectOptions(StorageProfile::Training));
     if (!db.open()) {
         qCritical() << "Error: connection with scenario database failed:" << db.lastError().text();
         return;
     } 
+    activeProfile = StorageProfile::Training;
+    StorageProfile::apply(db, activeProfile);
+    ConnectionPool::instance().setTarget(db, activeProfile);
 
     qDebug() << "Connected to Training Session:" << sessionPath;
     
@@ -470,14 +1859,14 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
         // ----------------------------------------------------------------
         // 1. Establish a baseline so the ledger isn't empty
         QMap<QString, QVariant> ledger1;
-        ledger1["date"] = QDate::currentDate().addDays(-10).toString("yyMMdd");
+        ledger1["date"] = QDate::currentDate().addDays(-10).toString("yyyy-MM-dd");
         ledger1["ref"] = "PIL-START"; ledger1["code"] = "PB"; ledger1["type"] = "PIL (Set Balance)";
         ledger1["u_weight"] = 10000.0; ledger1["u235_weight"] = 300.0; ledger1["items"] = 5;
         addManualLedgerEntry(ledger1);
 
         // 2. The disputed Receipt (BOOK INVENTORY says 500g)
         QMap<QString, QVariant> ledger2;
-        ledger2["date"] = QDate::currentDate().addDays(-2).toString("yyMMdd");
+        ledger2["date"] = QDate::currentDate().addDays(-2).toString("yyyy-MM-dd");
         ledger2["ref"] = "ICD-SRD-01"; ledger2["code"] = "RF"; ledger2["type"] = "Receipt";
         ledger2["u_weight"] = 500.0; ledger2["u235_weight"] = 25.0; ledger2["items"] = 1;
         addManualLedgerEntry(ledger2);
@@ -501,17 +1890,17 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
         // ----------------------------------------------------------------
         // 1. BOOK INVENTORY HISTORY: (15,000 + 5,000 - 4,000 = 16,000g Expected Balance)
         QMap<QString, QVariant> l1;
-        l1["date"] = "260101"; l1["ref"] = "PIL-01"; l1["code"] = "PB"; 
+        l1["date"] = "2026-01-01"; l1["ref"] = "PIL-01"; l1["code"] = "PB"; 
         l1["type"] = "PIL (Set Balance)"; l1["u_weight"] = 15000.0; l1["u235_weight"] = 500.0; l1["items"] = 3;
         addManualLedgerEntry(l1);
 
         QMap<QString, QVariant> l2;
-        l2["date"] = "260215"; l2["ref"] = "ICD-102"; l2["code"] = "RD"; 
+        l2["date"] = "2026-02-15"; l2["ref"] = "ICD-102"; l2["code"] = "RD"; 
         l2["type"] = "Receipt"; l2["u_weight"] = 5000.0; l2["u235_weight"] = 150.0; l2["items"] = 1;
         addManualLedgerEntry(l2);
 
         QMap<QString, QVariant> l3;
-        l3["date"] = "260310"; l3["ref"] = "SHIP-05"; l3["code"] = "SD"; 
+        l3["date"] = "2026-03-10"; l3["ref"] = "SHIP-05"; l3["code"] = "SD"; 
         l3["type"] = "Shipment"; l3["u_weight"] = 4000.0; l3["u235_weight"] = 120.0; l3["items"] = 1;
         addManualLedgerEntry(l3);
 
@@ -536,12 +1925,12 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
         // ----------------------------------------------------------------
         // BOOK INVENTORY: Expected Balance = 75,000g U.
         QMap<QString, QVariant> l1;
-        l1["date"] = "260101"; l1["ref"] = "PIL-01"; l1["code"] = "PB"; 
+        l1["date"] = "2026-01-01"; l1["ref"] = "PIL-01"; l1["code"] = "PB"; 
         l1["type"] = "PIL (Set Balance)"; l1["u_weight"] = 100000.0; l1["u235_weight"] = 2000.0; l1["items"] = 4;
         addManualLedgerEntry(l1);
 
         QMap<QString, QVariant> l2;
-        l2["date"] = "260215"; l2["ref"] = "SHIP-01"; l2["code"] = "SD"; 
+        l2["date"] = "2026-02-15"; l2["ref"] = "SHIP-01"; l2["code"] = "SD"; 
         l2["type"] = "Shipment"; l2["u_weight"] = 25000.0; l2["u235_weight"] = 500.0; l2["items"] = 1;
         addManualLedgerEntry(l2);
 
@@ -572,13 +1961,13 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
         
         // Initial Balance
         QMap<QString, QVariant> bal;
-        bal["date"] = "250101"; bal["ref"] = "PIL-START"; bal["code"] = "PB"; 
+        bal["date"] = "2025-01-01"; bal["ref"] = "PIL-START"; bal["code"] = "PB"; 
         bal["type"] = "PIL (Set Balance)"; bal["u_weight"] = 50000.0; bal["u235_weight"] = 1000.0; bal["items"] = 50;
         addManualLedgerEntry(bal);
 
         // Inject 5 biased receipts
         for(int i=1; i<=5; i++) {
-            QString dateStr = QString("250%1%2").arg(i+1).arg("15"); // e.g., 250215, 250315...
+            QString dateStr = QString("2025-%1-15").arg(i + 1, 2, 10, QChar('0')); // e.g., 2025-02-15, 2025-03-15...
             
             // Ledger claims 1000g received
             QMap<QString, QVariant> rec;
@@ -601,7 +1990,7 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
         
         // 1. Valid PIL Baseline
         QMap<QString, QVariant> bal;
-        bal["date"] = "260101"; bal["ref"] = "PIL-START"; bal["code"] = "PB"; 
+        bal["date"] = "2026-01-01"; bal["ref"] = "PIL-START"; bal["code"] = "PB"; 
         bal["type"] = "PIL (Set Balance)"; bal["u_weight"] = 10000.0; bal["u235_weight"] = 200.0; bal["items"] = 2;
         addManualLedgerEntry(bal);
         
@@ -609,11 +1998,13 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
         // They tried to add a fake shipment to explain the missing material, but couldn't fake the SHA-256 hash.
         QSqlQuery query(db);
         query.prepare("INSERT INTO manual_ledger (date, ref, code, type, u_weight, u235_weight, items, signature) "
-                      "VALUES ('260220', 'FAKE-SHIP-01', 'SD', 'Shipment', 5000.0, 100.0, 1, 'INVALID_HACKER_SIGNATURE')");
+                      "VALUES ('2026-02-20', 'FAKE-SHIP-01', 'SD', 'Shipment', 5000000, 100000, 1, 'INVALID_HACKER_SIGNATURE')");
         query.exec();
+        // The forged line still moves the book balance, as it would in a replay
+        updateLedgerBalancesFrom(query.lastInsertId().toLongLong());
 
         query.prepare("INSERT INTO mbr_entries (continuation, entry_name, element, weight, unit, fissile, isotope, report_no, signature) "
-                      "VALUES ('', 'PB', 'E', 4500.0, 'G', 90.0, 'G', '1', 'BROKEN_HASH')");
+                      "VALUES ('', 'PB', 'E', 4500000, 'G', 90000, 'G', '1', 'BROKEN_HASH')");
         query.exec();
 
         // 3. Physical Inventory: The dummy item.
@@ -625,6 +2016,7 @@ void DatabaseManager::injectScenarioData(const QString &scenarioName) {
 }
 
 void DatabaseManager::resetToRealDatabase() {
+    beginConnectionChange();
     if (db.isOpen()) {
         db.close();
     }
@@ -633,43 +2025,86 @@ void DatabaseManager::resetToRealDatabase() {
     QString realDbPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/air_inventory.db"; 
     db.setDatabaseName(realDbPath);
     // -----------------------------------------------------------------
+    db.setConnectOptions(StorageProfile::connectOptions(StorageProfile::Operational));
     
     if (!db.open()) {
         qCritical() << "Error: Could not reconnect to real database:" << db.lastError().text();
     } else {
+        activeProfile = StorageProfile::Operational;
+        StorageProfile::apply(db, activeProfile);
+        ConnectionPool::instance().setTarget(db, activeProfile);
         qDebug() << "Successfully reconnected to Real Database:" << realDbPath;
     }
 }
 
+// Called before the main connection is closed or repointed: drops cached
+// statements, marks every pooled connection stale and makes the async
+// reader let go of the file right away.
+void DatabaseManager::beginConnectionChange() {
+    ConnectionPool::instance().invalidate();
+    AsyncQuery::releaseConnection();
+    ReportJobQueue::releaseConnections(); // running exports are cancelled
+    IntegrityVerifier::releaseConnections(); // and running sweeps
+}
+
+quint64 DatabaseManager::connectionGeneration() const {
+    return ConnectionPool::instance().generation();
+}
+
+QSqlDatabase DatabaseManager::pick(const QSqlDatabase &conn) const {
+    return conn.isValid() ? conn : ConnectionPool::instance().reader();
+}
+
 QString DatabaseManager::currentDatabaseName() const {
     return db.databaseName();
 }
 
+StorageProfile::Role DatabaseManager::storageProfile() const {
+    return activeProfile;
+}
+
+QString DatabaseManager::storageProfileSummary() const {
+    return StorageProfile::name(activeProfile) + " (" + StorageProfile::describe(db).join(", ") + ")";
+}
+
 // ... [DELETE FUNCTIONS REMAIN THE SAME] ...
 bool DatabaseManager::deleteReceipt(int id) {
-    QSqlQuery query(db);
-    query.prepare("DELETE FROM history WHERE id = ?");
-    query.addBindValue(id);
-    return query.exec();
+    return deleteSignedRow(RowSignature::History, id);
 }
 
 bool DatabaseManager::deleteManualLedgerEntry(int id) {
-    QSqlQuery query(db);
-    query.prepare("DELETE FROM manual_ledger WHERE id = ?");
-    query.addBindValue(id);
-    return query.exec();
+    QMutexLocker lock(&ConnectionPool::instance().writeLock());
+    QSqlDatabase conn = ConnectionPool::instance().writer();
+    if (!conn.transaction()) return false;
+
+    QSqlQuery &sig = cachedQuery("SELECT signature FROM manual_ledger WHERE id = ?");
+    sig.bindValue(0, id);
+    if (!sig.exec() || !sig.next()) {
+        // No such line: nothing to rebalance, rechain or rebuild
+        conn.rollback();
+        return false;
+    }
+    const QString deletedSig = sig.value(0).toString();
+    sig.finish();
+
+    // Lines after the deleted one carry a stale running balance and chain
+    // onto a signature that no longer exists
+    QSqlQuery &query = cachedQuery("DELETE FROM manual_ledger WHERE id = ?");
+    query.bindValue(0, id);
+    if (query.exec() && updateLedgerBalancesFrom(id)
+        && rechainSignaturesFrom(RowSignature::Ledger, id, deletedSig)
+        && MerkleIndex::rebuildFrom(conn, RowSignature::Ledger, id) && conn.commit()) {
+        LedgerCache::instance().invalidateFrom(id);
+        return true;
+    }
+    conn.rollback();
+    return false;
 }
 
 bool DatabaseManager::deleteLIIEntry(int id) {
-    QSqlQuery query(db);
-    query.prepare("DELETE FROM lii_manual WHERE id = ?");
-    query.addBindValue(id);
-    return query.exec();
+    return deleteSignedRow(RowSignature::LII, id);
 }
 
 bool DatabaseManager::deleteNLIEntry(int id) {
-    QSqlQuery query(db);
-    query.prepare("DELETE FROM nli_manual WHERE id = ?");
-    query.addBindValue(id);
-    return query.exec();
+    return deleteSignedRow(RowSignature::NLI, id);
 }
@@ -6,51 +6,121 @@
 #include <QSqlError>
 #include <QVariant>
 #include <QMap>
+#include <QHash>
 #include <QList>
 #include <QDebug>
 #include <QStringList>
+#include <QSet>
+#include "StorageProfile.h"
+#include "RowSignature.h"
+#include "LedgerBalanceEngine.h"
+
+// Outcome of one row of a batch insert
+struct RowResult {
+    bool ok = false;
+    qint64 id = 0;   // rowid of the inserted row when ok
+    QString error;   // validation or SQL error otherwise
+};
+
+// A row as it stands right after a write, in the column layout of the
+// listing that shows it (signature and running balance included), so a
+// view can show it without reading the table back. id is 0 if the row
+// could not be read back.
+struct WrittenRow {
+    qint64 id = 0;
+    QVariantMap values; // column name -> value
+};
+
+// Keyset page of a listing: up to pageSize rows after (Forward) or before
+// (Backward) the row with id == afterId. afterId 0 starts at the first or
+// last row. Cost depends on pageSize only, not on the table size.
+struct PageRequest {
+    enum Direction { Forward, Backward };
+    qint64 afterId = 0;
+    int pageSize = 200;
+    Direction direction = Forward;
+};
+
+// Signature-chain state of one signed table (see RowSignature)
+struct IntegrityStatus {
+    qint64 verifiedUpTo = 0;  // watermark: rows up to this id have been checked
+    QSet<qint64> brokenIds;   // rows whose signature does not chain, as of now
+    int rowsChecked = 0;      // rows hashed by this call
+    bool fullCheck = false;   // this call re-verified from the first row
+    bool fullCheckDue = false; // an Incremental call found a full check needed; run one
+                               // in the background (IntegrityVerifier::scheduled())
+};
 
 class DatabaseManager {
 public:
     static DatabaseManager& instance();
-    bool connect();
+    // Default: air_inventory.db in Documents. `role` must be a writable one.
+    bool connect(const QString &path = QString(), StorageProfile::Role role = StorageProfile::Operational);
     
+    // Read accessors take an optional connection; by default they use the
+    // calling thread's pooled reader. Write methods use the calling thread's
+    // writer under the pool's write lock, so both are safe from worker
+    // threads. Connecting/switching/restoring stays on the GUI thread.
+    //
+    // Weights in the data maps passed in are grams; they are stored as whole
+    // milligrams, and rows read back carry milligrams (Mass::fromStored).
+
     // Manual Ledger
-    bool addManualLedgerEntry(const QMap<QString, QVariant> &data);
-    QSqlQuery getManualLedgerEntries();
+    bool addManualLedgerEntry(const QMap<QString, QVariant> &data, WrittenRow *written = nullptr);
+    QList<RowResult> addManualLedgerEntries(const QList<QMap<QString, QVariant>> &rows);
+    QSqlQuery getManualLedgerEntries(const QSqlDatabase &conn = QSqlDatabase());
+    QSqlQuery getManualLedgerPage(const PageRequest &page, const QSqlDatabase &conn = QSqlDatabase());
+    // Lines with id >= fromId, in LedgerCache's column order
+    QSqlQuery getManualLedgerFrom(qint64 fromId, const QSqlDatabase &conn = QSqlDatabase());
+    // Rows carry their running balance in bal_u / bal_u235 / bal_items.
+    // Running balance at the last line dated on or before `date` (yyyy-MM-dd):
+    // two index seeks plus a replay of at most one checkpoint interval.
+    LedgerBalance balanceAsOf(const QString &date, const QSqlDatabase &conn = QSqlDatabase());
     
     // Receipt
-    bool registerReceipt(const QMap<QString, QVariant> &data);
-    QSqlQuery getReceipts();
+    bool registerReceipt(const QMap<QString, QVariant> &data, WrittenRow *written = nullptr); // row as getReceiptsPage lists it
+    QSqlQuery getReceipts(const QSqlDatabase &conn = QSqlDatabase());
+    QSqlQuery getReceiptsPage(const PageRequest &page, const QSqlDatabase &conn = QSqlDatabase());
     // Backup / Restore
     bool createBackup(const QString &title, const QString &description);
     bool restoreBackup(int backupId);
-    QSqlQuery getBackups();
+    QSqlQuery getBackups(const QSqlDatabase &conn = QSqlDatabase());
     bool deleteBackup(int backupId);
 
     // --- Reporting ---
-    QSqlQuery getICRData(const QString &mba, const QString &startDate, const QString &endDate);
-    QSqlQuery getLIIData(const QString &mba, const QString &date);
+    QSqlQuery getICRData(const QString &mba, const QString &startDate, const QString &endDate,
+                         const QSqlDatabase &conn = QSqlDatabase());
+    QSqlQuery getLIIData(const QString &mba, const QString &date, const QSqlDatabase &conn = QSqlDatabase());
     
     // General Ledger
-    QSqlQuery getGeneralLedgerData(const QString &mba, const QString &elementFilter);
+    QSqlQuery getGeneralLedgerData(const QString &mba, const QString &elementFilter,
+                                   const QSqlDatabase &conn = QSqlDatabase());
     
     // LII Manual Entries
-    bool addLIIEntry(const QMap<QString, QVariant> &data);
-    QSqlQuery getLIIEntries();
+    bool addLIIEntry(const QMap<QString, QVariant> &data, WrittenRow *written = nullptr);
+    QList<RowResult> addLIIEntries(const QList<QMap<QString, QVariant>> &rows);
+    QSqlQuery getLIIEntries(const QSqlDatabase &conn = QSqlDatabase());
+    QSqlQuery getLIIEntriesPage(const PageRequest &page, const QSqlDatabase &conn = QSqlDatabase());
     
     // NLI Manual Entries
-    bool addNLIEntry(const QMap<QString, QVariant> &data);
-    QSqlQuery getNLIEntries();
+    bool addNLIEntry(const QMap<QString, QVariant> &data, WrittenRow *written = nullptr);
+    QList<RowResult> addNLIEntries(const QList<QMap<QString, QVariant>> &rows);
+    QSqlQuery getNLIEntries(const QSqlDatabase &conn = QSqlDatabase());
+    QSqlQuery getNLIEntriesPage(const PageRequest &page, const QSqlDatabase &conn = QSqlDatabase());
     
     // MBR (Material Balance Report)
-    bool addMBREntry(const QMap<QString, QVariant> &data);
-    QSqlQuery getMBREntries(int limit = 0); // 0 means all, >0 limits rows for Home screen
+    bool addMBREntry(const QMap<QString, QVariant> &data, WrittenRow *written = nullptr);
+    QList<RowResult> addMBREntries(const QList<QMap<QString, QVariant>> &rows);
+    QSqlQuery getMBREntries(int limit = 0, const QSqlDatabase &conn = QSqlDatabase()); // 0 means all, >0 limits rows for Home screen
+    QSqlQuery getMBREntriesPage(const PageRequest &page, const QSqlDatabase &conn = QSqlDatabase());
     
     // New functions for Training Mode
     void connectToScenario(const QString &scenarioName); // Connects to a specific scenario DB
     void resetToRealDatabase(); // Reconnects to the main operational DB
     QString currentDatabaseName() const; // Helper to see which DB is active
+    quint64 connectionGeneration() const; // Bumped whenever the active DB is closed/switched
+    StorageProfile::Role storageProfile() const;
+    QString storageProfileSummary() const; // e.g. "Operational (journal_mode=wal, ...)"
     void injectScenarioData(const QString &scenarioName); // <--- ADD THIS
     
     bool deleteReceipt(int id);
@@ -59,10 +129,83 @@ public:
     bool deleteManualLedgerEntry(int id);
     bool deleteMBREntry(int id);
 
+    // Tamper evidence. Incremental checks hash only rows added since the
+    // stored watermark and are cheap enough for the GUI thread; they never
+    // turn into a full check themselves. When one is due (none recorded
+    // yet, the last one a day old, or rows behind the watermark changed)
+    // the status says so and the caller hands it to IntegrityVerifier. A
+    // Full check re-hashes the whole chain here, on the calling thread.
+    enum VerifyMode { Incremental, Full };
+    IntegrityStatus verifySignatures(RowSignature::Table table, VerifyMode mode = Incremental);
+    // Stores the outcome of a complete external sweep (IntegrityVerifier)
+    // covering rows up to lastId as the table's latest full check
+    bool recordFullVerification(RowSignature::Table table, const QSet<qint64> &brokenIds,
+                                qint64 lastId, const QString &lastSig);
+
+    // Merkle index over the signed tables (see MerkleIndex). The root and
+    // leaf count are what gets published; an exported proof file lets a
+    // range of rows be checked against them with O(log n) hashes.
+    QByteArray integrityRoot(RowSignature::Table table, qint64 *leafCount = nullptr,
+                             const QSqlDatabase &conn = QSqlDatabase());
+    bool exportIntegrityProof(RowSignature::Table table, qint64 firstId, qint64 lastId, const QString &path);
+    bool verifyIntegrityProof(const QString &path, QString *detail = nullptr);
+
+    // Runs EXPLAIN QUERY PLAN over every query issued by this class and
+    // returns false if any of them scans a table or a whole index, or sorts
+    // in a temp B-tree. Deliberate whole-table listings (getLIIEntries, ...)
+    // may scan and reports returning all their rows (ICR, GL) may sort them.
+    // `AIR --audit-query-plans` runs it as a pass/fail check.
+    bool auditQueryPlans(QStringList *findings = nullptr);
+
 private:
     DatabaseManager() {} // Singleton
     void initTables();
+    void migrateSchema();
+    bool migrateLedgerBalances();
+    bool updateLedgerBalancesFrom(qint64 fromId);
+    bool migrateSignatureChains();
+    bool migrateMerkleIndex();
+    bool migrateBinaryRowCodec();
+    bool migrateReportTableSignatures();
+    bool migrateFixedPointMass();
+    bool migrateLedgerIsoDates();
+    QString lastSignature(RowSignature::Table table); // chain head, "" when empty
+    bool rechainSignaturesFrom(RowSignature::Table table, qint64 deletedId, const QString &deletedSig);
+    bool sealRow(RowSignature::Table table, qint64 id);
+    bool deleteSignedRow(RowSignature::Table table, qint64 id);
+    bool readWrittenRow(const QString &sql, qint64 id, WrittenRow *written); // on the writer
+    void beginConnectionChange();
+    QSqlDatabase pick(const QSqlDatabase &conn) const; // explicit connection, else this thread's reader
+    QSqlQuery pageQuery(const QString &base, const QString &idCol, bool hasWhere,
+                        const PageRequest &page, const QSqlDatabase &conn);
+    QSqlQuery pageQuery(const QString &windowSql, const PageRequest &page, const QSqlDatabase &conn);
+    void ensureIndexes();
+
+    // Batch inserts: every row is validated first, then all valid rows are
+    // written in a single transaction. Results are returned per row.
+    using RowValidator = QString (*)(const QMap<QString, QVariant> &);
+    using RowInserter = qint64 (DatabaseManager::*)(const QMap<QString, QVariant> &, QString *);
+    QList<RowResult> insertBatch(const QList<QMap<QString, QVariant>> &rows,
+                                 RowValidator validate, RowInserter insert);
+
+    static QString validateManualLedgerRow(const QMap<QString, QVariant> &data);
+    static QString validateLIIRow(const QMap<QString, QVariant> &data);
+    static QString validateNLIRow(const QMap<QString, QVariant> &data);
+    static QString validateMBRRow(const QMap<QString, QVariant> &data);
+
+    // Single-row writers shared by the add*Entry / add*Entries pairs.
+    // Return the new rowid, or 0 with *error set.
+    qint64 insertManualLedgerRow(const QMap<QString, QVariant> &data, QString *error);
+    qint64 insertLIIRow(const QMap<QString, QVariant> &data, QString *error);
+    qint64 insertNLIRow(const QMap<QString, QVariant> &data, QString *error);
+    qint64 insertMBRRow(const QMap<QString, QVariant> &data, QString *error);
+
+    // Prepared statement on the calling thread's writer (see ConnectionPool).
+    // Only used for statements whose result never leaves this class.
+    QSqlQuery &cachedQuery(const QString &sql);
+
     QSqlDatabase db;
+    StorageProfile::Role activeProfile = StorageProfile::Operational;
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,168 @@
+#include "IntegrityVerifier.h"
+#include "ConnectionPool.h"
+#include "DatabaseManager.h"
+#include <QCoreApplication>
+#include <QPointer>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QSqlError>
+#include <QThread>
+#include <QDebug>
+
+// Rows (by id span) per work item: small enough to spread over all cores
+// and keep progress moving, large enough that the per-range setup is noise
+static const qint64 RANGE_ROWS = 5000;
+
+// Every verifier alive, for releaseConnections(); GUI thread only
+static QSet<IntegrityVerifier *> s_verifiers;
+
+IntegrityVerifier::IntegrityVerifier(QObject *parent) : QObject(parent) {
+    workers.setMaxThreadCount(QThread::idealThreadCount());
+    s_verifiers.insert(this);
+}
+
+IntegrityVerifier::~IntegrityVerifier() {
+    s_verifiers.remove(this);
+    cancel();
+    workers.waitForDone();
+}
+
+IntegrityVerifier &IntegrityVerifier::scheduled() {
+    // Parented to the application so its ranges are joined before QCoreApplication goes away
+    static QPointer<IntegrityVerifier> instance;
+    if (!instance) instance = new IntegrityVerifier(QCoreApplication::instance());
+    return *instance;
+}
+
+void IntegrityVerifier::releaseConnections() {
+    for (IntegrityVerifier *v : std::as_const(s_verifiers)) {
+        v->cancel();
+        v->workers.waitForDone(); // each range releases its thread's connections as it ends
+    }
+}
+
+void IntegrityVerifier::start(const QList<RowSignature::Table> &tables) {
+    if (isRunning()) return;
+    cancelled = false;
+    rowsChecked = 0;
+    rowsTotal = 0;
+    sweeps.clear();
+    generation = DatabaseManager::instance().connectionGeneration();
+
+    // 1. Cut every table into id ranges
+    QList<Range> ranges;
+    QSqlDatabase conn = ConnectionPool::instance().reader();
+    for (RowSignature::Table table : tables) {
+        const QString name = RowSignature::tableName(table);
+        QSqlQuery q(conn);
+        if (!q.exec("SELECT MIN(id), MAX(id), COUNT(*) FROM " + name) || !q.next()) {
+            qWarning() << "IntegrityVerifier:" << name << q.lastError().text();
+            continue;
+        }
+        const qint64 minId = q.value(0).toLongLong();
+        const qint64 maxId = q.value(1).toLongLong();
+        rowsTotal += q.value(2).toLongLong();
+
+        Sweep &sweep = sweeps[table];
+        sweep.lastId = maxId;
+        q.prepare("SELECT signature FROM " + name + " WHERE id = ?");
+        q.bindValue(0, maxId);
+        if (q.exec() && q.next()) sweep.lastSig = q.value(0).toString();
+
+        for (qint64 first = minId; maxId > 0 && first <= maxId; first += RANGE_ROWS)
+            ranges << Range { table, first, qMin(first + RANGE_ROWS - 1, maxId) };
+    }
+
+    emit progress(0, rowsTotal);
+    if (ranges.isEmpty()) {
+        emit finished(false);
+        return;
+    }
+
+    // 2. Fan out
+    pending = ranges.size();
+    for (const Range &range : ranges)
+        workers.start([this, range]() { verifyRange(range); });
+}
+
+void IntegrityVerifier::cancel() {
+    // Queued ranges still run, see the flag and report back empty, so
+    // finished() is always emitted once
+    cancelled = true;
+}
+
+void IntegrityVerifier::verifyRange(const Range &range) {
+    QList<IntegrityFinding> findings;
+    int rows = 0;
+
+    if (!cancelled) {
+        QSqlDatabase conn = ConnectionPool::instance().reader();
+        const QString name = RowSignature::tableName(range.table);
+
+        // One read transaction: the anchor and the range come from the same
+        // snapshot, so a delete that re-chains the rows after it
+        // (rechainSignaturesFrom) cannot land in between and show as tampering
+        conn.transaction();
+
+        // 1. The row in front of the range anchors its chain
+        QByteArray prevSig;
+        QSqlQuery prev(conn);
+        prev.prepare("SELECT signature FROM " + name + " WHERE id < ? ORDER BY id DESC LIMIT 1");
+        prev.bindValue(0, range.firstId);
+        if (prev.exec() && prev.next()) prevSig = prev.value(0).toString().toLatin1();
+
+        // 2. Hash forward
+        QSqlQuery q(conn);
+        q.setForwardOnly(true);
+        q.prepare("SELECT * FROM " + name + " WHERE id BETWEEN ? AND ? ORDER BY id ASC");
+        q.bindValue(0, range.firstId);
+        q.bindValue(1, range.lastId);
+        if (q.exec()) {
+            RowSignature::Hasher hasher(range.table);
+            hasher.bind(q);
+            const int idCol = q.record().indexOf("id");
+            const int sigCol = q.record().indexOf("signature");
+            while (q.next() && !cancelled) {
+                const QByteArray stored = q.value(sigCol).toString().toLatin1();
+                const qint64 id = q.value(idCol).toLongLong();
+                if (stored.isEmpty())
+                    findings << IntegrityFinding { range.table, id, IntegrityFinding::Unsigned };
+                else if (stored != hasher.sign(prevSig, q))
+                    findings << IntegrityFinding { range.table, id, IntegrityFinding::Tampered };
+                prevSig = stored;
+                ++rows;
+            }
+        } else {
+            qWarning() << "IntegrityVerifier:" << name << q.lastError().text();
+        }
+        prev.finish();
+        q.finish();
+        conn.rollback(); // nothing was written; ends the snapshot
+    }
+    // Idle pool threads must not keep the file open (see releaseConnections)
+    ConnectionPool::instance().releaseThread();
+
+    QMetaObject::invokeMethod(this, [this, range, findings, rows]() {
+        rangeDone(range, findings, rows);
+    }, Qt::QueuedConnection);
+}
+
+void IntegrityVerifier::rangeDone(const Range &range, const QList<IntegrityFinding> &findings, int rows) {
+    Sweep &sweep = sweeps[range.table];
+    for (const IntegrityFinding &f : findings) sweep.broken.insert(f.id);
+    rowsChecked += rows;
+
+    if (!findings.isEmpty()) emit findingsReady(findings);
+    emit progress(rowsChecked, rowsTotal);
+
+    if (--pending > 0) return;
+
+    // A complete sweep of an unchanged database becomes the new baseline
+    if (!cancelled && generation == DatabaseManager::instance().connectionGeneration()) {
+        for (auto it = sweeps.constBegin(); it != sweeps.constEnd(); ++it) {
+            DatabaseManager::instance().recordFullVerification(
+                RowSignature::Table(it.key()), it->broken, it->lastId, it->lastSig);
+        }
+    }
+    emit finished(cancelled);
+}
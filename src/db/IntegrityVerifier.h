@@ -0,0 +1,77 @@
+#ifndef INTEGRITYVERIFIER_H
+#define INTEGRITYVERIFIER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <atomic>
+#include "RowSignature.h"
+
+// A row that failed verification
+struct IntegrityFinding {
+    enum Status { Tampered, Unsigned };
+    RowSignature::Table table;
+    qint64 id;
+    Status status;
+};
+
+// Full re-verification of the signed tables on every core.
+//
+// Each table is cut into id ranges. Because a row only has to chain onto
+// its predecessor's *stored* signature, ranges are independent: a worker
+// reads the signature just before its range and hashes forward on its own
+// pooled reader with its own RowSignature::Hasher. Findings are streamed
+// back per range on the thread that called start(). A sweep that completes
+// is recorded as the table's full check (DatabaseManager::recordFullVerification).
+class IntegrityVerifier : public QObject {
+    Q_OBJECT
+
+public:
+    explicit IntegrityVerifier(QObject *parent = nullptr);
+    ~IntegrityVerifier();
+
+    // The application's verifier for full checks that come due on their
+    // own (IntegrityStatus::fullCheckDue): started by whichever view sees
+    // one due first; views re-read their tamper flags on its finished()
+    static IntegrityVerifier &scheduled();
+
+    void start(const QList<RowSignature::Table> &tables);
+    void cancel();
+    bool isRunning() const { return pending > 0; }
+
+    // Cancels every verifier and waits until none of their ranges holds a
+    // connection, so the main file can be closed, replaced or deleted
+    static void releaseConnections();
+
+signals:
+    void findingsReady(const QList<IntegrityFinding> &findings);
+    void progress(qint64 rowsChecked, qint64 rowsTotal);
+    void finished(bool cancelled);
+
+private:
+    struct Range {
+        RowSignature::Table table;
+        qint64 firstId;
+        qint64 lastId;
+    };
+    struct Sweep {
+        QSet<qint64> broken;
+        qint64 lastId = 0;  // last row when the sweep started
+        QString lastSig;
+    };
+
+    void verifyRange(const Range &range); // on a pool thread
+    void rangeDone(const Range &range, const QList<IntegrityFinding> &findings, int rows);
+
+    QThreadPool workers;
+    std::atomic<bool> cancelled { false };
+    int pending = 0;
+    qint64 rowsChecked = 0;
+    qint64 rowsTotal = 0;
+    quint64 generation = 0; // DatabaseManager::connectionGeneration() at start
+    QHash<int, Sweep> sweeps;
+};
+
+#endif // INTEGRITYVERIFIER_H
@@ -0,0 +1,64 @@
+#include "LedgerBalanceEngine.h"
+
+LedgerBalanceEngine::Type LedgerBalanceEngine::typeOf(const QString &text) {
+    if (text == "PIL (Set Balance)") return PIL;
+    if (text == "Receipt")           return Receipt;
+    if (text == "Shipment")          return Shipment;
+    if (text == "Other Increase")    return OtherIncrease;
+    if (text == "Other Decrease")    return OtherDecrease;
+    if (text == "Nuclear Loss")      return NuclearLoss;
+    return Unknown;
+}
+
+QString LedgerBalanceEngine::typeName(Type type) {
+    switch (type) {
+    case PIL:           return "PIL (Set Balance)";
+    case Receipt:       return "Receipt";
+    case Shipment:      return "Shipment";
+    case OtherIncrease: return "Other Increase";
+    case OtherDecrease: return "Other Decrease";
+    case NuclearLoss:   return "Nuclear Loss";
+    case Unknown:       break;
+    }
+    return QString();
+}
+
+LedgerBalanceEngine::Column LedgerBalanceEngine::columnOf(Type type) {
+    switch (type) {
+    case Receipt:       return Receipts;
+    case OtherIncrease: return OtherIncreases;
+    case Shipment:      return Shipments;
+    case OtherDecrease:
+    case NuclearLoss:   return OtherDecreases;
+    case PIL:
+    case Unknown:       break;
+    }
+    return NoColumn;
+}
+
+void LedgerBalanceEngine::apply(qint64 id, Type type, Mass u, Mass u235, int items) {
+    switch (type) {
+    case Receipt:       bal.u += u; bal.u235 += u235; bal.items += items; break;
+    case Shipment:      bal.u -= u; bal.u235 -= u235; bal.items -= items; break;
+    case OtherIncrease: bal.u += u; bal.u235 += u235; break;
+    case OtherDecrease:
+    case NuclearLoss:   bal.u -= u; bal.u235 -= u235; break;
+    case PIL:
+        // No line before this one: the PIL is the opening balance
+        if (bal.ledgerId == 0 && bal.u == Mass()) { bal.u = u; bal.u235 = u235; bal.items = items; }
+        break;
+    case Unknown:       break;
+    }
+    bal.ledgerId = id;
+}
+
+void LedgerBalanceEngine::run(int n, const qint64 *ids, const Type *types, const Mass *u,
+                              const Mass *u235, const int *items,
+                              Mass *balU, Mass *balU235, int *balItems) {
+    for (int i = 0; i < n; ++i) {
+        apply(ids[i], types[i], u[i], u235[i], items[i]);
+        balU[i] = bal.u;
+        balU235[i] = bal.u235;
+        balItems[i] = bal.items;
+    }
+}
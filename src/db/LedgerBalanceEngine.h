@@ -0,0 +1,52 @@
+#ifndef LEDGERBALANCEENGINE_H
+#define LEDGERBALANCEENGINE_H
+
+#include <QString>
+#include <QtGlobal>
+#include "Mass.h"
+
+// Running General Ledger balance after line `ledgerId` (0 = empty ledger)
+struct LedgerBalance {
+    Mass u;
+    Mass u235;
+    int items = 0;
+    qint64 ledgerId = 0;
+};
+
+// The General Ledger rules, once: which transaction types move which
+// balance, and in which report column a line is listed. Type strings are
+// mapped to the enum when lines are loaded, so the arithmetic itself never
+// compares strings. Stored balances (DatabaseManager), the ledger views and
+// the GL report all go through here.
+//
+// Lines are applied one at a time (apply) or a whole run of columnar lines
+// at once (run). Only the first line of the ledger may be a PIL, which sets
+// the opening balance. Weights are whole milligrams, so a balance is the
+// exact sum of its lines.
+class LedgerBalanceEngine {
+public:
+    enum Type : quint8 { PIL, Receipt, Shipment, OtherIncrease, OtherDecrease, NuclearLoss, Unknown };
+    static Type typeOf(const QString &text); // "PIL (Set Balance)", "Receipt", ...
+    static QString typeName(Type type);
+
+    // U / U-235 column pair of the GL report listing a line's weights
+    enum Column { NoColumn, Receipts, OtherIncreases, Shipments, OtherDecreases };
+    static Column columnOf(Type type);
+    // Receipts and shipments move whole items; their count is listed
+    static bool movesItems(Type type) { return type == Receipt || type == Shipment; }
+
+    explicit LedgerBalanceEngine(const LedgerBalance &start = LedgerBalance()) : bal(start) {}
+
+    void apply(qint64 id, Type type, Mass u, Mass u235, int items);
+    const LedgerBalance &balance() const { return bal; }
+
+    // Applies n lines given column by column and writes the balance after
+    // each one to balU / balU235 / balItems (n entries each)
+    void run(int n, const qint64 *ids, const Type *types, const Mass *u, const Mass *u235,
+             const int *items, Mass *balU, Mass *balU235, int *balItems);
+
+private:
+    LedgerBalance bal;
+};
+
+#endif // LEDGERBALANCEENGINE_H
@@ -0,0 +1,144 @@
+#include "LedgerCache.h"
+#include "DatabaseManager.h"
+#include "AsyncQuery.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+
+LedgerCache &LedgerCache::instance() {
+    // Writers on worker threads may be the first to touch the cache
+    static LedgerCache *cache = [] {
+        LedgerCache *c = new LedgerCache;
+        if (QCoreApplication::instance()) c->moveToThread(QCoreApplication::instance()->thread());
+        return c;
+    }();
+    return *cache;
+}
+
+void LedgerCache::ensureLoaded() {
+    const quint64 current = DatabaseManager::instance().connectionGeneration();
+    if (loaded && generation == current) return;
+
+    // First use, or another database is open now: start over
+    loaded = true;
+    generation = current;
+    truncate(0);
+    {
+        QMutexLocker lock(&mutex);
+        dirtyFrom = 0;
+        written.clear();
+    }
+    sync();
+    emit rowsChanged(0);
+}
+
+void LedgerCache::invalidateFrom(qint64 fromId) {
+    QMutexLocker lock(&mutex);
+    dirtyFrom = dirtyFrom < 0 ? fromId : qMin(dirtyFrom, fromId);
+    if (syncQueued) return;
+    syncQueued = true;
+    QMetaObject::invokeMethod(this, [this]() { sync(); }, Qt::QueuedConnection);
+}
+
+void LedgerCache::appendWritten(const WrittenRow &line) {
+    QMutexLocker lock(&mutex);
+    written << line;
+    if (syncQueued) return;
+    syncQueued = true;
+    QMetaObject::invokeMethod(this, [this]() { sync(); }, Qt::QueuedConnection);
+}
+
+int LedgerCache::rowOf(qint64 id) const {
+    auto it = std::lower_bound(ids.cbegin(), ids.cend(), id);
+    return it != ids.cend() && *it == id ? int(it - ids.cbegin()) : -1;
+}
+
+void LedgerCache::sync() {
+    qint64 from;
+    QList<WrittenRow> lines;
+    {
+        QMutexLocker lock(&mutex);
+        syncQueued = false;
+        from = dirtyFrom;
+        dirtyFrom = -1;
+        lines.swap(written);
+    }
+    // Nothing to patch until a view has asked for the ledger
+    if (!loaded) return;
+    if (generation != DatabaseManager::instance().connectionGeneration()) {
+        ensureLoaded();
+        return;
+    }
+
+    // Lines that extend the cached ledger are appended as written; anything
+    // else (a read in flight, an earlier line changed) goes through a re-read
+    if (from < 0 && inFlightFrom < 0) {
+        const int first = ids.size();
+        while (!lines.isEmpty() && (ids.isEmpty() || lines.first().id > ids.last()))
+            append(lines.takeFirst().values);
+        if (ids.size() > first) emit rowsChanged(first);
+    }
+    for (const WrittenRow &line : lines) from = from < 0 ? line.id : qMin(from, line.id);
+    if (from < 0) return;
+
+    // A read still in flight is superseded by this one, so cover its range too
+    if (inFlightFrom >= 0) from = qMin(from, inFlightFrom);
+    inFlightFrom = from;
+    AsyncQuery::instance().submit(this, "sync",
+        [from](const QSqlDatabase &conn) { return DatabaseManager::instance().getManualLedgerFrom(from, conn); },
+        [this, from](QueryResult rows) { apply(rows, from); });
+}
+
+void LedgerCache::apply(QueryResult &rows, qint64 fromId) {
+    inFlightFrom = -1;
+    if (!rows.isOk()) {
+        qWarning() << "LedgerCache: could not read the ledger:" << rows.lastError();
+        return;
+    }
+
+    // Rows from the first cached id >= fromId are replaced by what was read
+    const int first = int(std::lower_bound(ids.cbegin(), ids.cend(), fromId) - ids.cbegin());
+    truncate(first);
+
+    const int n = first + rows.size();
+    ids.reserve(n); dates.reserve(n); refs.reserve(n); codes.reserve(n); types.reserve(n);
+    us.reserve(n); u235s.reserve(n); itemCounts.reserve(n);
+    balUs.reserve(n); balU235s.reserve(n); balItemCounts.reserve(n);
+
+    // Column order of getManualLedgerFrom()
+    while (rows.next()) {
+        ids           << rows.value(0).toLongLong();
+        dates         << rows.value(1).toString();
+        refs          << rows.value(2).toString();
+        codes         << rows.value(3).toString();
+        types         << LedgerBalanceEngine::typeOf(rows.value(4).toString());
+        us            << Mass::fromStored(rows.value(5));
+        u235s         << Mass::fromStored(rows.value(6));
+        itemCounts    << rows.value(7).toInt();
+        balUs         << Mass::fromStored(rows.value(8));
+        balU235s      << Mass::fromStored(rows.value(9));
+        balItemCounts << rows.value(10).toInt();
+    }
+    emit rowsChanged(first);
+}
+
+void LedgerCache::append(const QVariantMap &line) {
+    ids           << line.value("id").toLongLong();
+    dates         << line.value("date").toString();
+    refs          << line.value("ref").toString();
+    codes         << line.value("code").toString();
+    types         << LedgerBalanceEngine::typeOf(line.value("type").toString());
+    us            << Mass::fromStored(line.value("u_weight"));
+    u235s         << Mass::fromStored(line.value("u235_weight"));
+    itemCounts    << line.value("items").toInt();
+    balUs         << Mass::fromStored(line.value("bal_u"));
+    balU235s      << Mass::fromStored(line.value("bal_u235"));
+    balItemCounts << line.value("bal_items").toInt();
+}
+
+void LedgerCache::truncate(int row) {
+    ids.resize(row); dates.resize(row); refs.resize(row); codes.resize(row); types.resize(row);
+    us.resize(row); u235s.resize(row); itemCounts.resize(row);
+    balUs.resize(row); balU235s.resize(row); balItemCounts.resize(row);
+}
@@ -0,0 +1,87 @@
+#ifndef LEDGERCACHE_H
+#define LEDGERCACHE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QList>
+#include "DatabaseManager.h"
+
+class QueryResult;
+
+// The General Ledger held once in memory for every view that shows it
+// (Home preview, General Ledger).
+//
+// Lines are stored column by column - one contiguous vector per field, the
+// type as a one-byte enum, weights as whole milligrams - rather than as a
+// row of QVariants or table items per line. The first ensureLoaded() after a connection change reads
+// the whole ledger off the GUI thread; after that, ledger writes report the
+// first id they touched (invalidateFrom) and only that suffix is re-read,
+// e.g. the re-balanced tail after a delete. A line just appended is handed
+// over as written (appendWritten) and costs no read at all.
+// rowsChanged(firstRow) then tells views which rows to redraw.
+//
+// Lives on the GUI thread; invalidateFrom() and appendWritten() may be
+// called from any thread.
+class LedgerCache : public QObject {
+    Q_OBJECT
+
+public:
+    using Type = LedgerBalanceEngine::Type;
+
+    static LedgerCache &instance();
+
+    // Loads the ledger of the active database if not already in memory
+    void ensureLoaded();
+    // Ledger lines with id >= fromId were written; re-read them (any thread)
+    void invalidateFrom(qint64 fromId);
+    // A ledger line was committed at the end of the ledger (any thread)
+    void appendWritten(const WrittenRow &line);
+
+    int size() const { return ids.size(); }
+    bool isLoading() const { return inFlightFrom >= 0; }
+    int rowOf(qint64 id) const; // -1 if not cached
+
+    qint64  id(int row) const       { return ids[row]; }
+    QString date(int row) const     { return dates[row]; }
+    QString ref(int row) const      { return refs[row]; }
+    QString code(int row) const     { return codes[row]; }
+    Type    type(int row) const     { return types[row]; }
+    Mass    u(int row) const        { return us[row]; }
+    Mass    u235(int row) const     { return u235s[row]; }
+    int     items(int row) const    { return itemCounts[row]; }
+    Mass    balU(int row) const     { return balUs[row]; }
+    Mass    balU235(int row) const  { return balU235s[row]; }
+    int     balItems(int row) const { return balItemCounts[row]; }
+
+signals:
+    // Rows from firstRow on were replaced, appended or removed
+    void rowsChanged(int firstRow);
+
+private:
+    LedgerCache() = default;
+    void sync();
+    void apply(QueryResult &rows, qint64 fromId);
+    void append(const QVariantMap &line);
+    void truncate(int row);
+
+    QVector<qint64>  ids;
+    QVector<QString> dates, refs, codes;
+    QVector<Type>    types;
+    QVector<Mass>    us, u235s;
+    QVector<int>     itemCounts;
+    QVector<Mass>    balUs, balU235s;
+    QVector<int>     balItemCounts;
+
+    quint64 generation = 0;  // connection the columns were read from
+    bool loaded = false;
+
+    QMutex mutex;             // guards dirtyFrom / written / syncQueued
+    qint64 dirtyFrom = -1;    // lowest id written since the last sync (-1: none)
+    QList<WrittenRow> written; // appended lines not applied yet, ascending
+    bool syncQueued = false;
+    qint64 inFlightFrom = -1; // suffix being re-read (GUI thread only)
+};
+
+#endif // LEDGERCACHE_H
@@ -0,0 +1,41 @@
+#include "Mass.h"
+
+namespace {
+const qint64 POW10[] = { 1, 10, 100, 1000 };
+}
+
+void Mass::appendTo(QString &out, int decimals) const {
+    decimals = qBound(0, decimals, 3);
+    const qint64 step = POW10[3 - decimals];
+    // Round to the last shown digit on the integer itself, half away from zero
+    const quint64 magnitude = value < 0 ? 0 - quint64(value) : quint64(value);
+    const quint64 rounded = (magnitude + step / 2) / step;
+    quint64 scaled = rounded;
+
+    // Digits right to left into a local buffer: "-", integer part, ".", fraction
+    char text[32];
+    char *p = text + sizeof(text);
+    for (int d = 0; d < decimals; ++d) { *--p = char('0' + scaled % 10); scaled /= 10; }
+    if (decimals > 0) *--p = '.';
+    do { *--p = char('0' + scaled % 10); scaled /= 10; } while (scaled > 0);
+    if (value < 0 && rounded != 0) *--p = '-';
+    out.append(QLatin1StringView(p, text + sizeof(text) - p));
+}
+
+void Mass::appendTo(QString &out) const {
+    int decimals = 3;
+    while (decimals > 0 && value % POW10[4 - decimals] == 0) --decimals;
+    appendTo(out, decimals);
+}
+
+QString Mass::toString(int decimals) const {
+    QString text;
+    appendTo(text, decimals);
+    return text;
+}
+
+QString Mass::toString() const {
+    QString text;
+    appendTo(text);
+    return text;
+}
@@ -0,0 +1,58 @@
+#ifndef MASS_H
+#define MASS_H
+
+#include <QString>
+#include <QVariant>
+#include <QtGlobal>
+
+// Nuclear material mass as a whole number of milligrams.
+//
+// Weights are entered and shown in grams but stored, summed and signed as
+// integers: addition is exact and associative, so a balance carried over
+// thousands of ledger lines is exactly the sum of its lines whatever order
+// they were added in, and two totals of the same rows always compare
+// equal. A double becomes a Mass once, where it enters the application
+// (spin boxes, CSV import, the pre-v6 REAL columns), rounded to the
+// nearest milligram; nothing downstream goes back through floating point.
+class Mass {
+public:
+    // Largest weight accepted on input: |grams| beyond this is rejected
+    // rather than rounded into an overflowing milligram count
+    static constexpr double MaxGrams = 1e12;
+
+    constexpr Mass() = default;
+    static constexpr Mass fromMg(qint64 mg) { return Mass(mg); }
+    static Mass fromGrams(double grams) { return Mass(qRound64(grams * 1000)); }
+    // Value of an INTEGER mass column (NULL reads as zero)
+    static Mass fromStored(const QVariant &mg) { return Mass(mg.toLongLong()); }
+
+    constexpr qint64 mg() const { return value; }
+    double grams() const { return value / 1000.0; }
+
+    // Grams with exactly `decimals` (0-3) digits, rounded half away from zero
+    QString toString(int decimals) const;
+    // Grams with as many digits as needed: "12", "12.5", "12.345"
+    QString toString() const;
+    // Same text appended to `out`, without temporaries: report rows format
+    // into strings they reuse (RowTemplate)
+    void appendTo(QString &out, int decimals) const;
+    void appendTo(QString &out) const;
+
+    constexpr Mass operator-() const { return Mass(-value); }
+    constexpr Mass operator+(Mass o) const { return Mass(value + o.value); }
+    constexpr Mass operator-(Mass o) const { return Mass(value - o.value); }
+    Mass &operator+=(Mass o) { value += o.value; return *this; }
+    Mass &operator-=(Mass o) { value -= o.value; return *this; }
+    constexpr bool operator==(Mass o) const { return value == o.value; }
+    constexpr bool operator!=(Mass o) const { return value != o.value; }
+    constexpr bool operator<(Mass o) const { return value < o.value; }
+    constexpr bool operator>(Mass o) const { return value > o.value; }
+
+private:
+    constexpr explicit Mass(qint64 mg) : value(mg) {}
+    qint64 value = 0;
+};
+
+Q_DECLARE_TYPEINFO(Mass, Q_PRIMITIVE_TYPE);
+
+#endif // MASS_H
@@ -0,0 +1,373 @@
+#include "MerkleIndex.h"
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMap>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QDebug>
+
+// =========================================================
+// HASHING
+// =========================================================
+
+QByteArray MerkleIndex::leafHash(qint64 rowId, const QByteArray &signature) {
+    return QCryptographicHash::hash(QByteArray(1, '\x00') + QByteArray::number(rowId) + '|' + signature,
+                                    QCryptographicHash::Sha256);
+}
+
+QByteArray MerkleIndex::nodeHash(const QByteArray &left, const QByteArray &right) {
+    if (right.isEmpty()) return left; // no right sibling: carried up
+    return QCryptographicHash::hash(QByteArray(1, '\x01') + left + right, QCryptographicHash::Sha256);
+}
+
+// =========================================================
+// MAINTENANCE
+// =========================================================
+
+qint64 MerkleIndex::leafCountOf(const QSqlDatabase &conn, const QString &tableName) {
+    QSqlQuery q(conn);
+    q.prepare("SELECT MAX(idx) FROM merkle_nodes WHERE table_name = ? AND level = 0");
+    q.bindValue(0, tableName);
+    if (!q.exec() || !q.next() || q.value(0).isNull()) return 0;
+    return q.value(0).toLongLong() + 1;
+}
+
+bool MerkleIndex::append(const QSqlDatabase &conn, RowSignature::Table table, qint64 rowId,
+                         const QString &signature) {
+    const QString name = RowSignature::tableName(table);
+    const qint64 pos = leafCountOf(conn, name);
+
+    QSqlQuery q(conn);
+    q.prepare("INSERT OR REPLACE INTO merkle_nodes (table_name, level, idx, row_id, hash) VALUES (?, 0, ?, ?, ?)");
+    q.bindValue(0, name);
+    q.bindValue(1, pos);
+    q.bindValue(2, rowId);
+    q.bindValue(3, leafHash(rowId, signature.toLatin1()));
+    if (!q.exec()) {
+        qWarning() << "MerkleIndex:" << q.lastError().text();
+        return false;
+    }
+    return buildUp(conn, name, pos, pos + 1);
+}
+
+bool MerkleIndex::rebuildFrom(const QSqlDatabase &conn, RowSignature::Table table, qint64 fromId) {
+    const QString name = RowSignature::tableName(table);
+
+    // 1. Leaf position of the first row at or after fromId
+    QSqlQuery q(conn);
+    q.prepare("SELECT idx FROM merkle_nodes WHERE table_name = ? AND level = 0 AND row_id >= ? "
+              "ORDER BY row_id ASC LIMIT 1");
+    q.bindValue(0, name);
+    q.bindValue(1, fromId);
+    if (!q.exec()) return false;
+    const qint64 start = q.next() ? q.value(0).toLongLong() : leafCountOf(conn, name);
+
+    // 2. Re-lay the leaves from there
+    q.prepare("DELETE FROM merkle_nodes WHERE table_name = ? AND level = 0 AND idx >= ?");
+    q.bindValue(0, name);
+    q.bindValue(1, start);
+    if (!q.exec()) return false;
+
+    QSqlQuery rows(conn);
+    rows.setForwardOnly(true);
+    rows.prepare("SELECT id, signature FROM " + name + " WHERE id >= ? ORDER BY id ASC");
+    rows.bindValue(0, fromId);
+    if (!rows.exec()) return false;
+
+    q.prepare("INSERT INTO merkle_nodes (table_name, level, idx, row_id, hash) VALUES (?, 0, ?, ?, ?)");
+    qint64 pos = start;
+    while (rows.next()) {
+        const qint64 id = rows.value(0).toLongLong();
+        q.bindValue(0, name);
+        q.bindValue(1, pos++);
+        q.bindValue(2, id);
+        q.bindValue(3, leafHash(id, rows.value(1).toString().toLatin1()));
+        if (!q.exec()) return false;
+    }
+
+    // 3. Every node above a re-laid leaf
+    return buildUp(conn, name, start, pos);
+}
+
+// Recomputes the internal nodes covering leaf positions >= fromPosition and
+// drops nodes that no longer exist for a tree of leafCount leaves
+bool MerkleIndex::buildUp(const QSqlDatabase &conn, const QString &tableName, qint64 fromPosition,
+                          qint64 leafCount) {
+    // One level at a time: with the bound on idx fixed per statement each
+    // delete is a range seek on the primary key (a bound of (? >> level)
+    // leaves only level > 0 to seek on, i.e. every internal node)
+    QSqlQuery q(conn);
+    q.prepare("SELECT MAX(level) FROM merkle_nodes WHERE table_name = ?");
+    q.bindValue(0, tableName);
+    if (!q.exec()) return false;
+    const int top = q.next() ? q.value(0).toInt() : 0; // the old tree may be taller than the new one
+
+    q.prepare("DELETE FROM merkle_nodes WHERE table_name = ? AND level = ? AND idx >= ?");
+    for (int level = 1; level <= top; ++level) {
+        q.bindValue(0, tableName);
+        q.bindValue(1, level);
+        q.bindValue(2, fromPosition >> level);
+        if (!q.exec()) return false;
+    }
+
+    QSqlQuery children(conn);
+    children.setForwardOnly(true);
+    children.prepare("SELECT idx, hash FROM merkle_nodes WHERE table_name = ? AND level = ? AND idx >= ? "
+                     "ORDER BY idx ASC");
+    QSqlQuery put(conn);
+    put.prepare("INSERT INTO merkle_nodes (table_name, level, idx, hash) VALUES (?, ?, ?, ?)");
+
+    qint64 lo = fromPosition;
+    qint64 count = leafCount;
+    for (int level = 0; count > 1; ++level) {
+        // Start at the left child so the first parent sees both of its children
+        children.bindValue(0, tableName);
+        children.bindValue(1, level);
+        children.bindValue(2, lo & ~qint64(1));
+        if (!children.exec()) return false;
+
+        qint64 parent = -1;
+        QByteArray left;
+        auto flush = [&]() {
+            put.bindValue(0, tableName);
+            put.bindValue(1, level + 1);
+            put.bindValue(2, parent);
+            put.bindValue(3, nodeHash(left, QByteArray()));
+            return put.exec();
+        };
+        while (children.next()) {
+            const qint64 idx = children.value(0).toLongLong();
+            const QByteArray hash = children.value(1).toByteArray();
+            if (idx % 2 == 0) {
+                if (parent >= 0 && !flush()) return false; // previous left had no sibling
+                parent = idx / 2;
+                left = hash;
+            } else {
+                put.bindValue(0, tableName);
+                put.bindValue(1, level + 1);
+                put.bindValue(2, idx / 2);
+                put.bindValue(3, nodeHash(left, hash));
+                if (!put.exec()) return false;
+                parent = -1;
+            }
+        }
+        if (parent >= 0 && !flush()) return false;
+
+        lo /= 2;
+        count = (count + 1) / 2;
+    }
+    return true;
+}
+
+// =========================================================
+// ROOTS & PROOFS
+// =========================================================
+
+QByteArray MerkleIndex::root(const QSqlDatabase &conn, RowSignature::Table table, qint64 *leafCount) {
+    const QString name = RowSignature::tableName(table);
+    if (leafCount) *leafCount = leafCountOf(conn, name);
+
+    QSqlQuery q(conn);
+    q.prepare("SELECT hash FROM merkle_nodes WHERE table_name = ? AND idx = 0 ORDER BY level DESC LIMIT 1");
+    q.bindValue(0, name);
+    return q.exec() && q.next() ? q.value(0).toByteArray() : QByteArray();
+}
+
+// Everything in a range proof but its rows: leaf positions, root, the
+// signature the range chains from and the sibling hashes along its edges
+bool MerkleIndex::proveEdges(const QSqlDatabase &conn, RowSignature::Table table,
+                             qint64 firstId, qint64 lastId, RangeProof *proof) {
+    const QString name = RowSignature::tableName(table);
+    *proof = RangeProof();
+    proof->table = table;
+
+    // 1. Leaf positions of the range
+    QSqlQuery q(conn);
+    q.prepare("SELECT idx FROM merkle_nodes WHERE table_name = ? AND level = 0 AND row_id >= ? "
+              "ORDER BY row_id ASC LIMIT 1");
+    q.bindValue(0, name);
+    q.bindValue(1, firstId);
+    if (!q.exec() || !q.next()) return false;
+    const qint64 firstPos = q.value(0).toLongLong();
+    q.prepare("SELECT idx FROM merkle_nodes WHERE table_name = ? AND level = 0 AND row_id <= ? "
+              "ORDER BY row_id DESC LIMIT 1");
+    q.bindValue(0, name);
+    q.bindValue(1, lastId);
+    if (!q.exec() || !q.next()) return false;
+    const qint64 lastPos = q.value(0).toLongLong();
+    if (lastPos < firstPos) return false;
+
+    proof->firstPosition = firstPos;
+    proof->root = root(conn, table, &proof->leafCount);
+
+    // 2. The signature the range chains from
+    q.prepare("SELECT signature FROM " + name + " WHERE id < ? ORDER BY id DESC LIMIT 1");
+    q.bindValue(0, firstId);
+    if (q.exec() && q.next()) proof->previousSig = q.value(0).toString();
+
+    // 3. Siblings along both edges of the range, level by level
+    QSqlQuery node(conn);
+    node.prepare("SELECT hash FROM merkle_nodes WHERE table_name = ? AND level = ? AND idx = ?");
+    auto need = [&](int level, qint64 idx) {
+        node.bindValue(0, name);
+        node.bindValue(1, level);
+        node.bindValue(2, idx);
+        if (node.exec() && node.next()) proof->nodes << ProofNode { level, idx, node.value(0).toByteArray() };
+    };
+    qint64 lo = firstPos, hi = lastPos, count = proof->leafCount;
+    for (int level = 0; count > 1; ++level) {
+        if (lo % 2 == 1) need(level, lo - 1);
+        if (hi % 2 == 0 && hi + 1 < count) need(level, hi + 1);
+        lo /= 2;
+        hi /= 2;
+        count = (count + 1) / 2;
+    }
+    return true;
+}
+
+// The signed columns of the range's rows, in id order
+static bool rangeRows(QSqlQuery &rows, RowSignature::Table table, qint64 firstId, qint64 lastId) {
+    rows.setForwardOnly(true);
+    rows.prepare("SELECT * FROM " + RowSignature::tableName(table) + " WHERE id BETWEEN ? AND ? ORDER BY id ASC");
+    rows.bindValue(0, firstId);
+    rows.bindValue(1, lastId);
+    return rows.exec();
+}
+
+bool MerkleIndex::proveRange(const QSqlDatabase &conn, RowSignature::Table table,
+                             qint64 firstId, qint64 lastId, RangeProof *proof) {
+    if (!proveEdges(conn, table, firstId, lastId, proof)) return false;
+
+    QSqlQuery rows(conn);
+    if (!rangeRows(rows, table, firstId, lastId)) return false;
+    const QStringList columns = RowSignature::signedColumns(table);
+    while (rows.next()) {
+        QMap<QString, QVariant> row;
+        for (const QString &column : columns) row.insert(column, rows.value(column));
+        proof->ids << rows.value("id").toLongLong();
+        proof->rows << row;
+    }
+    return true;
+}
+
+QByteArray MerkleIndex::rootFromProof(const RangeProof &proof) {
+    if (proof.ids.isEmpty() || proof.ids.size() != proof.rows.size()) return QByteArray();
+
+    // 1. Leaves, re-signing each row onto its predecessor
+    QMap<qint64, QByteArray> level;
+    RowSignature::Hasher hasher(proof.table);
+    QByteArray prev = proof.previousSig.toLatin1();
+    for (int i = 0; i < proof.ids.size(); ++i) {
+        prev = hasher.sign(prev, proof.rows[i]);
+        level.insert(proof.firstPosition + i, leafHash(proof.ids[i], prev));
+    }
+
+    QMap<QPair<int, qint64>, QByteArray> given;
+    for (const ProofNode &n : proof.nodes) given.insert(qMakePair(n.level, n.index), n.hash);
+
+    // 2. Fold upwards
+    qint64 count = proof.leafCount;
+    for (int l = 0; count > 1; ++l) {
+        QMap<qint64, QByteArray> up;
+        for (auto it = level.constBegin(); it != level.constEnd(); ++it) {
+            const qint64 parent = it.key() / 2;
+            if (up.contains(parent)) continue;
+            const qint64 leftIdx = parent * 2, rightIdx = leftIdx + 1;
+            const QByteArray left = level.value(leftIdx, given.value(qMakePair(l, leftIdx)));
+            QByteArray right;
+            if (rightIdx < count) {
+                right = level.value(rightIdx, given.value(qMakePair(l, rightIdx)));
+                if (right.isEmpty()) return QByteArray();
+            }
+            if (left.isEmpty()) return QByteArray();
+            up.insert(parent, nodeHash(left, right));
+        }
+        level = up;
+        count = (count + 1) / 2;
+    }
+    return level.value(0);
+}
+
+// =========================================================
+// EXPORT FORMAT
+// =========================================================
+
+QJsonObject MerkleIndex::toJson(const RangeProof &proof) {
+    QJsonArray rows;
+    for (int i = 0; i < proof.ids.size(); ++i)
+        rows.append(QJsonObject { { "id", proof.ids[i] },
+                                  { "fields", QJsonObject::fromVariantMap(proof.rows[i]) } });
+    QJsonArray nodes;
+    for (const ProofNode &n : proof.nodes)
+        nodes.append(QJsonObject { { "level", n.level }, { "index", n.index },
+                                   { "hash", QString::fromLatin1(n.hash.toHex()) } });
+
+    return QJsonObject {
+        { "table", RowSignature::tableName(proof.table) },
+        { "firstPosition", proof.firstPosition },
+        { "leafCount", proof.leafCount },
+        { "previousSignature", proof.previousSig },
+        { "rows", rows },
+        { "nodes", nodes },
+        { "root", QString::fromLatin1(proof.root.toHex()) },
+    };
+}
+
+bool MerkleIndex::writeRangeProof(const QSqlDatabase &conn, RowSignature::Table table,
+                                  qint64 firstId, qint64 lastId, QIODevice *out) {
+    RangeProof proof;
+    if (!proveEdges(conn, table, firstId, lastId, &proof)) return false;
+    QSqlQuery rows(conn);
+    if (!rangeRows(rows, table, firstId, lastId)) return false;
+
+    // toJson()'s layout, written a row at a time: only the O(log n) edges
+    // are held, whatever the size of the range
+    QJsonObject head = toJson(proof);
+    const QJsonValue nodes = head.take("nodes"), root = head.take("root");
+    head.remove("rows");
+    QByteArray text = QJsonDocument(head).toJson(QJsonDocument::Compact);
+    text.chop(1); // reopen the object
+    text += ",\"rows\":[";
+    if (out->write(text) != text.size()) return false;
+
+    const QStringList columns = RowSignature::signedColumns(table);
+    bool first = true;
+    while (rows.next()) {
+        QJsonObject fields;
+        for (const QString &column : columns) fields.insert(column, QJsonValue::fromVariant(rows.value(column)));
+        text = first ? QByteArray() : QByteArray(",\n");
+        text += QJsonDocument(QJsonObject { { "id", rows.value("id").toLongLong() }, { "fields", fields } })
+                    .toJson(QJsonDocument::Compact);
+        if (out->write(text) != text.size()) return false;
+        first = false;
+    }
+
+    text = "],\"nodes\":" + QJsonDocument(nodes.toArray()).toJson(QJsonDocument::Compact)
+         + ",\"root\":\"" + root.toString().toLatin1() + "\"}\n";
+    return !first && out->write(text) == text.size();
+}
+
+bool MerkleIndex::fromJson(const QJsonObject &json, RangeProof *proof) {
+    *proof = RangeProof();
+    const QString table = json["table"].toString();
+    bool known = false;
+    for (RowSignature::Table t : RowSignature::allTables()) {
+        if (table == RowSignature::tableName(t)) { proof->table = t; known = true; }
+    }
+    if (!known) return false;
+
+    proof->firstPosition = json["firstPosition"].toInteger();
+    proof->leafCount = json["leafCount"].toInteger();
+    proof->previousSig = json["previousSignature"].toString();
+    for (const QJsonValue &v : json["rows"].toArray()) {
+        proof->ids << v["id"].toInteger();
+        proof->rows << v["fields"].toObject().toVariantMap();
+    }
+    for (const QJsonValue &v : json["nodes"].toArray()) {
+        proof->nodes << ProofNode { v["level"].toInt(), v["index"].toInteger(),
+                                    QByteArray::fromHex(v["hash"].toString().toLatin1()) };
+    }
+    proof->root = QByteArray::fromHex(json["root"].toString().toLatin1());
+    return !proof->ids.isEmpty();
+}
@@ -0,0 +1,74 @@
+#ifndef MERKLEINDEX_H
+#define MERKLEINDEX_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include "RowSignature.h"
+
+// Merkle tree over each signed table, kept in merkle_nodes.
+//
+// Leaf i is the i-th row in id order: H(0x00 | id | "|" | signature). A
+// parent is H(0x01 | left | right); a node with no right sibling is carried
+// up unchanged. The root (with the leaf count) is the single value an
+// inspector needs: any contiguous range of rows can be checked against it
+// with at most two sibling hashes per level, O(log n), instead of rehashing
+// the table.
+//
+// Appends touch one node per level. A delete shifts every later leaf (and
+// re-chains their signatures anyway), so the tree is rebuilt from the
+// deleted position on.
+class MerkleIndex {
+public:
+    struct ProofNode {
+        int level;
+        qint64 index;
+        QByteArray hash;
+    };
+
+    // Everything needed to recompute the root from the rows of a range
+    struct RangeProof {
+        RowSignature::Table table = RowSignature::Ledger;
+        qint64 firstPosition = 0;  // leaf index of the first row in the range
+        qint64 leafCount = 0;      // tree size the root was taken at
+        QString previousSig;       // signature of the row before the range
+        QList<qint64> ids;
+        QList<QMap<QString, QVariant>> rows; // signed columns of each row
+        QList<ProofNode> nodes;
+        QByteArray root;
+    };
+
+    // Caller owns the transaction for the writes below
+    static bool append(const QSqlDatabase &conn, RowSignature::Table table, qint64 rowId, const QString &signature);
+    static bool rebuildFrom(const QSqlDatabase &conn, RowSignature::Table table, qint64 fromId);
+
+    static QByteArray root(const QSqlDatabase &conn, RowSignature::Table table, qint64 *leafCount = nullptr);
+    static bool proveRange(const QSqlDatabase &conn, RowSignature::Table table,
+                           qint64 firstId, qint64 lastId, RangeProof *proof);
+
+    // Recomputes the root from the proof's rows alone (no database access).
+    // Empty on a malformed proof.
+    static QByteArray rootFromProof(const RangeProof &proof);
+
+    static QJsonObject toJson(const RangeProof &proof);
+    static bool fromJson(const QJsonObject &json, RangeProof *proof);
+
+    // proveRange() + toJson() straight to `out`, rows streamed from the
+    // query: memory stays bounded for a range of any size. False if the
+    // range is empty or a write fails.
+    static bool writeRangeProof(const QSqlDatabase &conn, RowSignature::Table table,
+                                qint64 firstId, qint64 lastId, QIODevice *out);
+
+private:
+    static bool proveEdges(const QSqlDatabase &conn, RowSignature::Table table,
+                           qint64 firstId, qint64 lastId, RangeProof *proof);
+    static QByteArray leafHash(qint64 rowId, const QByteArray &signature);
+    static QByteArray nodeHash(const QByteArray &left, const QByteArray &right);
+    static qint64 leafCountOf(const QSqlDatabase &conn, const QString &tableName);
+    static bool buildUp(const QSqlDatabase &conn, const QString &tableName, qint64 fromPosition, qint64 leafCount);
+};
+
+#endif // MERKLEINDEX_H
@@ -0,0 +1,175 @@
+#include "ReportJobQueue.h"
+#include "ConnectionPool.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QThread>
+#include <QDebug>
+
+static ReportJobQueue *s_instance = nullptr;
+
+// Without a row count, progress is posted every this many rows
+static const qint64 UNCOUNTED_STEP = 1000;
+
+struct ReportJob::State {
+    int id = 0;
+    std::atomic<bool> cancelled { false };
+    std::atomic<qint64> total { 0 };
+    qint64 done = 0;       // worker only
+    qint64 lastStep = -1;  // worker only: last percent (or block of rows) posted
+    QHash<QString, QString> staging; // output file -> staging file; set before the job starts
+};
+
+// =========================================================
+// JOB (worker side)
+// =========================================================
+
+void ReportJob::setTotal(qint64 rows) {
+    state->total = rows;
+}
+
+bool ReportJob::setTotalFromQuery(const QString &countSql) {
+    QSqlQuery q(conn);
+    if (!q.exec(countSql) || !q.next()) {
+        qWarning() << "ReportJob: count failed:" << q.lastError().text() << countSql;
+        return false;
+    }
+    setTotal(q.value(0).toLongLong());
+    return true;
+}
+
+QSqlQuery ReportJob::cursor(const QString &sql) const {
+    QSqlQuery q(conn);
+    q.setForwardOnly(true);
+    if (!q.exec(sql)) qWarning() << "ReportJob: query failed:" << q.lastError().text() << sql;
+    return q;
+}
+
+QString ReportJob::output(const QString &file) const {
+    return state->staging.value(file, file);
+}
+
+bool ReportJob::isCancelled() const {
+    return state->cancelled;
+}
+
+bool ReportJob::advance() {
+    const qint64 done = ++state->done;
+    const qint64 total = state->total;
+    // Post only when the bar would move: at most ~100 events per report
+    const qint64 step = total > 0 ? done * 100 / total : done / UNCOUNTED_STEP;
+    if (step != state->lastStep) {
+        state->lastStep = step;
+        const int id = state->id;
+        ReportJobQueue *q = queue;
+        QMetaObject::invokeMethod(q, [q, id, done, total]() {
+            emit q->jobProgress(id, done, total);
+        }, Qt::QueuedConnection);
+    }
+    return !state->cancelled;
+}
+
+// =========================================================
+// QUEUE
+// =========================================================
+
+// Beside the file, keeping its suffix (writers pick the format by it):
+// "GL.csv" is staged as "GL.part.csv"
+static QString stagingPath(const QString &file) {
+    const QFileInfo fi(file);
+    if (fi.suffix().isEmpty()) return file + ".part";
+    return fi.path() + "/" + fi.completeBaseName() + ".part." + fi.suffix();
+}
+
+ReportJobQueue &ReportJobQueue::instance() {
+    // Parented to the application so workers are joined before QCoreApplication goes away
+    if (!s_instance) s_instance = new ReportJobQueue(QCoreApplication::instance());
+    return *s_instance;
+}
+
+ReportJobQueue::ReportJobQueue(QObject *parent) : QObject(parent) {
+    workers.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
+}
+
+ReportJobQueue::~ReportJobQueue() {
+    cancelAll();
+    workers.waitForDone();
+    s_instance = nullptr;
+}
+
+int ReportJobQueue::submit(const QString &title, const QStringList &outputFiles, Work work,
+                           QObject *receiver, Done done) {
+    auto state = std::make_shared<ReportJob::State>();
+    state->id = ++nextId;
+    for (const QString &file : outputFiles)
+        if (!file.isEmpty()) state->staging.insert(file, stagingPath(file));
+    jobs.insert(state->id, Pending { state, receiver, std::move(done) });
+    emit jobQueued(state->id, title);
+
+    workers.start([this, state, work]() { run(state, work); });
+    return state->id;
+}
+
+void ReportJobQueue::cancel(int jobId) {
+    // A queued job still starts, sees the flag and finishes at once, so
+    // jobFinished() is always emitted
+    auto it = jobs.find(jobId);
+    if (it != jobs.end()) it->state->cancelled = true;
+}
+
+void ReportJobQueue::cancelAll() {
+    for (const Pending &p : jobs) p.state->cancelled = true;
+}
+
+void ReportJobQueue::releaseConnections() {
+    if (!s_instance) return;
+    s_instance->cancelAll();
+    s_instance->workers.waitForDone(); // cancelled jobs stop at their next row
+}
+
+void ReportJobQueue::run(const std::shared_ptr<ReportJob::State> &state, const Work &work) {
+    const int id = state->id;
+    bool ok = false;
+
+    if (!state->cancelled) {
+        QMetaObject::invokeMethod(this, [this, id]() { emit jobStarted(id); }, Qt::QueuedConnection);
+        {
+            QSqlDatabase conn = ConnectionPool::instance().reader();
+            if (!conn.isOpen()) {
+                qWarning() << "ReportJobQueue: cannot open reader connection:" << conn.lastError().text();
+            } else {
+                // 1. One read transaction: the snapshot is taken by the job's first query
+                conn.transaction();
+                ReportJob job(this, state, conn);
+                ok = work(job) && !state->cancelled;
+                conn.rollback(); // nothing was written; ends the snapshot
+            }
+        }
+        // 2. Idle pool threads must not keep the file open (see releaseConnections)
+        ConnectionPool::instance().releaseThread();
+    }
+
+    // 3. Staged outputs replace the chosen files only now; a file the job
+    //    did not write (an optional sidecar) is left as it was
+    for (auto it = state->staging.constBegin(); it != state->staging.constEnd(); ++it) {
+        if (!QFile::exists(it.value())) continue;
+        if (ok) {
+            QFile::remove(it.key());
+            if (QFile::rename(it.value(), it.key())) continue;
+            qWarning() << "ReportJobQueue: cannot replace" << it.key();
+            ok = false;
+        }
+        QFile::remove(it.value());
+    }
+    QMetaObject::invokeMethod(this, [this, id, ok]() { finish(id, ok); }, Qt::QueuedConnection);
+}
+
+void ReportJobQueue::finish(int jobId, bool ok) {
+    const Pending p = jobs.take(jobId);
+    if (!p.state) return;
+    const bool cancelled = p.state->cancelled;
+    emit jobFinished(jobId, ok, cancelled);
+    if (!cancelled && p.receiver && p.done) p.done(ok);
+}
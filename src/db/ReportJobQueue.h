@@ -0,0 +1,110 @@
+#ifndef REPORTJOBQUEUE_H
+#define REPORTJOBQUEUE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QHash>
+#include <QPointer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class ReportJobQueue;
+
+// What a running report sees on its worker thread
+class ReportJob {
+public:
+    // The worker's pooled reader, inside the job's read transaction: every
+    // query the job runs sees the database as it was at the first one
+    QSqlDatabase connection() const { return conn; }
+    // Forward-only query on that connection, executed; inactive if it
+    // failed. Rows are not kept once read (a scrollable QSQLITE query
+    // caches every row it has passed), so a report of any length streams.
+    QSqlQuery cursor(const QString &sql) const;
+
+    // Where to write `file`, one of the job's outputFiles: a staging file
+    // beside it, renamed over it only once the job has succeeded
+    QString output(const QString &file) const;
+
+    // Rows the report will write, for the progress bar; from a COUNT(*)
+    // query run in the same snapshot
+    void setTotal(qint64 rows);
+    bool setTotalFromQuery(const QString &countSql);
+
+    // One more row written; false once the job has been cancelled
+    bool advance();
+    bool isCancelled() const;
+
+private:
+    friend class ReportJobQueue;
+    struct State;
+    ReportJob(ReportJobQueue *queue, std::shared_ptr<State> state, const QSqlDatabase &conn)
+        : queue(queue), state(std::move(state)), conn(conn) {}
+
+    ReportJobQueue *queue;
+    std::shared_ptr<State> state;
+    QSqlDatabase conn;
+};
+
+// Report exports off the GUI thread.
+//
+// Each job runs on a small pool of its own (several reports at once, one
+// core left to the GUI) inside a single read transaction on that worker's
+// pooled reader, so a report is internally consistent however long it
+// takes: under WAL (Operational) the operator's writes go on alongside it
+// and simply are not in it. Progress and the outcome are signalled on the
+// GUI thread. Outputs are written to staging files and only replace the
+// chosen files when the job succeeds; a cancelled or failed job removes its
+// staging files and leaves anything already there untouched.
+class ReportJobQueue : public QObject {
+    Q_OBJECT
+
+public:
+    // Runs on the worker; true if the report was written
+    using Work = std::function<bool(ReportJob &)>;
+    // Runs on receiver's thread when the job ends, unless it was cancelled
+    using Done = std::function<void(bool ok)>;
+
+    static ReportJobQueue &instance();
+    ~ReportJobQueue();
+
+    // `outputFiles` are what the job writes (the report, any sidecar), each
+    // through ReportJob::output()
+    int submit(const QString &title, const QStringList &outputFiles, Work work, QObject *receiver, Done done);
+    int submit(const QString &title, const QString &outputFile, Work work, QObject *receiver, Done done) {
+        return submit(title, QStringList { outputFile }, std::move(work), receiver, std::move(done));
+    }
+    void cancel(int jobId);
+
+    // Cancels every job and waits until none holds a connection, so the
+    // main file can be closed, replaced or deleted
+    static void releaseConnections();
+
+signals:
+    void jobQueued(int jobId, const QString &title);
+    void jobStarted(int jobId);
+    void jobProgress(int jobId, qint64 rowsDone, qint64 rowsTotal);
+    void jobFinished(int jobId, bool ok, bool cancelled);
+
+private:
+    struct Pending {
+        std::shared_ptr<ReportJob::State> state;
+        QPointer<QObject> receiver;
+        Done done;
+    };
+
+    explicit ReportJobQueue(QObject *parent);
+    void run(const std::shared_ptr<ReportJob::State> &state, const Work &work);
+    void finish(int jobId, bool ok);
+    void cancelAll();
+
+    QThreadPool workers;
+    QHash<int, Pending> jobs;     // queued or running; GUI thread only
+    int nextId = 0;
+};
+
+#endif // REPORTJOBQUEUE_H
@@ -0,0 +1,204 @@
+#include "RowSignature.h"
+#include <QSqlRecord>
+#include <QtEndian>
+#include <cstring>
+
+// Signed columns per table, in encoding order. Changing this list changes
+// every signature: it needs a schema migration that re-signs the tables.
+namespace {
+enum FieldKind { Text, Weight, Real, Count };
+struct Field { const char *column; FieldKind kind; };
+
+const QVector<Field> &fieldsOf(RowSignature::Table table) {
+    static const QVector<Field> ledger = {
+        { "date", Text }, { "ref", Text }, { "code", Text }, { "type", Text },
+        { "u_weight", Weight }, { "u235_weight", Weight }, { "items", Count } };
+    static const QVector<Field> mbr = {
+        { "continuation", Text }, { "entry_name", Text }, { "element", Text }, { "weight", Weight },
+        { "unit", Text }, { "fissile", Weight }, { "isotope", Text }, { "report_no", Text } };
+    static const QVector<Field> batches = {
+        { "batch_number", Text }, { "mba", Text }, { "kmp", Text }, { "building", Text },
+        { "room", Text }, { "physical_form", Text }, { "chemical_form", Text }, { "element", Text },
+        { "isotope", Text }, { "weight_u", Weight }, { "weight_u235", Weight }, { "weight_pu", Weight },
+        { "weight_th", Weight }, { "unit", Text }, { "manufacturer", Text }, { "insertion_date", Text },
+        { "status", Text } };
+    static const QVector<Field> history = {
+        { "batch_id", Count }, { "change_type", Text }, { "element_code", Text }, { "items_count", Count },
+        { "increase_u", Weight }, { "decrease_u", Weight }, { "record_date", Text }, { "description", Text } };
+    static const QVector<Field> lii = {
+        { "kmp", Text }, { "position", Text }, { "batch", Text }, { "desc", Text },
+        { "weight_elem", Weight }, { "weight_fissile", Weight }, { "weight_pu", Weight },
+        { "burnup", Real }, { "cooling", Real } };
+    static const QVector<Field> nli = {
+        { "batch", Text }, { "items", Count }, { "code", Text }, { "u_elem_code", Text },
+        { "u_iso_code", Text }, { "u_weight", Weight }, { "u_iso_weight", Weight },
+        { "p_elem_code", Text }, { "p_weight", Weight } };
+
+    switch (table) {
+    case RowSignature::Ledger:  return ledger;
+    case RowSignature::MBR:     return mbr;
+    case RowSignature::Batches: return batches;
+    case RowSignature::History: return history;
+    case RowSignature::LII:     return lii;
+    case RowSignature::NLI:     return nli;
+    }
+    return ledger;
+}
+
+const char FORMAT_DOUBLE_WEIGHTS = '\x01';
+const char FORMAT_FIXED_POINT = '\x02';
+
+void appendDouble(QByteArray &buffer, double d) {
+    char word[8];
+    if (d == 0) d = 0; // -0.0 and 0.0 sign the same
+    quint64 bits;
+    std::memcpy(&bits, &d, sizeof bits);
+    qToBigEndian<quint64>(bits, word);
+    buffer.append(word, 8);
+}
+
+void appendInt(QByteArray &buffer, qint64 n) {
+    char word[8];
+    qToBigEndian<qint64>(n, word);
+    buffer.append(word, 8);
+}
+}
+
+QList<RowSignature::Table> RowSignature::allTables() {
+    return { Ledger, MBR, Batches, History, LII, NLI };
+}
+
+QString RowSignature::tableName(Table table) {
+    switch (table) {
+    case Ledger:  return "manual_ledger";
+    case MBR:     return "mbr_entries";
+    case Batches: return "batches";
+    case History: return "history";
+    case LII:     return "lii_manual";
+    case NLI:     return "nli_manual";
+    }
+    return QString();
+}
+
+QString RowSignature::displayName(Table table) {
+    switch (table) {
+    case Ledger:  return "General Ledger";
+    case MBR:     return "MBR";
+    case Batches: return "Batches";
+    case History: return "Receipt History";
+    case LII:     return "LII";
+    case NLI:     return "NLI";
+    }
+    return QString();
+}
+
+QStringList RowSignature::signedColumns(Table table) {
+    QStringList names;
+    for (const Field &f : fieldsOf(table)) names << f.column;
+    return names;
+}
+
+QString RowSignature::sign(Table table, const QString &previousSig, const QMap<QString, QVariant> &row) {
+    Hasher hasher(table);
+    return QString::fromLatin1(hasher.sign(previousSig.toLatin1(), row));
+}
+
+// =========================================================
+// CODEC / HASHER
+// =========================================================
+
+RowSignature::Hasher::Hasher(Table table, Codec codec)
+    : table(table), codec(codec), hash(QCryptographicHash::Sha256) {
+    buffer.reserve(256);
+}
+
+void RowSignature::Hasher::bind(const QSqlQuery &query) {
+    const QSqlRecord rec = query.record();
+    columns.clear();
+    for (const Field &f : fieldsOf(table)) columns << rec.indexOf(f.column);
+}
+
+void RowSignature::Hasher::encode(int field, const QVariant &value) {
+    switch (fieldsOf(table)[field].kind) {
+    case Text: {
+        char word[4];
+        const QByteArray utf8 = value.toString().toUtf8();
+        qToBigEndian<quint32>(quint32(utf8.size()), word);
+        buffer.append(word, 4);
+        buffer.append(utf8);
+        break;
+    }
+    case Weight: // stored as whole milligrams
+        if (codec == FixedPoint) appendInt(buffer, value.toLongLong());
+        else appendDouble(buffer, value.toDouble());
+        break;
+    case Real:
+        appendDouble(buffer, value.toDouble());
+        break;
+    case Count:
+        appendInt(buffer, value.toLongLong());
+        break;
+    }
+}
+
+QByteArray RowSignature::Hasher::finish() {
+    hash.reset();
+    hash.addData(buffer);
+    return hash.result().toHex();
+}
+
+QByteArray RowSignature::Hasher::sign(const QByteArray &previousSig, const QSqlQuery &row) {
+    buffer.resize(0); // keeps the capacity: no allocation per row
+    buffer += previousSig;
+    buffer += codec == FixedPoint ? FORMAT_FIXED_POINT : FORMAT_DOUBLE_WEIGHTS;
+    for (int i = 0; i < columns.size(); ++i) encode(i, row.value(columns[i]));
+    return finish();
+}
+
+QByteArray RowSignature::Hasher::sign(const QByteArray &previousSig, const QMap<QString, QVariant> &row) {
+    const QVector<Field> &fields = fieldsOf(table);
+    buffer.resize(0);
+    buffer += previousSig;
+    buffer += codec == FixedPoint ? FORMAT_FIXED_POINT : FORMAT_DOUBLE_WEIGHTS;
+    for (int i = 0; i < fields.size(); ++i) encode(i, row.value(fields[i].column));
+    return finish();
+}
+
+// =========================================================
+// EARLIER FORMATS (migrations only)
+// =========================================================
+
+QString RowSignature::textCanonical(Table table, const QMap<QString, QVariant> &row) {
+    switch (table) {
+    case Ledger:
+        return QString("%1|%2|%3|%4|%5|%6|%7")
+            .arg(row["date"].toString())
+            .arg(row["ref"].toString())
+            .arg(row["code"].toString())
+            .arg(row["type"].toString())
+            .arg(row["u_weight"].toDouble(), 0, 'f', 4)
+            .arg(row["u235_weight"].toDouble(), 0, 'f', 4)
+            .arg(row["items"].toInt());
+    case MBR:
+        return QString("%1|%2|%3|%4|%5|%6|%7|%8")
+            .arg(row["continuation"].toString())
+            .arg(row["entry_name"].toString())
+            .arg(row["element"].toString())
+            .arg(row["weight"].toDouble(), 0, 'f', 4)
+            .arg(row["unit"].toString())
+            .arg(row["fissile"].toDouble(), 0, 'f', 4)
+            .arg(row["isotope"].toString())
+            .arg(row["report_no"].toString());
+    default:
+        return QString();
+    }
+}
+
+QString RowSignature::textChain(const QString &previousSig, const QString &canonicalRow) {
+    return QCryptographicHash::hash((previousSig + "|" + canonicalRow).toUtf8(),
+                                    QCryptographicHash::Sha256).toHex();
+}
+
+QString RowSignature::legacy(const QString &canonicalRow) {
+    return QCryptographicHash::hash(canonicalRow.toUtf8(), QCryptographicHash::Sha256).toHex();
+}
@@ -0,0 +1,75 @@
+#ifndef ROWSIGNATURE_H
+#define ROWSIGNATURE_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QList>
+#include <QMap>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+// Tamper-evidence signatures for the signed tables.
+//
+// Each row is serialised by a binary codec and signed as
+//     sig(n) = hex SHA-256( sig(n-1) + encode(n) )
+// with sig(0) = "" for the first row. Because every signature covers its
+// predecessor's, an edited, deleted, inserted or reordered row breaks the
+// chain at that point, not just a row whose own fields changed.
+//
+// encode(): a format byte, then the table's signed columns in a fixed order,
+// each typed: text as a 32-bit big-endian length + UTF-8, weights (whole
+// milligrams) and counts as 8-byte big-endian integers, other measures
+// (burnup, cooling) as 8-byte big-endian IEEE-754 doubles. No separators
+// to escape, no decimal formatting, one reused buffer.
+class RowSignature {
+public:
+    enum Table { Ledger, MBR, Batches, History, LII, NLI };
+
+    static QList<Table> allTables();
+    static QString tableName(Table table);   // "manual_ledger", "mbr_entries", ...
+    static QString displayName(Table table); // "General Ledger", "MBR", ...
+    static QStringList signedColumns(Table table);
+
+    // One-off signature of a row given as column name -> value
+    static QString sign(Table table, const QString &previousSig, const QMap<QString, QVariant> &row);
+
+    // Bulk signing/verification. Column positions are resolved once, the row
+    // is encoded into a reused buffer and the SHA-256 context is reset rather
+    // than recreated. One Hasher per thread.
+    class Hasher {
+    public:
+        // FixedPoint is the current format. DoubleWeights (weights as
+        // doubles, until schema v6) is kept for the migration that converts it.
+        enum Codec { DoubleWeights, FixedPoint };
+
+        explicit Hasher(Table table, Codec codec = FixedPoint);
+        // Column positions of `query`'s result; call after exec()
+        void bind(const QSqlQuery &query);
+        // Hex signature for the current row of the bound query
+        QByteArray sign(const QByteArray &previousSig, const QSqlQuery &row);
+        QByteArray sign(const QByteArray &previousSig, const QMap<QString, QVariant> &row);
+
+    private:
+        void encode(int field, const QVariant &value);
+        QByteArray finish();
+
+        Table table;
+        Codec codec;
+        QVector<int> columns;
+        QByteArray buffer;
+        QCryptographicHash hash;
+    };
+
+    // Earlier formats (Ledger and MBR only), kept for the schema migrations
+    // that convert them:
+    // "a|b|%.4f|..." text joined by '|' (textCanonical), signed on its own
+    // until schema v2 (legacy) and chained as SHA-256(prev|text) until v4.
+    static QString textCanonical(Table table, const QMap<QString, QVariant> &row);
+    static QString textChain(const QString &previousSig, const QString &canonicalRow);
+    static QString legacy(const QString &canonicalRow);
+};
+
+#endif // ROWSIGNATURE_H
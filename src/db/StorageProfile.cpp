@@ -0,0 +1,81 @@
+#include "StorageProfile.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+QString StorageProfile::name(Role role) {
+    switch (role) {
+    case Operational:     return "Operational";
+    case Training:        return "Training";
+    case ReadOnlyArchive: return "Read-Only Archive";
+    }
+    return QString();
+}
+
+QString StorageProfile::connectOptions(Role role) {
+    switch (role) {
+    case Operational:     return "QSQLITE_BUSY_TIMEOUT=5000";
+    case Training:        return "QSQLITE_BUSY_TIMEOUT=1000";
+    case ReadOnlyArchive: return "QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000";
+    }
+    return QString();
+}
+
+bool StorageProfile::apply(const QSqlDatabase &db, Role role) {
+    QStringList pragmas;
+    switch (role) {
+    case Operational:
+        pragmas << "PRAGMA journal_mode = WAL"
+                << "PRAGMA synchronous = NORMAL"
+                << "PRAGMA cache_size = -16384"      // KiB -> 16 MiB
+                << "PRAGMA mmap_size = 268435456"    // 256 MiB
+                << "PRAGMA temp_store = MEMORY"
+                << "PRAGMA wal_autocheckpoint = 1000";
+        break;
+    case Training:
+        // WAL as in Operational: report jobs read in a transaction, which a
+        // rollback journal would make the operator's writes wait out
+        pragmas << "PRAGMA journal_mode = WAL"
+                << "PRAGMA synchronous = OFF"
+                << "PRAGMA cache_size = -8192"
+                << "PRAGMA temp_store = MEMORY";
+        break;
+    case ReadOnlyArchive:
+        // journal_mode cannot be changed on a read-only handle
+        pragmas << "PRAGMA query_only = 1"
+                << "PRAGMA cache_size = -32768"
+                << "PRAGMA mmap_size = 1073741824"   // 1 GiB
+                << "PRAGMA temp_store = MEMORY";
+        break;
+    }
+
+    bool ok = true;
+    QSqlQuery q(db);
+    for (const QString &p : pragmas) {
+        if (!q.exec(p)) {
+            qWarning() << "Storage profile" << name(role) << "-" << p << "failed:" << q.lastError().text();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+QStringList StorageProfile::describe(const QSqlDatabase &db) {
+    QStringList out;
+    if (!db.isOpen()) return out;
+
+    QSqlQuery q(db);
+    auto read = [&](const QString &pragma) -> QString {
+        if (q.exec("PRAGMA " + pragma) && q.next()) return q.value(0).toString();
+        return "?";
+    };
+
+    static const char *SYNC_NAMES[] = { "OFF", "NORMAL", "FULL", "EXTRA" };
+    int sync = read("synchronous").toInt();
+
+    out << "journal_mode=" + read("journal_mode")
+        << "synchronous=" + QString(sync >= 0 && sync <= 3 ? SYNC_NAMES[sync] : "?")
+        << "cache_size=" + read("cache_size")
+        << "mmap_size=" + read("mmap_size");
+    return out;
+}
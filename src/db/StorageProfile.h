@@ -0,0 +1,35 @@
+#ifndef STORAGEPROFILE_H
+#define STORAGEPROFILE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+// Named SQLite tuning presets, one per way AIR uses a database file.
+//
+//  Operational     - the real inventory/user databases: WAL journaling so
+//                    readers never block the writer, synchronous=NORMAL
+//                    (durable at checkpoint, no fsync per ledger insert),
+//                    a 16 MiB page cache and memory-mapped reads.
+//  Training        - throw-away scenario sessions in the temp folder: WAL,
+//                    so background report reads still never block the
+//                    operator, but nothing is fsynced.
+//  ReadOnlyArchive - checking a backup before it is restored: the file is
+//                    opened read-only, writes are refused, large mmap window.
+class StorageProfile {
+public:
+    enum Role { Operational, Training, ReadOnlyArchive };
+
+    static QString name(Role role);
+
+    // Must be set on the QSqlDatabase before open()
+    static QString connectOptions(Role role);
+
+    // Issues the PRAGMAs for the role on an open connection
+    static bool apply(const QSqlDatabase &db, Role role);
+
+    // Reads the effective settings back from the connection, for display
+    static QStringList describe(const QSqlDatabase &db);
+};
+
+#endif // STORAGEPROFILE_H
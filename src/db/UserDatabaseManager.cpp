@@ -1,4 +1,5 @@
 #include "UserDatabaseManager.h"
+#include "StorageProfile.h"
 #include <QStandardPaths>
 #include <QDir>
 
@@ -18,12 +19,14 @@ bool UserDatabaseManager::connect() {
         QString dbPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/air_users.db";
         db.setDatabaseName(dbPath); 
         // ----------------------------------------------------------
+        db.setConnectOptions(StorageProfile::connectOptions(StorageProfile::Operational));
     }
 
     if (!db.open()) {
         qCritical() << "User DB Connection Error:" << db.lastError().text();
         return false;
     }
+    StorageProfile::apply(db, StorageProfile::Operational);
     initTables();
     return true;
 }
@@ -2,16 +2,41 @@
 #include "ui/dialogs/LoginDialog.h"
 #include "ui/dialogs/AIR_SplashScreen.h"
 #include "db/UserDatabaseManager.h"
+#include "db/DatabaseManager.h"
 #include <QApplication>
 #include <QSettings>
+#include <QTemporaryDir>
 #include <QDebug>
+#include <cstdio>
 
 // --- MAC COLOR FIX ---
 #include <QStyleFactory>
 #include <QPalette>
 // ---------------------
 
+// `AIR --audit-query-plans [database]`: builds (or migrates) the schema in
+// the given file - a scratch one by default - and runs the query plan audit
+// without any UI. Exits 1 if a query scans or sorts where it should seek,
+// so CI can fail on a plan regression.
+static int runPlanAudit(int argc, char *argv[], int flag) {
+    QCoreApplication app(argc, argv);
+    QTemporaryDir scratch;
+    const QString path = flag + 1 < argc ? QString::fromLocal8Bit(argv[flag + 1])
+                                         : scratch.filePath("audit.db");
+    if (!DatabaseManager::instance().connect(path)) return 2;
+
+    QStringList findings;
+    const bool clean = DatabaseManager::instance().auditQueryPlans(&findings);
+    for (const QString &f : findings) std::fprintf(stderr, "Query plan regression: %s\n", qPrintable(f));
+    std::fprintf(stderr, "Query plan audit: %s\n", clean ? "clean" : "FAILED");
+    return clean ? 0 : 1;
+}
+
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--audit-query-plans") == 0) return runPlanAudit(argc, argv, i);
+    }
+
     QApplication a(argc, argv);
 
     // App metadata — used by QSettings to persist splash screen preference
@@ -10,6 +10,8 @@
 #include "views/BackupRestoreWidget.h"
 #include "views/TrainingWidget.h"
 #include "views/MBRWidget.h"
+#include "views/IntegrityAuditWidget.h"
+#include "views/ReportJobsPanel.h"
 
 #include "dialogs/AIR_SplashScreen.h"
 
@@ -66,6 +68,7 @@ void MainWindow::setupUI() {
     nliWidget = new NLIWidget();            stack->addWidget(nliWidget); // 6
     trainingWidget = new TrainingWidget();  stack->addWidget(trainingWidget); // 7
     mbrWidget = new MBRWidget();            stack->addWidget(mbrWidget); // 8
+    auditWidget = new IntegrityAuditWidget(); stack->addWidget(auditWidget); // 9
 
     QWidget *body = new QWidget();
     QVBoxLayout *bodyLayout = new QVBoxLayout(body);
@@ -73,6 +76,7 @@ void MainWindow::setupUI() {
     bodyLayout->addWidget(stack);
     
     mainLayout->addWidget(body);
+    mainLayout->addWidget(new ReportJobsPanel()); // exports running in the background
 
     // CONNECTIONS
     connect(receiptWidget, &ReceiptWidget::dataChanged, homeWidget, &HomeWidget::refreshData); 
@@ -243,6 +247,7 @@ if (renderer.isValid()) {
     QMenu *adminMenu = new QMenu(btnAdmin);
     adminMenu->addAction("User Management", [this, btnAdmin, updateActiveBtn](){ switchView(3); updateActiveBtn(btnAdmin); });
     adminMenu->addAction("Backup / Restore", [this, btnAdmin, updateActiveBtn](){ switchView(4); updateActiveBtn(btnAdmin); });
+    adminMenu->addAction("Integrity Audit", [this, btnAdmin, updateActiveBtn](){ switchView(9); updateActiveBtn(btnAdmin); });
     btnAdmin->setMenu(adminMenu);
     adminMenu->setStyleSheet("QMenu { background-color: #003366; color: white; } QMenu::item { padding: 8px 20px; } QMenu::item:selected { background-color: #002244; }");
     navLay->addWidget(btnAdmin);
@@ -16,6 +16,7 @@ class GeneralLedgerWidget;
 class LIIWidget;
 class NLIWidget;
 class MBRWidget;
+class IntegrityAuditWidget;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -54,6 +55,7 @@ private:
     NLIWidget *nliWidget;
     TrainingWidget *trainingWidget;
     MBRWidget *mbrWidget; 
+    IntegrityAuditWidget *auditWidget;
 };
 
 #endif // MAINWINDOW_H
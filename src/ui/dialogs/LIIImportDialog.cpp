@@ -0,0 +1,215 @@
+#include "LIIImportDialog.h"
+#include "../../db/DatabaseManager.h"
+#include "../../utils/LIICsvImporter.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+
+// Error lines kept in the dialog; the rest are only counted so a bad file
+// cannot grow the log without bound.
+static const int MAX_SHOWN_ERRORS = 500;
+
+LIIImportDialog::LIIImportDialog(QWidget *parent) : QDialog(parent) {
+    setWindowTitle("Import LII Listing (CSV/TSV)");
+    resize(640, 560);
+    setupUI();
+}
+
+LIIImportDialog::~LIIImportDialog() {
+    // reject() refuses to close while running, so the worker is idle here
+    if (workerThread) { workerThread->quit(); workerThread->wait(); }
+}
+
+void LIIImportDialog::setupUI() {
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+
+    // 1. Source file
+    QGroupBox *grpFile = new QGroupBox("Source File");
+    QGridLayout *fileGrid = new QGridLayout(grpFile);
+    txtFile = new QLineEdit; txtFile->setReadOnly(true);
+    QPushButton *btnBrowse = new QPushButton("Browse...");
+    connect(btnBrowse, &QPushButton::clicked, this, &LIIImportDialog::browseFile);
+    comboDelimiter = new QComboBox;
+    comboDelimiter->addItem("Comma (,)", QString(","));
+    comboDelimiter->addItem("Tab", QString("\t"));
+    comboDelimiter->addItem("Semicolon (;)", QString(";"));
+    connect(comboDelimiter, &QComboBox::currentIndexChanged, this, &LIIImportDialog::reloadHeader);
+    fileGrid->addWidget(new QLabel("File:"), 0, 0);
+    fileGrid->addWidget(txtFile, 0, 1);
+    fileGrid->addWidget(btnBrowse, 0, 2);
+    fileGrid->addWidget(new QLabel("Delimiter:"), 1, 0);
+    fileGrid->addWidget(comboDelimiter, 1, 1);
+    mainLayout->addWidget(grpFile);
+
+    // 2. Column mapping (populated from the header row)
+    QGroupBox *grpMap = new QGroupBox("Column Mapping");
+    QGridLayout *mapGrid = new QGridLayout(grpMap);
+    const QList<LIICsvImporter::Field> &fields = LIICsvImporter::fields();
+    for (int i = 0; i < fields.size(); ++i) {
+        QString label = fields[i].label + (fields[i].required ? " *" : "") + ":";
+        mapGrid->addWidget(new QLabel(label), i / 2, (i % 2) * 2);
+        QComboBox *combo = new QComboBox;
+        combo->addItem("(not mapped)", -1);
+        mapGrid->addWidget(combo, i / 2, (i % 2) * 2 + 1);
+        mapCombos << combo;
+    }
+    mainLayout->addWidget(grpMap);
+
+    // 3. Progress
+    progressBar = new QProgressBar; progressBar->setRange(0, 1000); progressBar->setValue(0);
+    lblStatus = new QLabel("Select a file to import.");
+    txtErrors = new QPlainTextEdit; txtErrors->setReadOnly(true);
+    txtErrors->setPlaceholderText("Rejected rows will be listed here.");
+    mainLayout->addWidget(progressBar);
+    mainLayout->addWidget(lblStatus);
+    mainLayout->addWidget(txtErrors, 1);
+
+    // 4. Buttons
+    QHBoxLayout *btnLay = new QHBoxLayout;
+    btnImport = new QPushButton("Import"); btnImport->setEnabled(false);
+    btnClose = new QPushButton("Close");
+    connect(btnImport, &QPushButton::clicked, this, &LIIImportDialog::startImport);
+    connect(btnClose, &QPushButton::clicked, this, &LIIImportDialog::reject);
+    btnLay->addStretch(); btnLay->addWidget(btnImport); btnLay->addWidget(btnClose);
+    mainLayout->addLayout(btnLay);
+}
+
+QChar LIIImportDialog::currentDelimiter() const {
+    return comboDelimiter->currentData().toString().at(0);
+}
+
+void LIIImportDialog::browseFile() {
+    QString fileName = QFileDialog::getOpenFileName(this, "Open LII Listing", "",
+        "Delimited Files (*.csv *.tsv *.txt);;All Files (*)");
+    if (fileName.isEmpty()) return;
+    txtFile->setText(fileName);
+
+    // Guess the delimiter from the extension; reloadHeader() runs either way
+    int idx = QFileInfo(fileName).suffix().compare("tsv", Qt::CaseInsensitive) == 0 ? 1 : 0;
+    if (comboDelimiter->currentIndex() != idx) comboDelimiter->setCurrentIndex(idx);
+    else reloadHeader();
+}
+
+void LIIImportDialog::reloadHeader() {
+    if (txtFile->text().isEmpty()) return;
+    QString error;
+    const QStringList header = LIICsvImporter::readHeader(txtFile->text(), currentDelimiter(), &error);
+    if (header.isEmpty()) {
+        lblStatus->setText("Cannot read header: " + error);
+        btnImport->setEnabled(false);
+        return;
+    }
+
+    // Auto-map columns whose header matches the field key or label
+    const QList<LIICsvImporter::Field> &fields = LIICsvImporter::fields();
+    for (int i = 0; i < mapCombos.size(); ++i) {
+        QComboBox *combo = mapCombos[i];
+        combo->clear();
+        combo->addItem("(not mapped)", -1);
+        int match = 0;
+        for (int c = 0; c < header.size(); ++c) {
+            combo->addItem(header[c], c);
+            QString h = header[c].toLower();
+            if (match == 0 && (h == fields[i].key || h == fields[i].label.toLower()
+                               || fields[i].label.toLower().startsWith(h + " ")))
+                match = c + 1;
+        }
+        combo->setCurrentIndex(match);
+    }
+    lblStatus->setText(QString("%1 columns found. Check the mapping, then click Import.").arg(header.size()));
+    btnImport->setEnabled(true);
+}
+
+void LIIImportDialog::setRunning(bool running) {
+    btnImport->setEnabled(!running);
+    comboDelimiter->setEnabled(!running);
+    for (QComboBox *c : mapCombos) c->setEnabled(!running);
+    btnClose->setText(running ? "Cancel" : "Close");
+}
+
+void LIIImportDialog::startImport() {
+    QMap<QString, int> mapping;
+    const QList<LIICsvImporter::Field> &fields = LIICsvImporter::fields();
+    for (int i = 0; i < fields.size(); ++i) {
+        int col = mapCombos[i]->currentData().toInt();
+        if (fields[i].required && col < 0) {
+            QMessageBox::warning(this, "Mapping Required",
+                                 QString("Please map a column to '%1'.").arg(fields[i].label));
+            return;
+        }
+        mapping[fields[i].key] = col;
+    }
+
+    imported = rejected = shownErrors = 0;
+    txtErrors->clear();
+    progressBar->setValue(0);
+    lblStatus->setText("Importing...");
+    setRunning(true);
+
+    workerThread = new QThread(this);
+    importer = new LIICsvImporter(txtFile->text(), currentDelimiter(), mapping);
+    importer->moveToThread(workerThread);
+
+    connect(workerThread, &QThread::started, importer, &LIICsvImporter::run);
+    connect(workerThread, &QThread::finished, importer, &QObject::deleteLater);
+    // Blocking: the reader waits for each commit, so at most one batch is in flight
+    connect(importer, &LIICsvImporter::batchReady, this, &LIIImportDialog::commitBatch, Qt::BlockingQueuedConnection);
+    connect(importer, &LIICsvImporter::rowRejected, this, &LIIImportDialog::recordRejected);
+    connect(importer, &LIICsvImporter::progress, this, &LIIImportDialog::updateProgress);
+    connect(importer, &LIICsvImporter::finished, this, &LIIImportDialog::importFinished);
+    workerThread->start();
+}
+
+void LIIImportDialog::commitBatch(const QList<QMap<QString, QVariant>> &rows, const QList<int> &lines) {
+    const QList<RowResult> results = DatabaseManager::instance().addLIIEntries(rows);
+    for (int i = 0; i < results.size(); ++i) {
+        if (results[i].ok) ++imported;
+        else recordRejected(lines.value(i), results[i].error);
+    }
+    lblStatus->setText(QString("Imported %1 rows, rejected %2...").arg(imported).arg(rejected));
+}
+
+void LIIImportDialog::recordRejected(int line, const QString &reason) {
+    ++rejected;
+    if (shownErrors < MAX_SHOWN_ERRORS) {
+        txtErrors->appendPlainText(QString("Line %1: %2").arg(line).arg(reason));
+        ++shownErrors;
+    } else if (shownErrors == MAX_SHOWN_ERRORS) {
+        txtErrors->appendPlainText("... further errors omitted.");
+        ++shownErrors;
+    }
+}
+
+void LIIImportDialog::updateProgress(qint64 bytesRead, qint64 totalBytes) {
+    if (totalBytes > 0) progressBar->setValue(int(bytesRead * 1000 / totalBytes));
+}
+
+void LIIImportDialog::importFinished(bool ok, const QString &error) {
+    workerThread->quit();
+    workerThread->wait();
+    workerThread->deleteLater();
+    workerThread = nullptr;
+    importer = nullptr;
+    setRunning(false);
+
+    QString summary = QString("Imported %1 rows, rejected %2.").arg(imported).arg(rejected);
+    if (!ok) summary += " " + error;
+    lblStatus->setText(summary);
+}
+
+void LIIImportDialog::reject() {
+    // Cancel first; the dialog can only close once the worker has stopped
+    if (importer) {
+        importer->cancel();
+        lblStatus->setText("Cancelling...");
+        return;
+    }
+    if (imported > 0) accept();
+    else QDialog::reject();
+}
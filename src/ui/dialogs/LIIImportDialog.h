@@ -0,0 +1,63 @@
+#ifndef LIIIMPORTDIALOG_H
+#define LIIIMPORTDIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QPlainTextEdit>
+#include <QThread>
+#include <QList>
+#include <QMap>
+#include <QVariant>
+
+class LIICsvImporter;
+
+// Column-mapping and progress dialog for bulk LII imports (PIT listings).
+// Parsing runs on a worker thread; each batch is committed here, on the
+// thread that owns the database connection, in a single transaction.
+class LIIImportDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit LIIImportDialog(QWidget *parent = nullptr);
+    ~LIIImportDialog();
+
+    int importedCount() const { return imported; }
+
+public slots:
+    void reject() override;
+
+private slots:
+    void browseFile();
+    void reloadHeader();
+    void startImport();
+    void commitBatch(const QList<QMap<QString, QVariant>> &rows, const QList<int> &lines);
+    void recordRejected(int line, const QString &reason);
+    void updateProgress(qint64 bytesRead, qint64 totalBytes);
+    void importFinished(bool ok, const QString &error);
+
+private:
+    void setupUI();
+    QChar currentDelimiter() const;
+    void setRunning(bool running);
+
+    QLineEdit *txtFile;
+    QComboBox *comboDelimiter;
+    QList<QComboBox*> mapCombos;   // one per LIICsvImporter::fields() entry
+    QProgressBar *progressBar;
+    QLabel *lblStatus;
+    QPlainTextEdit *txtErrors;
+    QPushButton *btnImport;
+    QPushButton *btnClose;
+
+    QThread *workerThread = nullptr;
+    LIICsvImporter *importer = nullptr;
+    int imported = 0;
+    int rejected = 0;
+    int shownErrors = 0;
+};
+
+#endif // LIIIMPORTDIALOG_H
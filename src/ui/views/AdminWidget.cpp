@@ -8,6 +8,7 @@
 #include <QMessageBox>
 #include <QLabel>
 #include <QGridLayout>
+#include <QShowEvent>
 
 AdminWidget::AdminWidget(QWidget *parent) : QWidget(parent) {
     setupUI();
@@ -34,6 +35,35 @@ void AdminWidget::setupUI() {
 
     // 2. Form (Hidden by default)
     setupFormSection(mainLayout);
+
+    // 3. Active storage profile of the inventory database
+    setupStorageSection(mainLayout);
+}
+
+void AdminWidget::setupStorageSection(QVBoxLayout *layout) {
+    QGroupBox *grp = new QGroupBox("Database Storage");
+    grp->setStyleSheet("background-color: #f9f9f9; border: 1px solid #ccc; margin-top: 10px; padding: 10px;");
+    QVBoxLayout *lay = new QVBoxLayout(grp);
+
+    lblStorageProfile = new QLabel;
+    lblStorageProfile->setWordWrap(true);
+    lblStorageProfile->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    lblStorageProfile->setStyleSheet("border: none; color: #003366;");
+    lay->addWidget(lblStorageProfile);
+
+    layout->addWidget(grp);
+    refreshStorageInfo();
+}
+
+void AdminWidget::refreshStorageInfo() {
+    lblStorageProfile->setText("<b>Active profile:</b> " + DatabaseManager::instance().storageProfileSummary()
+                               + "<br><b>File:</b> " + DatabaseManager::instance().currentDatabaseName());
+}
+
+void AdminWidget::showEvent(QShowEvent *event) {
+    // The profile changes when a training scenario starts or ends
+    refreshStorageInfo();
+    QWidget::showEvent(event);
 }
 
 void AdminWidget::setupListSection(QVBoxLayout *layout) {
@@ -17,6 +17,9 @@ class AdminWidget : public QWidget {
 public:
     explicit AdminWidget(QWidget *parent = nullptr);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private slots:
     void toggleAddForm();
     void validatePassword(const QString &pass);
@@ -27,7 +30,9 @@ private:
     void setupUI();
     void setupListSection(QVBoxLayout *layout);
     void setupFormSection(QVBoxLayout *layout);
+    void setupStorageSection(QVBoxLayout *layout);
     void refreshList();
+    void refreshStorageInfo();
     bool checkPasswordRules(const QString &pass);
 
     QTableWidget *userTable;
@@ -40,6 +45,9 @@ private:
     QListWidget *listMBAs; 
     QProgressBar *passStrength;
     QLabel *lblStrengthMsg;
+
+    // Storage
+    QLabel *lblStorageProfile;
 };
 
 #endif // ADMINWIDGET_H
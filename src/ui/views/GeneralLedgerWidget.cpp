@@ -1,8 +1,11 @@
 #include "GeneralLedgerWidget.h"
 #include "PinDialog.h"
 #include "../../db/DatabaseManager.h"
+#include "../../db/ReportJobQueue.h"
+#include "../../db/IntegrityVerifier.h"
 #include "../../utils/ReportGenerator.h"
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -15,6 +18,8 @@
 #include <QDebug>
 #include <QMap>
 #include <QSettings>
+#include <limits>
+#include <memory>
 
 // ── Shared GroupBox style — identical to MBRWidget, ReceiptWidget, LIIWidget, NLIWidget
 static const QString GB_STYLE =
@@ -80,8 +85,12 @@ static const QString BTN_DANGER =
 // ─────────────────────────────────────────────────────────────────────────
 
 GeneralLedgerWidget::GeneralLedgerWidget(QWidget *parent)
-    : QWidget(parent), lineCounter(1), balU(0), balU235(0), balItems(0) {
+    : QWidget(parent) {
     setupUI();
+    // A background full check rewrites the stored tamper flags: pick them up
+    connect(&IntegrityVerifier::scheduled(), &IntegrityVerifier::finished, this, [this](bool cancelled) {
+        if (!cancelled) refresh(false);
+    });
     refreshData();
 }
 
@@ -265,9 +274,9 @@ void GeneralLedgerWidget::setupInputForm(QVBoxLayout *layout) {
     btnAdd->setStyleSheet(BTN_PRIMARY); btnAdd->setMinimumHeight(32);
     connect(btnAdd, &QPushButton::clicked, this, &GeneralLedgerWidget::addEntry);
 
-    QPushButton *btnExport = new QPushButton("Export PDF");
+    QPushButton *btnExport = new QPushButton("Export");
     btnExport->setStyleSheet(BTN_DARK); btnExport->setMinimumHeight(32);
-    connect(btnExport, &QPushButton::clicked, this, &GeneralLedgerWidget::exportPDF);
+    connect(btnExport, &QPushButton::clicked, this, &GeneralLedgerWidget::exportReport);
 
     QPushButton *btnDel = new QPushButton("Delete Selected");
     btnDel->setStyleSheet(BTN_DANGER); btnDel->setMinimumHeight(32);
@@ -283,58 +292,64 @@ void GeneralLedgerWidget::setupInputForm(QVBoxLayout *layout) {
 }
 
 void GeneralLedgerWidget::setupComplexTable(QVBoxLayout *layout) {
-    table = new QTableWidget;
-    table->setColumnCount(16);
+    // Model rows 0-2 carry the merged three-row report header; the lines
+    // are served from the shared ledger cache as they scroll into view
+    model = new LedgerTableModel(this);
+    table = new QTableView;
+    table->setModel(model);
+    table->setItemDelegate(new LedgerDelegate(table));
+    LedgerTableModel::setHeaderSpans(table);
+    connect(model, &QAbstractItemModel::modelReset, table, [this]() { LedgerTableModel::setHeaderSpans(table); });
     table->verticalHeader()->setVisible(false);
     table->horizontalHeader()->setVisible(false);
+    // Fixed row heights: the view never measures rows it does not show
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     table->setAlternatingRowColors(true);
     table->setSelectionBehavior(QAbstractItemView::SelectRows);
     table->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table->setStyleSheet(
-        "QTableWidget {"
+        "QTableView {"
         "  border: 1px solid #003366;"
         "  gridline-color: #e0e0e0;"
         "}"
     );
-
-    table->insertRow(0);
-    table->insertRow(1);
-    table->insertRow(2);
-
-    auto setH = [&](int r, int c, QString txt) {
-        QTableWidgetItem *it = new QTableWidgetItem(txt);
-        it->setTextAlignment(Qt::AlignCenter);
-        it->setBackground(QColor("#dce8f5")); // Light blue — matches #003366 theme
-        it->setForeground(QColor("#003366"));
-        it->setFont(QFont("Arial", 9, QFont::Bold));
-        table->setItem(r, c, it);
-    };
-
-    setH(0, 0,  "Line");         table->setSpan(0, 0,  3, 1);
-    setH(0, 1,  "Date");         table->setSpan(0, 1,  3, 1);
-    setH(0, 2,  "ICD/PIL");      table->setSpan(0, 2,  3, 1);
-    setH(0, 3,  "IC Code");      table->setSpan(0, 3,  3, 1);
-    setH(0, 4,  "No. of\nItems");table->setSpan(0, 4,  3, 1);
-    setH(0, 5,  "Increases");    table->setSpan(0, 5,  1, 4);
-    setH(0, 9,  "Decreases");    table->setSpan(0, 9,  1, 4);
-    setH(0, 13, "Inventory");    table->setSpan(0, 13, 1, 2);
-    setH(0, 15, "No. of\nItems");table->setSpan(0, 15, 3, 1);
-
-    setH(1, 5,  "Receipts");     table->setSpan(1, 5,  1, 2);
-    setH(1, 7,  "Other");        table->setSpan(1, 7,  1, 2);
-    setH(1, 9,  "Shipments");    table->setSpan(1, 9,  1, 2);
-    setH(1, 11, "Other");        table->setSpan(1, 11, 1, 2);
-    setH(1, 13, "Bal");          table->setSpan(1, 13, 1, 2);
-
-    for (int i : {5, 7, 9, 11, 13})  setH(2, i, "U");
-    for (int i : {6, 8, 10, 12, 14}) setH(2, i, "U-235");
-
     table->setColumnWidth(0, 40);
     table->setColumnWidth(1, 80);
     table->setColumnWidth(3, 60);
     table->setColumnWidth(4, 50);
 
+    lblLoading = new QLabel("Loading...");
+    lblLoading->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    lblLoading->setVisible(LedgerCache::instance().isLoading());
+
+    // Balance as of a date, from the nearest checkpoint: no full ledger read
+    QHBoxLayout *asOfLay = new QHBoxLayout;
+    asOfLay->addWidget(new QLabel("Balance as of:"));
+    dateAsOf = new QDateEdit(QDate::currentDate());
+    dateAsOf->setCalendarPopup(true);
+    dateAsOf->setDisplayFormat("yyyy-MM-dd");
+    asOfLay->addWidget(dateAsOf);
+    lblAsOf = new QLabel;
+    lblAsOf->setStyleSheet("font-weight: bold; color: #003366;");
+    asOfLay->addWidget(lblAsOf);
+    asOfLay->addStretch();
+    connect(dateAsOf, &QDateEdit::dateChanged, this, &GeneralLedgerWidget::showBalanceAsOf);
+
+    layout->addWidget(lblLoading);
+    layout->addLayout(asOfLay);
     layout->addWidget(table);
+
+    connect(&LedgerCache::instance(), &LedgerCache::rowsChanged, this, [this]() {
+        lblLoading->setVisible(LedgerCache::instance().isLoading());
+        showBalanceAsOf();
+    });
+    showBalanceAsOf();
+}
+
+void GeneralLedgerWidget::showBalanceAsOf() {
+    const LedgerBalance bal = DatabaseManager::instance().balanceAsOf(dateAsOf->date().toString(Qt::ISODate));
+    lblAsOf->setText(QString("U: %1   U-235: %2   Items: %3")
+                         .arg(bal.u.toString(), bal.u235.toString(), QString::number(bal.items)));
 }
 
 // ─────────────────────────────────────────────────────────────────────────
@@ -356,7 +371,6 @@ data["code"]        = comboCode->currentText().isEmpty()
     data["items"] = spinItems ? (int)spinItems->value() : 0;
 
     if (DatabaseManager::instance().addManualLedgerEntry(data)) {
-        refreshData();
         emit dataChanged();
         txtRef->clear();
         spinElem->setValue(0);
@@ -366,7 +380,7 @@ data["code"]        = comboCode->currentText().isEmpty()
 }
 
 void GeneralLedgerWidget::deleteEntry() {
-    int row = table->currentRow();
+    int row = table->currentIndex().row();
 
     if (row < 3) {
         QMessageBox::warning(this, "Selection Error",
@@ -382,17 +396,13 @@ void GeneralLedgerWidget::deleteEntry() {
         }
     }
 
-    QTableWidgetItem *item = table->item(row, 1);
-    if (!item) return;
-
-    int id = item->data(Qt::UserRole).toInt();
+    const qint64 id = model->ledgerId(row);
     if (id == 0) return;
 
     if (QMessageBox::question(this, "Confirm Deletion",
             "Are you sure you want to delete this ledger entry?\nThis action cannot be undone.",
             QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
         if (DatabaseManager::instance().deleteManualLedgerEntry(id)) {
-            refreshData();
             emit dataChanged();
         } else {
             QMessageBox::critical(this, "Error", "Failed to delete entry from database.");
@@ -401,67 +411,20 @@ void GeneralLedgerWidget::deleteEntry() {
 }
 
 void GeneralLedgerWidget::refreshData() {
-    table->setRowCount(3);
-    balU = 0; balU235 = 0; balItems = 0; lineCounter = 1;
-
-    QSqlQuery q = DatabaseManager::instance().getManualLedgerEntries();
-    while (q.next()) {
-        int r = table->rowCount();
-        table->insertRow(r);
-
-        int     dbID  = q.value("id").toInt();
-        QString type  = q.value("type").toString();
-        double  u     = q.value("u_weight").toDouble();
-        double  u235  = q.value("u235_weight").toDouble();
-        int     items = q.value("items").toInt();
-
-        if      (type == "Receipt")                                 { balU += u; balU235 += u235; balItems += items; }
-        else if (type == "Shipment")                                { balU -= u; balU235 -= u235; balItems -= items; }
-        else if (type == "Other Increase")                          { balU += u; balU235 += u235; }
-        else if (type == "Other Decrease" || type == "Nuclear Loss"){ balU -= u; balU235 -= u235; }
-        else if (type == "PIL (Set Balance)") {
-            if (lineCounter == 1 && balU == 0) { balU = u; balU235 = u235; balItems = items; }
-        }
+    refresh(true);
+}
 
-        table->setItem(r, 0, new QTableWidgetItem(QString::number(lineCounter++)));
-
-        QTableWidgetItem *dateItem = new QTableWidgetItem(q.value("date").toString());
-        dateItem->setData(Qt::UserRole, dbID);
-        table->setItem(r, 1, dateItem);
-
-        table->setItem(r, 2, new QTableWidgetItem(q.value("ref").toString()));
-        table->setItem(r, 3, new QTableWidgetItem(q.value("code").toString()));
-
-        QString displayItems = "";
-        if (type == "Receipt" || type == "Shipment")
-            displayItems = (items > 0 ? QString::number(items) : "");
-        table->setItem(r, 4, new QTableWidgetItem(displayItems));
-
-        for (int i = 5; i <= 12; i++)
-            table->setItem(r, i, new QTableWidgetItem(""));
-
-        if      (type == "Receipt")                                  { table->setItem(r, 5,  new QTableWidgetItem(QString::number(u)));    table->setItem(r, 6,  new QTableWidgetItem(QString::number(u235))); }
-        else if (type == "Other Increase")                           { table->setItem(r, 7,  new QTableWidgetItem(QString::number(u)));    table->setItem(r, 8,  new QTableWidgetItem(QString::number(u235))); }
-        else if (type == "Shipment")                                 { table->setItem(r, 9,  new QTableWidgetItem(QString::number(u)));    table->setItem(r, 10, new QTableWidgetItem(QString::number(u235))); }
-        else if (type == "Other Decrease" || type == "Nuclear Loss") { table->setItem(r, 11, new QTableWidgetItem(QString::number(u)));    table->setItem(r, 12, new QTableWidgetItem(QString::number(u235))); }
-
-        auto makeBal = [&](int col, double val) {
-            QTableWidgetItem *it = new QTableWidgetItem(QString::number(val));
-            it->setBackground(QColor("#e8f5e9"));
-            it->setTextAlignment(Qt::AlignCenter);
-            table->setItem(r, col, it);
-        };
-        makeBal(13, balU);
-        makeBal(14, balU235);
-
-        QTableWidgetItem *b3 = new QTableWidgetItem(QString::number(balItems));
-        b3->setBackground(QColor("#e8f5e9"));
-        b3->setTextAlignment(Qt::AlignCenter);
-        table->setItem(r, 15, b3);
-    }
+void GeneralLedgerWidget::refresh(bool scheduleFullCheck) {
+    LedgerCache::instance().ensureLoaded();
+    // Tamper check: only lines added since the last check are hashed here;
+    // a full check that has come due runs in the background
+    const IntegrityStatus gl = DatabaseManager::instance().verifySignatures(RowSignature::Ledger);
+    model->setBroken(gl.brokenIds);
+    if (scheduleFullCheck && gl.fullCheckDue)
+        IntegrityVerifier::scheduled().start({ RowSignature::Ledger, RowSignature::MBR });
 }
 
-void GeneralLedgerWidget::exportPDF() {
+void GeneralLedgerWidget::exportReport() {
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
         PinDialog authDialog(this);
         if (authDialog.exec() != QDialog::Accepted) {
@@ -471,8 +434,9 @@ void GeneralLedgerWidget::exportPDF() {
     }
 
     QString fileName = QFileDialog::getSaveFileName(
-        this, "Save General Ledger", "GL_Report.pdf", "PDF Files (*.pdf)");
+        this, "Save General Ledger", "GL_Report.pdf", ReportGenerator::exportFilter());
     if (fileName.isEmpty()) return;
+    const bool table = ReportGenerator::isTable(fileName);
 
     QMap<QString, QString> header;
     header["facility"] = txtFacility->text();
@@ -482,11 +446,35 @@ void GeneralLedgerWidget::exportPDF() {
     header["isoCode"]  = txtIsoCode->text();
     header["unit"]     = txtUnit->text();
 
-    QSqlQuery data = DatabaseManager::instance().getManualLedgerEntries();
-
-    if (ReportGenerator::generateGL_PDF(fileName, header, data)) {
-        QMessageBox::information(this, "Success", "Report saved successfully.");
-    } else {
-        QMessageBox::critical(this, "Error", "Failed to save report.");
-    }
+    // Sidecar proof: inspectors check the exported lines against the published root.
+    // Exported in the same snapshot as the report, so it covers exactly its lines.
+    // Written with PDF (audit) exports only; spreadsheets are working copies.
+    QFileInfo fi(fileName);
+    const QString proofFile = fi.path() + "/" + fi.completeBaseName() + ".proof.json";
+    auto proofWritten = std::make_shared<bool>(false);
+
+    const QStringList outputs = table ? QStringList { fileName } : QStringList { fileName, proofFile };
+    ReportJobQueue::instance().submit("General Ledger", outputs, [fileName, header, table, proofFile, proofWritten](ReportJob &job) {
+        job.setTotalFromQuery("SELECT COUNT(*) FROM manual_ledger");
+        QSqlQuery data = job.cursor("SELECT * FROM manual_ledger ORDER BY id ASC");
+        if (!data.isActive()) return false;
+        QueryRowSource rows(data);
+        const auto tick = [&job]() { return job.advance(); };
+        if (!(table ? ReportGenerator::generateGL_Table(job.output(fileName), rows, tick)
+                    : ReportGenerator::generateGL_PDF(job.output(fileName), header, rows, tick)))
+            return false;
+        if (!table)
+            *proofWritten = DatabaseManager::instance().exportIntegrityProof(
+                RowSignature::Ledger, 0, std::numeric_limits<qint64>::max(), job.output(proofFile));
+        return true;
+    }, this, [this, table, proofFile, proofWritten](bool ok) {
+        if (ok) {
+            QString msg = "Report saved successfully.";
+            if (*proofWritten) msg += "\nIntegrity proof: " + proofFile;
+            else if (!table) msg += "\nThe integrity proof could not be written.";
+            QMessageBox::information(this, "Success", msg);
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to save report.");
+        }
+    });
 }
@@ -2,7 +2,7 @@
 #define GENERALLEDGERWIDGET_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QComboBox>
 #include <QLabel>
 #include <QLineEdit>
@@ -10,6 +10,7 @@
 #include <QDateEdit>
 #include <QVBoxLayout>
 #include <QPushButton>
+#include "LedgerTableModel.h"
 
 class GeneralLedgerWidget : public QWidget {
     Q_OBJECT
@@ -25,14 +26,16 @@ signals:
 
 private slots:
     void addEntry();
-    void exportPDF();
+    void exportReport();
     void deleteEntry();
 
 private:
+    void refresh(bool scheduleFullCheck);
     void setupUI();
     void setupReportHeader(QVBoxLayout *layout);
     void setupInputForm(QVBoxLayout *layout);
     void setupComplexTable(QVBoxLayout *layout);
+    void showBalanceAsOf();
 
     // Report Header Fields
     QLineEdit *txtFacility;
@@ -52,13 +55,11 @@ private:
     QLabel         *lblIsoField;
     
     // Display
-    QTableWidget *table;
-    int lineCounter;
-    
-    // Running Balances
-    double balU;
-    double balU235;
-    int balItems;
+    QTableView *table;
+    LedgerTableModel *model;
+    QLabel *lblLoading; // shown while the ledger cache loads
+    QDateEdit *dateAsOf;
+    QLabel *lblAsOf;    // running balance on dateAsOf
 };
 
 #endif // GENERALLEDGERWIDGET_H
@@ -3,8 +3,13 @@
 
 #include <QWidget>
 #include <QTableWidget>
+#include <QTableView>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QSet>
+#include "../../db/AsyncQuery.h"
+#include "../../db/LedgerCache.h"
+#include "LedgerTableModel.h"
 
 class HomeWidget : public QWidget {
     Q_OBJECT
@@ -14,15 +19,15 @@ public:
     void refreshData();
 
 private:
+    void refresh(bool scheduleFullCheck);
     void setupUI();
     void setupGLPreview(QVBoxLayout *layout);
+    void populateMBR(QueryResult &qMBR);
     QTableWidget *tableMBR;
-    QTableWidget *glTable;
-    // Helper state
-    double balU;
-    double balU235;
-    int balItems;
-    int lineCounter;
+    QTableView *glTable;
+    LedgerTableModel *glModel;
+    QLabel *lblLoading; // shown while the ledger cache loads
+    QSet<qint64> mbrBroken;
 };
 
 #endif // HOMEWIDGET_H
@@ -0,0 +1,185 @@
+#include "IntegrityAuditWidget.h"
+#include "../../db/DatabaseManager.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QGroupBox>
+#include <QColor>
+
+IntegrityAuditWidget::IntegrityAuditWidget(QWidget *parent) : QWidget(parent) {
+    verifier = new IntegrityVerifier(this);
+    setupUI();
+
+    connect(verifier, &IntegrityVerifier::findingsReady, this, &IntegrityAuditWidget::addFindings);
+    connect(verifier, &IntegrityVerifier::progress, this, &IntegrityAuditWidget::updateProgress);
+    connect(verifier, &IntegrityVerifier::finished, this, &IntegrityAuditWidget::auditFinished);
+}
+
+void IntegrityAuditWidget::setupUI() {
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(10, 10, 10, 10);
+
+    // Header Title
+    mainLayout->addWidget(new QLabel("<h2>Integrity Audit</h2>"));
+    QLabel *lblInfo = new QLabel("Re-verifies every signature in the selected records, using all processor cores. "
+                                 "Rows whose signature does not chain onto the previous row were edited, "
+                                 "inserted or had a neighbour removed outside AIR.");
+    lblInfo->setWordWrap(true);
+    lblInfo->setStyleSheet("color: #555;");
+    mainLayout->addWidget(lblInfo);
+
+    // Published roots + proof check
+    QGroupBox *grpRoots = new QGroupBox("Published Integrity Roots");
+    QHBoxLayout *rootLay = new QHBoxLayout(grpRoots);
+    lblRoots = new QLabel;
+    lblRoots->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    lblRoots->setStyleSheet("font-family: monospace;");
+    QPushButton *btnVerify = new QPushButton("Verify Proof File...");
+    btnVerify->setStyleSheet("background-color: #ecf0f1; border: 1px solid #ccc; padding: 6px 15px; font-weight: bold; color: #333;");
+    connect(btnVerify, &QPushButton::clicked, this, &IntegrityAuditWidget::verifyProofFile);
+    rootLay->addWidget(lblRoots, 1);
+    rootLay->addWidget(btnVerify);
+    mainLayout->addWidget(grpRoots);
+
+    // Scope + actions
+    QHBoxLayout *actionLay = new QHBoxLayout;
+    for (RowSignature::Table t : RowSignature::allTables()) {
+        QCheckBox *chk = new QCheckBox(RowSignature::displayName(t));
+        chk->setChecked(true);
+        chkTables.insert(t, chk);
+        actionLay->addWidget(chk);
+    }
+
+    btnStart = new QPushButton("Run Full Audit");
+    btnStart->setStyleSheet("background-color: #074282; color: white; font-weight: bold; padding: 6px 15px; border-radius: 4px; border: none;");
+    connect(btnStart, &QPushButton::clicked, this, &IntegrityAuditWidget::startAudit);
+
+    btnCancel = new QPushButton("Cancel");
+    btnCancel->setStyleSheet("background-color: #c0392b; color: white; font-weight: bold; padding: 6px 15px; border-radius: 4px; border: none;");
+    btnCancel->setEnabled(false);
+    connect(btnCancel, &QPushButton::clicked, this, &IntegrityAuditWidget::cancelAudit);
+
+    actionLay->addStretch();
+    actionLay->addWidget(btnStart);
+    actionLay->addWidget(btnCancel);
+    mainLayout->addLayout(actionLay);
+
+    progress = new QProgressBar;
+    progress->setRange(0, 1);
+    progress->setValue(0);
+    mainLayout->addWidget(progress);
+
+    lblSummary = new QLabel("No audit run in this session.");
+    lblSummary->setStyleSheet("font-weight: bold;");
+    mainLayout->addWidget(lblSummary);
+
+    // Findings
+    table = new QTableWidget;
+    table->setColumnCount(3);
+    table->setHorizontalHeaderLabels({"Record", "Row ID", "Status"});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setAlternatingRowColors(true);
+    table->setSortingEnabled(false);
+    mainLayout->addWidget(table);
+}
+
+void IntegrityAuditWidget::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    refreshRoots();
+}
+
+void IntegrityAuditWidget::refreshRoots() {
+    QStringList lines;
+    for (RowSignature::Table t : RowSignature::allTables()) {
+        qint64 leaves = 0;
+        const QByteArray root = DatabaseManager::instance().integrityRoot(t, &leaves);
+        lines << QString("%1 (%2 rows): %3")
+                 .arg(RowSignature::displayName(t))
+                 .arg(leaves)
+                 .arg(root.isEmpty() ? QString("-") : QString::fromLatin1(root.toHex()));
+    }
+    lblRoots->setText(lines.join("\n"));
+}
+
+void IntegrityAuditWidget::verifyProofFile() {
+    QString fileName = QFileDialog::getOpenFileName(this, "Open Integrity Proof", QString(),
+                                                    "Integrity Proofs (*.proof.json);;JSON Files (*.json)");
+    if (fileName.isEmpty()) return;
+
+    QString detail;
+    if (DatabaseManager::instance().verifyIntegrityProof(fileName, &detail))
+        QMessageBox::information(this, "Proof Verified", detail);
+    else
+        QMessageBox::warning(this, "Proof Not Verified", detail);
+}
+
+void IntegrityAuditWidget::startAudit() {
+    QList<RowSignature::Table> tables;
+    for (auto it = chkTables.constBegin(); it != chkTables.constEnd(); ++it) {
+        if (it.value()->isChecked()) tables << it.key();
+    }
+    if (tables.isEmpty()) {
+        QMessageBox::warning(this, "Validation", "Select at least one record to audit.");
+        return;
+    }
+
+    table->setRowCount(0);
+    lblSummary->setText("Auditing...");
+    lblSummary->setStyleSheet("font-weight: bold;");
+    btnStart->setEnabled(false);
+    btnCancel->setEnabled(true);
+    clock.start();
+    verifier->start(tables);
+}
+
+void IntegrityAuditWidget::cancelAudit() {
+    btnCancel->setEnabled(false);
+    lblSummary->setText("Cancelling...");
+    verifier->cancel();
+}
+
+void IntegrityAuditWidget::addFindings(const QList<IntegrityFinding> &findings) {
+    for (const IntegrityFinding &f : findings) {
+        int r = table->rowCount();
+        table->insertRow(r);
+        table->setItem(r, 0, new QTableWidgetItem(RowSignature::displayName(f.table)));
+        table->setItem(r, 1, new QTableWidgetItem(QString::number(f.id)));
+        QTableWidgetItem *status = new QTableWidgetItem(
+            f.status == IntegrityFinding::Unsigned ? "UNSIGNED" : "TAMPERED");
+        status->setForeground(QColor("red"));
+        status->setBackground(QColor("#ffcdd2"));
+        table->setItem(r, 2, status);
+    }
+}
+
+void IntegrityAuditWidget::updateProgress(qint64 rowsChecked, qint64 rowsTotal) {
+    // QProgressBar is int-ranged; work in permille
+    progress->setRange(0, 1000);
+    progress->setValue(rowsTotal > 0 ? int(rowsChecked * 1000 / rowsTotal) : 1000);
+    progress->setFormat(QString("%1 / %2 rows").arg(rowsChecked).arg(rowsTotal));
+}
+
+void IntegrityAuditWidget::auditFinished(bool cancelled) {
+    btnStart->setEnabled(true);
+    btnCancel->setEnabled(false);
+    refreshRoots();
+
+    const double secs = clock.elapsed() / 1000.0;
+    const int failures = table->rowCount();
+    if (cancelled) {
+        lblSummary->setText(QString("Audit cancelled after %1 s. %2 failing row(s) found so far.")
+                            .arg(secs, 0, 'f', 1).arg(failures));
+    } else if (failures == 0) {
+        lblSummary->setText(QString("Audit complete in %1 s: all signatures verified.").arg(secs, 0, 'f', 1));
+        lblSummary->setStyleSheet("font-weight: bold; color: #27ae60;");
+        return;
+    } else {
+        lblSummary->setText(QString("Audit complete in %1 s: %2 row(s) failed verification.")
+                            .arg(secs, 0, 'f', 1).arg(failures));
+    }
+    lblSummary->setStyleSheet("font-weight: bold; color: #c0392b;");
+}
@@ -0,0 +1,48 @@
+#ifndef INTEGRITYAUDITWIDGET_H
+#define INTEGRITYAUDITWIDGET_H
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QElapsedTimer>
+#include <QMap>
+#include "../../db/IntegrityVerifier.h"
+
+// Administration > Integrity Audit: full signature sweep of the signed
+// tables, run in parallel by IntegrityVerifier. Failing rows are listed as
+// they are found; the sweep can be cancelled at any time. Also shows the
+// current Merkle roots to publish and checks exported proof files.
+class IntegrityAuditWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit IntegrityAuditWidget(QWidget *parent = nullptr);
+
+private slots:
+    void startAudit();
+    void cancelAudit();
+    void addFindings(const QList<IntegrityFinding> &findings);
+    void updateProgress(qint64 rowsChecked, qint64 rowsTotal);
+    void auditFinished(bool cancelled);
+    void verifyProofFile();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void setupUI();
+    void refreshRoots();
+
+    IntegrityVerifier *verifier;
+    QMap<RowSignature::Table, QCheckBox *> chkTables; // audit scope
+    QPushButton *btnStart, *btnCancel;
+    QProgressBar *progress;
+    QLabel *lblSummary;
+    QLabel *lblRoots;
+    QTableWidget *table;
+    QElapsedTimer clock;
+};
+
+#endif // INTEGRITYAUDITWIDGET_H
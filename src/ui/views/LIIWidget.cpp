@@ -1,7 +1,10 @@
 #include "LIIWidget.h"
 #include "MaterialCodeDialog.h"
 #include "PinDialog.h"
+#include "LIIImportDialog.h"
 #include "../../db/DatabaseManager.h"
+#include "../../db/AsyncQuery.h"
+#include "../../db/ReportJobQueue.h"
 #include "../../utils/ReportGenerator.h"
 #include <QHeaderView>
 #include <QGridLayout>
@@ -68,7 +71,7 @@ static const QList<QPair<QString,QString>> COUNTRY_LIST = {
     {"UZ","Uzbekistan"},{"VE","Venezuela"},{"VN","Vietnam"},{"YE","Yemen"},{"ZW","Zimbabwe"},
 };
 
-LIIWidget::LIIWidget(QWidget *parent) : QWidget(parent), itemCounter(1) {
+LIIWidget::LIIWidget(QWidget *parent) : QWidget(parent) {
     setupUI(); loadData();
 }
 
@@ -195,12 +198,14 @@ void LIIWidget::setupInputForm(QVBoxLayout *layout) {
 
     QHBoxLayout *btnLayout = new QHBoxLayout; btnLayout->setSpacing(8);
     QPushButton *btnAdd = new QPushButton("Add Entry"); btnAdd->setStyleSheet(BTN_PRIMARY); btnAdd->setMinimumHeight(32);
-    QPushButton *btnExport = new QPushButton("Export PDF"); btnExport->setStyleSheet(BTN_DARK); btnExport->setMinimumHeight(32);
+    QPushButton *btnExport = new QPushButton("Export"); btnExport->setStyleSheet(BTN_DARK); btnExport->setMinimumHeight(32);
     QPushButton *btnDel = new QPushButton("Delete Selected"); btnDel->setStyleSheet(BTN_DANGER); btnDel->setMinimumHeight(32);
+    QPushButton *btnImport = new QPushButton("Import CSV"); btnImport->setStyleSheet(BTN_NEUTRAL); btnImport->setMinimumHeight(32);
     connect(btnAdd, &QPushButton::clicked, this, &LIIWidget::addItem);
-    connect(btnExport, &QPushButton::clicked, this, &LIIWidget::exportPDF);
+    connect(btnImport, &QPushButton::clicked, this, &LIIWidget::importCSV);
+    connect(btnExport, &QPushButton::clicked, this, &LIIWidget::exportReport);
     connect(btnDel, &QPushButton::clicked, this, &LIIWidget::deleteItem);
-    btnLayout->addWidget(btnAdd); btnLayout->addWidget(btnExport); btnLayout->addWidget(btnDel);
+    btnLayout->addWidget(btnAdd); btnLayout->addWidget(btnImport); btnLayout->addWidget(btnExport); btnLayout->addWidget(btnDel);
     grid->addLayout(btnLayout, 3, 4, 1, 2);
     layout->addWidget(grp);
 }
@@ -211,10 +216,24 @@ void LIIWidget::openMaterialCodeSelector() {
 }
 
 void LIIWidget::setupTable(QVBoxLayout *layout) {
-    table = new QTableWidget;
-    table->setColumnCount(11);
-    table->setHorizontalHeaderLabels({"KMP","Position","Item","Batch","Code (430)",
-        "Elem (g)","Fissile (g)","Pu (g)","Th (g)","Burnup","Cooling"});
+    model = new SqlPageModel(
+        [](const PageRequest &page, const QSqlDatabase &conn) { return DatabaseManager::instance().getLIIEntriesPage(page, conn); },
+        {
+            SqlPageModel::field("KMP", "kmp"),
+            SqlPageModel::field("Position", "position"),
+            SqlPageModel::constant("Item", "1"),
+            SqlPageModel::field("Batch", "batch"),
+            SqlPageModel::field("Code (430)", "desc"),
+            SqlPageModel::mass("Elem (g)", "weight_elem", 2),
+            SqlPageModel::mass("Fissile (g)", "weight_fissile", 3),
+            SqlPageModel::mass("Pu (g)", "weight_pu", 3),
+            SqlPageModel::constant("Th (g)", "0.0"),
+            { "Burnup", [](const SqlPageModel::Row &r) { return QString::number(r.value("burnup").toDouble()); } },
+            SqlPageModel::constant("Cooling", "-"),
+        }, this);
+
+    table = new QTableView;
+    table->setModel(model);
     table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     table->verticalHeader()->setVisible(false);
     table->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -222,8 +241,19 @@ void LIIWidget::setupTable(QVBoxLayout *layout) {
     table->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table->setStyleSheet("QHeaderView::section { background-color:#f0f0f0; font-weight:bold;"
         "border:1px solid #ccc; padding:4px; color:#003366; }"
-        "QTableWidget { border:1px solid #003366; gridline-color:#e0e0e0; }");
+        "QTableView { border:1px solid #003366; gridline-color:#e0e0e0; }");
+    lblLoading = new QLabel("Loading...");
+    lblLoading->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    lblLoading->hide();
+    connect(model, &SqlPageModel::loadingChanged, lblLoading, &QLabel::setVisible);
+    lblSignatures = new QLabel;
+    layout->addWidget(lblSignatures);
+    layout->addWidget(lblLoading);
     layout->addWidget(table);
+
+    signatures = new SignatureStatus(lblSignatures, { RowSignature::LII });
+    model->setAlert([this](const SqlPageModel::Row &r) { return signatures->isBroken(RowSignature::LII, r.id()); });
+    connect(signatures, &SignatureStatus::changed, model, &SqlPageModel::refreshAlerts);
 }
 
 void LIIWidget::addItem() {
@@ -237,56 +267,54 @@ void LIIWidget::addItem() {
     data["weight_fissile"] = spinFissile->value();
     data["weight_pu"]      = spinPu->value();
     data["burnup"]         = spinBurnup->value();
-    if (DatabaseManager::instance().addLIIEntry(data)) {
-        loadData();
+    WrittenRow written;
+    if (DatabaseManager::instance().addLIIEntry(data, &written)) {
+        model->appendRow(written);
         txtPosition->clear(); txtBatch->clear(); txtMaterialCode->clear();
         spinElem->setValue(0); spinFissile->setValue(0); spinPu->setValue(0); spinBurnup->setValue(0);
     } else QMessageBox::critical(this,"Error","Failed to save entry to database.");
 }
 
+void LIIWidget::importCSV() {
+    if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
+        PinDialog authDialog(this);
+        if (authDialog.exec() != QDialog::Accepted) { qDebug() << "Zero Trust: blocked."; return; }
+    }
+    LIIImportDialog dlg(this);
+    if (dlg.exec() == QDialog::Accepted) loadData();
+}
+
 void LIIWidget::deleteItem() {
-    int row = table->currentRow();
+    int row = table->currentIndex().row();
     if (row < 0) { QMessageBox::warning(this,"Select Item","Please select a row to delete."); return; }
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
         PinDialog authDialog(this);
         if (authDialog.exec() != QDialog::Accepted) { qDebug() << "Zero Trust: blocked."; return; }
     }
-    int id = table->item(row,0)->data(Qt::UserRole).toInt();
+    qint64 id = model->id(row);
     if (QMessageBox::question(this,"Confirm","Delete this inventory item?",QMessageBox::Yes|QMessageBox::No)==QMessageBox::Yes) {
-        if (DatabaseManager::instance().deleteLIIEntry(id)) loadData();
+        if (DatabaseManager::instance().deleteLIIEntry(id)) {
+            model->removeId(id);
+            signatures->refresh(); // the items after it were re-signed
+        }
         else QMessageBox::critical(this,"Error","Failed to delete item from database.");
     }
 }
 
 void LIIWidget::loadData() {
-    table->setRowCount(0);
-    QSqlQuery q = DatabaseManager::instance().getLIIEntries();
-    while (q.next()) {
-        int r = table->rowCount(); table->insertRow(r);
-        int dbID = q.value("id").toInt();
-        QTableWidgetItem *itemKMP = new QTableWidgetItem(q.value("kmp").toString());
-        itemKMP->setData(Qt::UserRole, dbID); table->setItem(r,0,itemKMP);
-        table->setItem(r,1,new QTableWidgetItem(q.value("position").toString()));
-        table->setItem(r,2,new QTableWidgetItem("1"));
-        table->setItem(r,3,new QTableWidgetItem(q.value("batch").toString()));
-        table->setItem(r,4,new QTableWidgetItem(q.value("desc").toString()));
-        table->setItem(r,5,new QTableWidgetItem(QString::number(q.value("weight_elem").toDouble(),'f',2)));
-        table->setItem(r,6,new QTableWidgetItem(QString::number(q.value("weight_fissile").toDouble(),'f',3)));
-        table->setItem(r,7,new QTableWidgetItem(QString::number(q.value("weight_pu").toDouble(),'f',3)));
-        table->setItem(r,8,new QTableWidgetItem("0.0"));
-        table->setItem(r,9,new QTableWidgetItem(QString::number(q.value("burnup").toDouble())));
-        table->setItem(r,10,new QTableWidgetItem("-"));
-    }
+    model->reload();
+    signatures->refresh();
 }
 
-void LIIWidget::exportPDF() {
-    if (table->rowCount() == 0) { QMessageBox::warning(this,"Export Error","The list is empty. Add items first."); return; }
+void LIIWidget::exportReport() {
+    if (model->rowCount() == 0 && !model->isLoading()) { QMessageBox::warning(this,"Export Error","The list is empty. Add items first."); return; }
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
         PinDialog authDialog(this);
         if (authDialog.exec() != QDialog::Accepted) { qDebug() << "Zero Trust: blocked."; return; }
     }
-    QString fileName = QFileDialog::getSaveFileName(this,"Save LII Report","LII_Report.pdf","PDF Files (*.pdf)");
+    QString fileName = QFileDialog::getSaveFileName(this,"Save LII Report","LII_Report.pdf",ReportGenerator::exportFilter());
     if (fileName.isEmpty()) return;
+    const bool table = ReportGenerator::isTable(fileName);
     QString countryCode = comboCountry->currentData().toString();
     if (countryCode.isEmpty()) countryCode = comboCountry->currentText().left(2).toUpper();
     QMap<QString,QString> headerData;
@@ -295,24 +323,18 @@ void LIIWidget::exportPDF() {
     headerData["mba"] = comboMBA->currentText();
     headerData["date"]     = dateReport->text();
     headerData["reportNo"] = QString::number(spinReportNo->value());
-    {
-        QSqlDatabase tempDb = QSqlDatabase::addDatabase("QSQLITE","TempLIIExport");
-        tempDb.setDatabaseName(":memory:"); if (!tempDb.open()) return;
-        QSqlQuery q(tempDb);
-        q.exec("CREATE TABLE temp_batches (kmp TEXT, position TEXT, batch TEXT, desc TEXT,"
-               "weight_elem REAL, weight_fissile REAL, weight_pu REAL, burnup REAL)");
-        for (int i=0; i<table->rowCount(); i++) {
-            q.prepare("INSERT INTO temp_batches VALUES (?,?,?,?,?,?,?,?)");
-            q.addBindValue(table->item(i,0)->text()); q.addBindValue(table->item(i,1)->text());
-            q.addBindValue(table->item(i,3)->text()); q.addBindValue(table->item(i,4)->text());
-            q.addBindValue(table->item(i,5)->text().toDouble()); q.addBindValue(table->item(i,6)->text().toDouble());
-            q.addBindValue(table->item(i,7)->text().toDouble()); q.addBindValue(table->item(i,9)->text().toDouble());
-            q.exec();
-        }
-        QSqlQuery rq(tempDb); rq.exec("SELECT * FROM temp_batches ORDER BY kmp ASC, batch ASC");
-        if (ReportGenerator::generateLII_PDF(fileName, headerData, rq))
-            QMessageBox::information(this,"Success","LII Report generated successfully.");
-        else QMessageBox::critical(this,"Error","Failed to generate PDF.");
-    }
-    QSqlDatabase::removeDatabase("TempLIIExport");
+
+    // Every item, read in the background from one snapshot of lii_manual
+    ReportJobQueue::instance().submit("List of Inventory Items", fileName, [fileName, headerData, table](ReportJob &job) {
+        job.setTotalFromQuery("SELECT COUNT(*) FROM lii_manual");
+        QSqlQuery rq = job.cursor("SELECT * FROM lii_manual ORDER BY kmp ASC, batch ASC");
+        if (!rq.isActive()) return false;
+        QueryRowSource rows(rq);
+        const auto tick = [&job]() { return job.advance(); };
+        return table ? ReportGenerator::generateLII_Table(job.output(fileName), rows, tick)
+                     : ReportGenerator::generateLII_PDF(job.output(fileName), headerData, rows, tick);
+    }, this, [this](bool ok) {
+        if (ok) QMessageBox::information(this,"Success","LII Report generated successfully.");
+        else QMessageBox::critical(this,"Error","Failed to generate report.");
+    });
 }
@@ -5,13 +5,15 @@
 #include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QSpinBox>
-#include <QTableWidget>
+#include <QTableView>
 #include <QGroupBox>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
 #include <QDateEdit>
 #include <QCompleter>
+#include "SqlPageModel.h"
+#include "SignatureStatus.h"
 
 class LIIWidget : public QWidget {
     Q_OBJECT
@@ -20,7 +22,8 @@ public:
     void loadData();
 private slots:
     void addItem();
-    void exportPDF();
+    void importCSV();
+    void exportReport();
     void deleteItem();
     void openMaterialCodeSelector();
 private:
@@ -38,7 +41,10 @@ private:
     QLineEdit    *txtBatch;
     QLineEdit    *txtMaterialCode;
     QDoubleSpinBox *spinElem, *spinFissile, *spinPu, *spinBurnup;
-    QTableWidget *table;
-    int itemCounter;
+    QTableView   *table;
+    QLabel       *lblLoading;     // shown while an async load is in flight
+    SqlPageModel *model;
+    QLabel       *lblSignatures;  // background signature check result
+    SignatureStatus *signatures;
 };
 #endif
@@ -0,0 +1,154 @@
+#include "LedgerTableModel.h"
+#include <QColor>
+#include <QFont>
+
+LedgerTableModel::LedgerTableModel(QObject *parent) : QAbstractTableModel(parent) {
+    lines = LedgerCache::instance().size();
+    connect(&LedgerCache::instance(), &LedgerCache::rowsChanged, this, &LedgerTableModel::cacheChanged);
+}
+
+int LedgerTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : HeaderRows + lines;
+}
+
+int LedgerTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : Columns;
+}
+
+qint64 LedgerTableModel::ledgerId(int row) const {
+    const int line = row - HeaderRows;
+    return line >= 0 && line < LedgerCache::instance().size() ? LedgerCache::instance().id(line) : 0;
+}
+
+void LedgerTableModel::setBroken(const QSet<qint64> &ids) {
+    if (ids == broken) return;
+    broken = ids;
+    if (lines > 0)
+        emit dataChanged(index(HeaderRows, 0), index(HeaderRows + lines - 1, Columns - 1), { TamperedRole });
+}
+
+// The cache has already changed; tell the view which rows moved
+void LedgerTableModel::cacheChanged(int firstRow) {
+    const int now = LedgerCache::instance().size();
+    if (firstRow == 0) {
+        beginResetModel();
+        lines = now;
+        endResetModel();
+        return;
+    }
+    if (now < lines) {
+        beginRemoveRows(QModelIndex(), HeaderRows + now, HeaderRows + lines - 1);
+        lines = now;
+        endRemoveRows();
+    }
+    const int kept = lines; // rows still shown, some with new contents
+    if (now > lines) {
+        beginInsertRows(QModelIndex(), HeaderRows + lines, HeaderRows + now - 1);
+        lines = now;
+        endInsertRows();
+    }
+    if (firstRow < kept)
+        emit dataChanged(index(HeaderRows + firstRow, 0), index(HeaderRows + kept - 1, Columns - 1));
+}
+
+QVariant LedgerTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) return QVariant();
+    const int line = index.row() - HeaderRows;
+    const int col = index.column();
+
+    switch (role) {
+    case HeaderRole:
+        return line < 0;
+    case BalanceRole:
+        return line >= 0 && col >= 13;
+    case TamperedRole:
+        return line >= 0 && broken.contains(ledgerId(index.row()));
+    case Qt::ToolTipRole:
+        if (line >= 0 && broken.contains(ledgerId(index.row())))
+            return "SECURITY ALERT: Row data altered outside application!";
+        return QVariant();
+    case Qt::DisplayRole:
+        if (line < 0) return headerText(index.row(), col);
+        if (line >= LedgerCache::instance().size()) return QVariant();
+        return cellText(line, col);
+    default:
+        return QVariant();
+    }
+}
+
+QString LedgerTableModel::headerText(int row, int column) const {
+    static const QStringList top = { "Line", "Date", "ICD/PIL", "IC Code", "No. of\nItems",
+        "Increases", "", "", "", "Decreases", "", "", "", "Inventory", "", "No. of\nItems" };
+    static const QStringList middle = { "", "", "", "", "",
+        "Receipts", "", "Other", "", "Shipments", "", "Other", "", "Bal", "", "" };
+    if (row == 0) return top[column];
+    if (row == 1) return middle[column];
+    if (column >= 5 && column <= 14) return column % 2 ? "U" : "U-235";
+    return QString();
+}
+
+int LedgerTableModel::weightColumn(LedgerBalanceEngine::Type type) {
+    switch (LedgerBalanceEngine::columnOf(type)) {
+    case LedgerBalanceEngine::Receipts:       return 5;
+    case LedgerBalanceEngine::OtherIncreases: return 7;
+    case LedgerBalanceEngine::Shipments:      return 9;
+    case LedgerBalanceEngine::OtherDecreases: return 11;
+    case LedgerBalanceEngine::NoColumn:       break;
+    }
+    return -1;
+}
+
+QString LedgerTableModel::cellText(int line, int column) const {
+    const LedgerCache &cache = LedgerCache::instance();
+    const LedgerCache::Type type = cache.type(line);
+
+    // Increases / decreases: the line's weights sit in the pair for its type
+    const int pair = weightColumn(type);
+
+    switch (column) {
+    case 0:  return QString::number(line + 1);
+    case 1:  return cache.date(line);
+    case 2:  return cache.ref(line);
+    case 3:  return cache.code(line);
+    case 4:
+        if (LedgerBalanceEngine::movesItems(type) && cache.items(line) > 0)
+            return QString::number(cache.items(line));
+        return QString();
+    case 13: return cache.balU(line).toString();
+    case 14: return cache.balU235(line).toString();
+    case 15: return QString::number(cache.balItems(line));
+    default:
+        if (column == pair)     return cache.u(line).toString();
+        if (column == pair + 1) return cache.u235(line).toString();
+        return QString();
+    }
+}
+
+void LedgerTableModel::setHeaderSpans(QTableView *view) {
+    for (int c : { 0, 1, 2, 3, 4, 15 }) view->setSpan(0, c, 3, 1);
+    view->setSpan(0, 5,  1, 4); // Increases
+    view->setSpan(0, 9,  1, 4); // Decreases
+    view->setSpan(0, 13, 1, 2); // Inventory
+    for (int c : { 5, 7, 9, 11, 13 }) view->setSpan(1, c, 1, 2);
+}
+
+// =========================================================
+// DELEGATE
+// =========================================================
+
+void LedgerDelegate::initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const {
+    QStyledItemDelegate::initStyleOption(option, index);
+
+    if (index.data(LedgerTableModel::HeaderRole).toBool()) {
+        option->backgroundBrush = QColor("#dce8f5"); // Light blue — matches #003366 theme
+        option->palette.setColor(QPalette::Text, QColor("#003366"));
+        option->font = QFont("Arial", 9, QFont::Bold);
+        option->displayAlignment = Qt::AlignCenter;
+    } else if (index.data(LedgerTableModel::TamperedRole).toBool()) {
+        option->backgroundBrush = QColor("#ffcdd2"); // Light Red
+        option->palette.setColor(QPalette::Text, QColor("red"));
+    } else if (index.data(LedgerTableModel::BalanceRole).toBool()) {
+        option->backgroundBrush = QColor("#e8f5e9");
+        option->displayAlignment = Qt::AlignCenter;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef LEDGERTABLEMODEL_H
+#define LEDGERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include <QTableView>
+#include <QSet>
+#include "../../db/LedgerCache.h"
+
+// General Ledger as a model over LedgerCache. Cells are formatted when the
+// view asks for them, so only the visible rows ever cost anything; nothing
+// is stored per cell. Model rows 0-2 are the report's three-row header
+// (merged with setHeaderSpans), ledger line i is model row i + 3.
+class LedgerTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum { HeaderRows = 3, Columns = 16 };
+    enum Role {
+        HeaderRole = Qt::UserRole + 1, // bool: one of the three header rows
+        BalanceRole,                   // bool: running balance column
+        TamperedRole,                  // bool: line fails its signature check
+    };
+
+    explicit LedgerTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setBroken(const QSet<qint64> &ids); // lines failing the signature chain
+    qint64 ledgerId(int row) const;          // 0 for header rows
+    static void setHeaderSpans(QTableView *view);
+    // First of the U / U-235 columns listing a line's weights, -1 for none
+    static int weightColumn(LedgerBalanceEngine::Type type);
+
+private:
+    void cacheChanged(int firstRow);
+    QString headerText(int row, int column) const;
+    QString cellText(int line, int column) const;
+
+    int lines = 0; // ledger lines the view has been told about
+    QSet<qint64> broken;
+};
+
+// Paints the header rows, the balance columns and tampered lines from the
+// model's roles, instead of a brush stored on every item
+class LedgerDelegate : public QStyledItemDelegate {
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+protected:
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override;
+};
+
+#endif // LEDGERTABLEMODEL_H
@@ -1,6 +1,8 @@
 #include "MBRWidget.h"
 #include "PinDialog.h"
 #include "../../db/DatabaseManager.h"
+#include "../../db/AsyncQuery.h"
+#include "../../db/ReportJobQueue.h"
 #include "../../utils/ReportGenerator.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -8,11 +10,14 @@
 #include <QLabel>
 #include <QHeaderView>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QDebug>
 #include <QSqlQuery>
 #include <QPushButton>
 #include <QSettings>
+#include <limits>
+#include <memory>
 
 static const QString GB_STYLE =
     "QGroupBox {"
@@ -290,10 +295,10 @@ void MBRWidget::setupInputForm() {
     btnAdd->setMinimumHeight(32);
     connect(btnAdd, &QPushButton::clicked, this, &MBRWidget::addEntry);
 
-    btnExport = new QPushButton("Export PDF");
+    btnExport = new QPushButton("Export");
     btnExport->setStyleSheet(BTN_DARK);
     btnExport->setMinimumHeight(32);
-    connect(btnExport, &QPushButton::clicked, this, &MBRWidget::exportPDF);
+    connect(btnExport, &QPushButton::clicked, this, &MBRWidget::exportReport);
 
     QPushButton *btnDel = new QPushButton("Delete Selected");
     btnDel->setStyleSheet(BTN_DANGER);
@@ -310,15 +315,22 @@ void MBRWidget::setupInputForm() {
 }
 
 void MBRWidget::setupTable() {
-    table = new QTableWidget();
-    table->setColumnCount(9);
-
-    table->setHorizontalHeaderLabels({
-        "Entry No.", "Continuation", "Entry\nName",
-        "Element", "Weight of Element", "Unit Kg/g",
-        "Weight Of Fissile\nIsotopes\n(Uranium Only)\n(G)",
-        "Isotope Code", "Report\nNo"
-    });
+    model = new SqlPageModel(
+        [](const PageRequest &page, const QSqlDatabase &conn) { return DatabaseManager::instance().getMBREntriesPage(page, conn); },
+        {
+            SqlPageModel::line("Entry No."),
+            SqlPageModel::field("Continuation", "continuation"),
+            SqlPageModel::field("Entry\nName", "entry_name"),
+            SqlPageModel::field("Element", "element"),
+            SqlPageModel::mass("Weight of Element", "weight"),
+            SqlPageModel::field("Unit Kg/g", "unit"),
+            SqlPageModel::mass("Weight Of Fissile\nIsotopes\n(Uranium Only)\n(G)", "fissile"),
+            SqlPageModel::field("Isotope Code", "isotope"),
+            SqlPageModel::field("Report\nNo", "report_no"),
+        }, this);
+
+    table = new QTableView();
+    table->setModel(model);
 
     table->verticalHeader()->setVisible(false);
     table->setAlternatingRowColors(true);
@@ -327,7 +339,7 @@ void MBRWidget::setupTable() {
     table->setStyleSheet(
         "QHeaderView::section { background-color: #f0f0f0; font-weight: bold;"
         "  border: 1px solid #ccc; padding: 4px; color: #003366; }"
-        "QTableWidget { border: 1px solid #003366; gridline-color: #e0e0e0; }"
+        "QTableView { border: 1px solid #003366; gridline-color: #e0e0e0; }"
     );
 
     table->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
@@ -341,6 +353,11 @@ void MBRWidget::setupTable() {
     table->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
     table->horizontalHeader()->setSectionResizeMode(6, QHeaderView::Stretch);
 
+    lblLoading = new QLabel("Loading...");
+    lblLoading->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    lblLoading->hide();
+    connect(model, &SqlPageModel::loadingChanged, lblLoading, &QLabel::setVisible);
+    layout()->addWidget(lblLoading);
     layout()->addWidget(table);
 }
 
@@ -363,8 +380,9 @@ void MBRWidget::addEntry() {
     data["isotope"]      = isotopeCode;
     data["report_no"]    = QString::number(spinEntryReportNo->value());
 
-    if (DatabaseManager::instance().addMBREntry(data)) {
-        loadData();
+    WrittenRow written;
+    if (DatabaseManager::instance().addMBREntry(data, &written)) {
+        model->appendRow(written);
         spinWeight->setValue(0);
         spinFissile->setValue(0);
         emit dataChanged();
@@ -374,7 +392,7 @@ void MBRWidget::addEntry() {
 }
 
 void MBRWidget::deleteEntry() {
-    int row = table->currentRow();
+    int row = table->currentIndex().row();
     if (row < 0) return;
 
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
@@ -385,46 +403,21 @@ void MBRWidget::deleteEntry() {
         }
     }
 
-    int id = table->item(row, 0)->data(Qt::UserRole).toInt();
+    qint64 id = model->id(row);
     if (QMessageBox::question(this, "Confirm", "Delete this entry?") == QMessageBox::Yes) {
         if (DatabaseManager::instance().deleteMBREntry(id)) {
-            loadData();
+            model->removeId(id);
             emit dataChanged();
         }
     }
 }
 
 void MBRWidget::loadData() {
-    table->setRowCount(0);
-    QSqlQuery q = DatabaseManager::instance().getMBREntries();
-
-    int line = 1;
-    while (q.next()) {
-        int r = table->rowCount();
-        table->insertRow(r);
-
-        int dbID = q.value("id").toInt();
-        QTableWidgetItem *itemLine = new QTableWidgetItem(QString::number(line++));
-        itemLine->setData(Qt::UserRole, dbID);
-        table->setItem(r, 0, itemLine);
-
-        table->setItem(r, 1, new QTableWidgetItem(q.value("continuation").toString()));
-        table->setItem(r, 2, new QTableWidgetItem(q.value("entry_name").toString()));
-        table->setItem(r, 3, new QTableWidgetItem(q.value("element").toString()));
-
-        double w = q.value("weight").toDouble();
-        double f = q.value("fissile").toDouble();
-
-        table->setItem(r, 4, new QTableWidgetItem(QString::number(w, 'f', w == qRound(w) ? 0 : 2)));
-        table->setItem(r, 5, new QTableWidgetItem(q.value("unit").toString()));
-        table->setItem(r, 6, new QTableWidgetItem(QString::number(f, 'f', f == qRound(f) ? 0 : 2)));
-        table->setItem(r, 7, new QTableWidgetItem(q.value("isotope").toString()));
-        table->setItem(r, 8, new QTableWidgetItem(q.value("report_no").toString()));
-    }
+    model->reload();
 }
 
-void MBRWidget::exportPDF() {
-    if (table->rowCount() == 0) {
+void MBRWidget::exportReport() {
+    if (model->rowCount() == 0 && !model->isLoading()) {
         QMessageBox::warning(this, "Export Error", "The list is empty. Add entries first.");
         return;
     }
@@ -438,8 +431,9 @@ void MBRWidget::exportPDF() {
     }
 
     QString fileName = QFileDialog::getSaveFileName(
-        this, "Save MBR", "MBR_Report.pdf", "PDF Files (*.pdf)");
+        this, "Save MBR", "MBR_Report.pdf", ReportGenerator::exportFilter());
     if (fileName.isEmpty()) return;
+    const bool table = ReportGenerator::isTable(fileName);
 
     // Extract country code from combo (e.g. "AT — Austria" → "AT")
     QString countryCode = comboCountry->currentData().toString();
@@ -454,9 +448,35 @@ void MBRWidget::exportPDF() {
     headerData["periodTo"]   = dateTo->text();
     headerData["reportNo"]   = QString::number(spinReportNo->value());
 
-    if (ReportGenerator::generateMBR_PDF(fileName, headerData, table)) {
-        QMessageBox::information(this, "Success", "MBR PDF generated successfully.");
-    } else {
-        QMessageBox::critical(this, "Error", "Failed to generate PDF.");
-    }
+    // Sidecar proof: inspectors check the exported entries against the published root.
+    // Exported in the same snapshot as the report, so it covers exactly its entries.
+    // Written with PDF (audit) exports only; spreadsheets are working copies.
+    QFileInfo fi(fileName);
+    const QString proofFile = fi.path() + "/" + fi.completeBaseName() + ".proof.json";
+    auto proofWritten = std::make_shared<bool>(false);
+
+    const QStringList outputs = table ? QStringList { fileName } : QStringList { fileName, proofFile };
+    ReportJobQueue::instance().submit("Material Balance Report", outputs, [fileName, headerData, table, proofFile, proofWritten](ReportJob &job) {
+        job.setTotalFromQuery("SELECT COUNT(*) FROM mbr_entries");
+        QSqlQuery data = job.cursor("SELECT * FROM mbr_entries ORDER BY id ASC");
+        if (!data.isActive()) return false;
+        QueryRowSource rows(data);
+        const auto tick = [&job]() { return job.advance(); };
+        if (!(table ? ReportGenerator::generateMBR_Table(job.output(fileName), rows, tick)
+                    : ReportGenerator::generateMBR_PDF(job.output(fileName), headerData, rows, tick)))
+            return false;
+        if (!table)
+            *proofWritten = DatabaseManager::instance().exportIntegrityProof(
+                RowSignature::MBR, 0, std::numeric_limits<qint64>::max(), job.output(proofFile));
+        return true;
+    }, this, [this, table, proofFile, proofWritten](bool ok) {
+        if (ok) {
+            QString msg = "MBR report generated successfully.";
+            if (*proofWritten) msg += "\nIntegrity proof: " + proofFile;
+            else if (!table) msg += "\nThe integrity proof could not be written.";
+            QMessageBox::information(this, "Success", msg);
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to generate report.");
+        }
+    });
 }
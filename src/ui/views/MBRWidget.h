@@ -2,7 +2,7 @@
 #define MBRWIDGET_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QDateEdit>
 #include <QPushButton>
@@ -11,6 +11,8 @@
 #include <QSpinBox>
 #include <QGroupBox>
 #include <QCompleter>
+#include <QLabel>
+#include "SqlPageModel.h"
 
 class MBRWidget : public QWidget {
     Q_OBJECT
@@ -24,7 +26,7 @@ signals:
 private slots:
     void addEntry();
     void deleteEntry();
-    void exportPDF();
+    void exportReport();
 
 private:
     void setupUI();
@@ -51,7 +53,9 @@ private:
     QSpinBox    *spinEntryReportNo; // Number only (was QLineEdit)
 
     // ── Table and Buttons ─────────────────────────────────────────────────
-    QTableWidget *table;
+    QTableView *table;
+    QLabel *lblLoading; // shown while an async load is in flight
+    SqlPageModel *model;
     QPushButton  *btnExport;
 };
 
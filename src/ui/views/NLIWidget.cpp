@@ -1,6 +1,8 @@
 #include "NLIWidget.h"
 #include "PinDialog.h"
 #include "../../db/DatabaseManager.h"
+#include "../../db/AsyncQuery.h"
+#include "../../db/ReportJobQueue.h"
 #include "../../utils/ReportGenerator.h"
 #include <QHeaderView>
 #include <QGridLayout>
@@ -61,7 +63,7 @@ static const QList<QPair<QString,QString>> COUNTRY_LIST = {
     {"UZ","Uzbekistan"},{"VE","Venezuela"},{"VN","Vietnam"},{"YE","Yemen"},{"ZW","Zimbabwe"},
 };
 
-NLIWidget::NLIWidget(QWidget *parent) : QWidget(parent), lineCounter(1) {
+NLIWidget::NLIWidget(QWidget *parent) : QWidget(parent) {
     setupUI(); loadData();
 }
 
@@ -185,10 +187,10 @@ void NLIWidget::setupInputForm(QVBoxLayout *layout) {
     // Row 3: Buttons
     QHBoxLayout *btnLay = new QHBoxLayout; btnLay->setSpacing(8); btnLay->addStretch();
     QPushButton *btnAdd = new QPushButton("Add Entry"); btnAdd->setStyleSheet(BTN_PRIMARY); btnAdd->setMinimumHeight(32);
-    QPushButton *btnExport = new QPushButton("Export PDF"); btnExport->setStyleSheet(BTN_DARK); btnExport->setMinimumHeight(32);
+    QPushButton *btnExport = new QPushButton("Export"); btnExport->setStyleSheet(BTN_DARK); btnExport->setMinimumHeight(32);
     QPushButton *btnDelete = new QPushButton("Delete Selected"); btnDelete->setStyleSheet(BTN_DANGER); btnDelete->setMinimumHeight(32);
     connect(btnAdd, &QPushButton::clicked, this, &NLIWidget::addEntry);
-    connect(btnExport, &QPushButton::clicked, this, &NLIWidget::exportPDF);
+    connect(btnExport, &QPushButton::clicked, this, &NLIWidget::exportReport);
     connect(btnDelete, &QPushButton::clicked, this, &NLIWidget::deleteEntry);
     btnLay->addWidget(btnAdd); btnLay->addWidget(btnExport); btnLay->addWidget(btnDelete);
     grid->addLayout(btnLay, 3, 0, 1, 6);
@@ -196,9 +198,22 @@ void NLIWidget::setupInputForm(QVBoxLayout *layout) {
 }
 
 void NLIWidget::setupTable(QVBoxLayout *layout) {
-    table = new QTableWidget; table->setColumnCount(10);
-    table->setHorizontalHeaderLabels({"Line","Batch","Items","Code",
-        "U Elem","U Iso","U Wt (g)","U Iso Wt (g)","P Elem","P Wt (g)"});
+    model = new SqlPageModel(
+        [](const PageRequest &page, const QSqlDatabase &conn) { return DatabaseManager::instance().getNLIEntriesPage(page, conn); },
+        {
+            SqlPageModel::line("Line"),
+            SqlPageModel::field("Batch", "batch"),
+            SqlPageModel::field("Items", "items"),
+            SqlPageModel::field("Code", "code"),
+            SqlPageModel::field("U Elem", "u_elem_code"),
+            SqlPageModel::field("U Iso", "u_iso_code"),
+            SqlPageModel::mass("U Wt (g)", "u_weight", 3),
+            SqlPageModel::mass("U Iso Wt (g)", "u_iso_weight", 3),
+            SqlPageModel::field("P Elem", "p_elem_code"),
+            SqlPageModel::mass("P Wt (g)", "p_weight", 3),
+        }, this);
+
+    table = new QTableView; table->setModel(model);
     table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     table->verticalHeader()->setVisible(false);
     table->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -206,28 +221,24 @@ void NLIWidget::setupTable(QVBoxLayout *layout) {
     table->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table->setStyleSheet("QHeaderView::section { background-color:#f0f0f0; font-weight:bold;"
         "border:1px solid #ccc; padding:4px; color:#003366; }"
-        "QTableWidget { border:1px solid #003366; gridline-color:#e0e0e0; }");
+        "QTableView { border:1px solid #003366; gridline-color:#e0e0e0; }");
+    lblLoading = new QLabel("Loading...");
+    lblLoading->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    lblLoading->hide();
+    connect(model, &SqlPageModel::loadingChanged, lblLoading, &QLabel::setVisible);
+    lblSignatures = new QLabel;
+    layout->addWidget(lblSignatures);
+    layout->addWidget(lblLoading);
     layout->addWidget(table);
+
+    signatures = new SignatureStatus(lblSignatures, { RowSignature::NLI });
+    model->setAlert([this](const SqlPageModel::Row &r) { return signatures->isBroken(RowSignature::NLI, r.id()); });
+    connect(signatures, &SignatureStatus::changed, model, &SqlPageModel::refreshAlerts);
 }
 
 void NLIWidget::loadData() {
-    table->setRowCount(0); lineCounter = 1;
-    QSqlQuery q = DatabaseManager::instance().getNLIEntries();
-    while (q.next()) {
-        int r = table->rowCount(); table->insertRow(r);
-        int dbID = q.value("id").toInt();
-        QTableWidgetItem *itemLine = new QTableWidgetItem(QString::number(lineCounter++));
-        itemLine->setData(Qt::UserRole, dbID); table->setItem(r,0,itemLine);
-        table->setItem(r,1,new QTableWidgetItem(q.value("batch").toString()));
-        table->setItem(r,2,new QTableWidgetItem(q.value("items").toString()));
-        table->setItem(r,3,new QTableWidgetItem(q.value("code").toString()));
-        table->setItem(r,4,new QTableWidgetItem(q.value("u_elem_code").toString()));
-        table->setItem(r,5,new QTableWidgetItem(q.value("u_iso_code").toString()));
-        table->setItem(r,6,new QTableWidgetItem(QString::number(q.value("u_weight").toDouble(),'f',3)));
-        table->setItem(r,7,new QTableWidgetItem(QString::number(q.value("u_iso_weight").toDouble(),'f',3)));
-        table->setItem(r,8,new QTableWidgetItem(q.value("p_elem_code").toString()));
-        table->setItem(r,9,new QTableWidgetItem(QString::number(q.value("p_weight").toDouble(),'f',3)));
-    }
+    model->reload();
+    signatures->refresh();
 }
 
 void NLIWidget::addEntry() {
@@ -241,34 +252,39 @@ void NLIWidget::addEntry() {
     data["u_iso_weight"] = spinUIsoWeight->value();
     data["p_elem_code"]  = txtPElemCode->text();
     data["p_weight"]     = spinPWeight->value();
-    if (DatabaseManager::instance().addNLIEntry(data)) {
-        loadData(); txtBatch->clear();
+    WrittenRow written;
+    if (DatabaseManager::instance().addNLIEntry(data, &written)) {
+        model->appendRow(written); txtBatch->clear();
         spinUWeight->setValue(0); spinUIsoWeight->setValue(0); spinPWeight->setValue(0);
     } else QMessageBox::critical(this,"Error","Failed to save entry to database.");
 }
 
 void NLIWidget::deleteEntry() {
-    int row = table->currentRow();
+    int row = table->currentIndex().row();
     if (row < 0) { QMessageBox::warning(this,"Select Item","Please select a row to delete."); return; }
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
         PinDialog authDialog(this);
         if (authDialog.exec() != QDialog::Accepted) { qDebug() << "Zero Trust: blocked."; return; }
     }
-    int id = table->item(row,0)->data(Qt::UserRole).toInt();
+    qint64 id = model->id(row);
     if (QMessageBox::question(this,"Confirm","Delete this nuclear loss entry?",QMessageBox::Yes|QMessageBox::No)==QMessageBox::Yes) {
-        if (DatabaseManager::instance().deleteNLIEntry(id)) loadData();
+        if (DatabaseManager::instance().deleteNLIEntry(id)) {
+            model->removeId(id);
+            signatures->refresh(); // the entries after it were re-signed
+        }
         else QMessageBox::critical(this,"Error","Failed to delete entry from database.");
     }
 }
 
-void NLIWidget::exportPDF() {
-    if (table->rowCount() == 0) { QMessageBox::warning(this,"Export Error","The list is empty."); return; }
+void NLIWidget::exportReport() {
+    if (model->rowCount() == 0 && !model->isLoading()) { QMessageBox::warning(this,"Export Error","The list is empty."); return; }
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
         PinDialog authDialog(this);
         if (authDialog.exec() != QDialog::Accepted) { qDebug() << "Zero Trust: blocked."; return; }
     }
-    QString fileName = QFileDialog::getSaveFileName(this,"Save NLI Report","NLI_Report.pdf","PDF Files (*.pdf)");
+    QString fileName = QFileDialog::getSaveFileName(this,"Save NLI Report","NLI_Report.pdf",ReportGenerator::exportFilter());
     if (fileName.isEmpty()) return;
+    const bool table = ReportGenerator::isTable(fileName);
     QString countryCode = comboCountry->currentData().toString();
     if (countryCode.isEmpty()) countryCode = comboCountry->currentText().left(2).toUpper();
     QMap<QString,QString> header;
@@ -277,25 +293,18 @@ void NLIWidget::exportPDF() {
     header["mba"] = comboMBA->currentText();
     header["date"]     = dateReport->text();
     header["reportNo"] = QString::number(spinReportNo->value());
-    {
-        QSqlDatabase tempDb = QSqlDatabase::addDatabase("QSQLITE","TempNLI");
-        tempDb.setDatabaseName(":memory:"); if (!tempDb.open()) return;
-        QSqlQuery q(tempDb);
-        q.exec("CREATE TABLE temp_nli (batch TEXT, items INTEGER, code TEXT,"
-               "u_elem_code TEXT, u_iso_code TEXT, u_weight REAL, u_iso_weight REAL,"
-               "p_elem_code TEXT, p_weight REAL)");
-        for (int i=0; i<table->rowCount(); i++) {
-            q.prepare("INSERT INTO temp_nli VALUES (?,?,?,?,?,?,?,?,?)");
-            q.addBindValue(table->item(i,1)->text()); q.addBindValue(table->item(i,2)->text().toInt());
-            q.addBindValue(table->item(i,3)->text()); q.addBindValue(table->item(i,4)->text());
-            q.addBindValue(table->item(i,5)->text()); q.addBindValue(table->item(i,6)->text().toDouble());
-            q.addBindValue(table->item(i,7)->text().toDouble()); q.addBindValue(table->item(i,8)->text());
-            q.addBindValue(table->item(i,9)->text().toDouble()); q.exec();
-        }
-        QSqlQuery pq(tempDb); pq.exec("SELECT * FROM temp_nli");
-        if (ReportGenerator::generateNLI_PDF(fileName, header, pq))
-            QMessageBox::information(this,"Success","NLI Report saved successfully.");
-        else QMessageBox::critical(this,"Error","Failed to generate PDF.");
-    }
-    QSqlDatabase::removeDatabase("TempNLI");
+
+    // Every entry, read in the background from one snapshot of nli_manual
+    ReportJobQueue::instance().submit("Nuclear Loss Items", fileName, [fileName, header, table](ReportJob &job) {
+        job.setTotalFromQuery("SELECT COUNT(*) FROM nli_manual");
+        QSqlQuery pq = job.cursor("SELECT * FROM nli_manual ORDER BY id ASC");
+        if (!pq.isActive()) return false;
+        QueryRowSource rows(pq);
+        const auto tick = [&job]() { return job.advance(); };
+        return table ? ReportGenerator::generateNLI_Table(job.output(fileName), rows, tick)
+                     : ReportGenerator::generateNLI_PDF(job.output(fileName), header, rows, tick);
+    }, this, [this](bool ok) {
+        if (ok) QMessageBox::information(this,"Success","NLI Report saved successfully.");
+        else QMessageBox::critical(this,"Error","Failed to generate report.");
+    });
 }
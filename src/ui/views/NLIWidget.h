@@ -5,13 +5,15 @@
 #include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QSpinBox>
-#include <QTableWidget>
+#include <QTableView>
 #include <QGroupBox>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
 #include <QDateEdit>
 #include <QCompleter>
+#include "SqlPageModel.h"
+#include "SignatureStatus.h"
 
 class NLIWidget : public QWidget {
     Q_OBJECT
@@ -20,7 +22,7 @@ public:
     void loadData();
 private slots:
     void addEntry();
-    void exportPDF();
+    void exportReport();
     void deleteEntry();
 private:
     void setupUI();
@@ -37,7 +39,10 @@ private:
     QComboBox    *comboCode;
     QLineEdit    *txtUElemCode, *txtUIsoCode, *txtPElemCode;
     QDoubleSpinBox *spinUWeight, *spinUIsoWeight, *spinPWeight;
-    QTableWidget *table;
-    int lineCounter;
+    QTableView *table;
+    QLabel *lblLoading; // shown while an async load is in flight
+    SqlPageModel *model;
+    QLabel *lblSignatures; // background signature check result
+    SignatureStatus *signatures;
 };
 #endif
@@ -1,6 +1,8 @@
 #include "ReceiptWidget.h"
 #include "PinDialog.h"
 #include "../../db/DatabaseManager.h"
+#include "../../db/AsyncQuery.h"
+#include "../../db/ReportJobQueue.h"
 #include "../../utils/ReportGenerator.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -287,10 +289,10 @@ void ReceiptWidget::setupInputForm(QVBoxLayout *layout) {
     btnSave->setMinimumHeight(32);
     connect(btnSave, &QPushButton::clicked, this, &ReceiptWidget::saveReceipt);
 
-    QPushButton *btnExport = new QPushButton("Export PDF");
+    QPushButton *btnExport = new QPushButton("Export");
     btnExport->setStyleSheet(BTN_DARK);
     btnExport->setMinimumHeight(32);
-    connect(btnExport, &QPushButton::clicked, this, &ReceiptWidget::exportPDF);
+    connect(btnExport, &QPushButton::clicked, this, &ReceiptWidget::exportReport);
 
     QPushButton *btnDelete = new QPushButton("Delete Selected");
     btnDelete->setStyleSheet(BTN_DANGER);
@@ -311,15 +313,31 @@ void ReceiptWidget::setupTable(QVBoxLayout *layout) {
     tableTitle->setStyleSheet("color: #003366; font-size: 10pt; margin-top: 4px;");
     layout->addWidget(tableTitle);
 
-    table = new QTableWidget;
-    table->setColumnCount(10);
-
-    QStringList headers;
-    headers << "Line" << "Batch Identity" << "Items" << "IC Code"
-            << "Elem\nCode (U)" << "Iso\nCode (U)" << "Elem\nWt (g)" << "Iso\nWt (g)"
-            << "Elem\nCode (P)" << "Elem\nWt (g)";
-
-    table->setHorizontalHeaderLabels(headers);
+    // Uranium lines fill the U columns, plutonium lines the P columns
+    auto uranium = [](const SqlPageModel::Row &r) { return r.value("element").toString().left(1) != "P"; };
+    model = new SqlPageModel(
+        [](const PageRequest &page, const QSqlDatabase &conn) { return DatabaseManager::instance().getReceiptsPage(page, conn); },
+        {
+            SqlPageModel::line("Line"),
+            SqlPageModel::field("Batch Identity", "batch_number"),
+            SqlPageModel::field("Items", "items_count"),
+            SqlPageModel::field("IC Code", "change_type"),
+            { "Elem\nCode (U)", [uranium](const SqlPageModel::Row &r) {
+                return uranium(r) ? r.value("element").toString().left(1) : QString(); } },
+            { "Iso\nCode (U)", [uranium](const SqlPageModel::Row &r) {
+                return uranium(r) ? QString("G") : QString(); } },
+            { "Elem\nWt (g)", [uranium](const SqlPageModel::Row &r) {
+                return uranium(r) ? Mass::fromStored(r.value("increase_u")).toString(2) : QString(); } },
+            { "Iso\nWt (g)", [uranium](const SqlPageModel::Row &r) {
+                return uranium(r) ? Mass::fromStored(r.value("weight_u235")).toString(3) : QString(); } },
+            { "Elem\nCode (P)", [uranium](const SqlPageModel::Row &r) {
+                return uranium(r) ? QString() : QString("P"); } },
+            { "Elem\nWt (g)", [uranium](const SqlPageModel::Row &r) {
+                return uranium(r) ? QString() : Mass::fromStored(r.value("increase_u")).toString(2); } },
+        }, this);
+
+    table = new QTableView;
+    table->setModel(model);
     table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     table->setAlternatingRowColors(true);
     table->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -333,13 +351,28 @@ void ReceiptWidget::setupTable(QVBoxLayout *layout) {
         "  padding: 4px;"
         "  color: #003366;"
         "}"
-        "QTableWidget {"
+        "QTableView {"
         "  border: 1px solid #003366;"
         "  gridline-color: #e0e0e0;"
         "}"
     );
 
+    lblLoading = new QLabel("Loading...");
+    lblLoading->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    lblLoading->hide();
+    connect(model, &SqlPageModel::loadingChanged, lblLoading, &QLabel::setVisible);
+    lblSignatures = new QLabel;
+    layout->addWidget(lblSignatures);
+    layout->addWidget(lblLoading);
     layout->addWidget(table);
+
+    // A receipt line shows its history row and the batch it received
+    signatures = new SignatureStatus(lblSignatures, { RowSignature::Batches, RowSignature::History });
+    model->setAlert([this](const SqlPageModel::Row &r) {
+        return signatures->isBroken(RowSignature::History, r.id())
+            || signatures->isBroken(RowSignature::Batches, r.value("batch_id").toLongLong());
+    });
+    connect(signatures, &SignatureStatus::changed, model, &SqlPageModel::refreshAlerts);
 }
 
 // ──────────────────────────────────────────────────────────────────────────
@@ -372,12 +405,13 @@ void ReceiptWidget::saveReceipt() {
     data["unit"]          = "g";
     data["manufacturer"]  = data["from_mba"];
 
-    if (DatabaseManager::instance().registerReceipt(data)) {
+    WrittenRow written;
+    if (DatabaseManager::instance().registerReceipt(data, &written)) {
         QMessageBox::information(this, "Success", "Receipt registered successfully.");
         txtBatch->clear();
         spinWeightU->setValue(0);
         spinWeightU235->setValue(0);
-        refreshTable();
+        model->appendRow(written);
         emit dataChanged();
     } else {
         QMessageBox::critical(this, "Error", "Failed to register receipt. Batch ID might exist.");
@@ -385,7 +419,7 @@ void ReceiptWidget::saveReceipt() {
 }
 
 void ReceiptWidget::deleteSelected() {
-    int row = table->currentRow();
+    int row = table->currentIndex().row();
     if (row < 0) {
         QMessageBox::warning(this, "Select Item", "Please select a row to delete.");
         return;
@@ -399,13 +433,14 @@ void ReceiptWidget::deleteSelected() {
         }
     }
 
-    int id = table->item(row, 0)->data(Qt::UserRole).toInt();
+    qint64 id = model->id(row);
 
     if (QMessageBox::question(this, "Confirm",
             "Delete this receipt entry?\nThis will remove it from the database.",
             QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
         if (DatabaseManager::instance().deleteReceipt(id)) {
-            refreshTable();
+            model->removeId(id);
+            signatures->refresh(); // the lines after it were re-signed
             emit dataChanged();
         } else {
             QMessageBox::critical(this, "Error", "Failed to delete receipt from database.");
@@ -414,51 +449,11 @@ void ReceiptWidget::deleteSelected() {
 }
 
 void ReceiptWidget::refreshTable() {
-    table->setRowCount(0);
-
-    QSqlQuery query = DatabaseManager::instance().getReceipts();
-
-    int line = 1;
-    while (query.next()) {
-        int r = table->rowCount();
-        table->insertRow(r);
-
-        int    id     = query.value("id").toInt();
-        QString batch = query.value("batch_number").toString();
-        QString code  = query.value("change_type").toString();
-        int    items  = query.value("items_count").toInt();
-        QString rawEl = query.value("element").toString();
-        QString elCode = rawEl.left(1);
-        double wElem  = query.value("increase_u").toDouble();
-        double wIso   = query.value("weight_u235").toDouble();
-
-        QTableWidgetItem *itemLine = new QTableWidgetItem(QString::number(line++));
-        itemLine->setData(Qt::UserRole, id);
-        table->setItem(r, 0, itemLine);
-
-        table->setItem(r, 1, new QTableWidgetItem(batch));
-        table->setItem(r, 2, new QTableWidgetItem(QString::number(items)));
-        table->setItem(r, 3, new QTableWidgetItem(code));
-
-        if (elCode != "P") {
-            table->setItem(r, 4, new QTableWidgetItem(elCode));
-            table->setItem(r, 5, new QTableWidgetItem("G"));
-            table->setItem(r, 6, new QTableWidgetItem(QString::number(wElem, 'f', 2)));
-            table->setItem(r, 7, new QTableWidgetItem(QString::number(wIso,  'f', 3)));
-            table->setItem(r, 8, new QTableWidgetItem(""));
-            table->setItem(r, 9, new QTableWidgetItem(""));
-        } else {
-            table->setItem(r, 4, new QTableWidgetItem(""));
-            table->setItem(r, 5, new QTableWidgetItem(""));
-            table->setItem(r, 6, new QTableWidgetItem(""));
-            table->setItem(r, 7, new QTableWidgetItem(""));
-            table->setItem(r, 8, new QTableWidgetItem("P"));
-            table->setItem(r, 9, new QTableWidgetItem(QString::number(wElem, 'f', 2)));
-        }
-    }
+    model->reload();
+    signatures->refresh();
 }
 
-void ReceiptWidget::exportPDF() {
+void ReceiptWidget::exportReport() {
     if (DatabaseManager::instance().currentDatabaseName().contains("AIR_Training")) {
         PinDialog authDialog(this);
         if (authDialog.exec() != QDialog::Accepted) {
@@ -468,8 +463,9 @@ void ReceiptWidget::exportPDF() {
     }
 
     QString fileName = QFileDialog::getSaveFileName(
-        this, "Save Receipt Report", "ICR_Full_Report.pdf", "PDF Files (*.pdf)");
+        this, "Save Receipt Report", "ICR_Full_Report.pdf", ReportGenerator::exportFilter());
     if (fileName.isEmpty()) return;
+    const bool table = ReportGenerator::isTable(fileName);
 
     QMap<QString, QString> headerData;
     headerData["country"]  = comboCountry->currentData().toString().isEmpty()
@@ -482,25 +478,31 @@ void ReceiptWidget::exportPDF() {
     headerData["shipper"]  = txtShipper->text();
     headerData["receiver"] = txtReceiver->text();
 
-    QString connectionName = DatabaseManager::instance().currentDatabaseName().isEmpty()
-                             ? "qt_sql_default_connection"
-                             : "air_connection";
-
-    QSqlDatabase db = QSqlDatabase::database(connectionName);
-    QSqlQuery query(db);
-
-    query.prepare(
-        "SELECT h.record_date, h.change_type, h.items_count, b.batch_number, "
-        "b.physical_form, b.element, h.increase_u, b.weight_u235, h.decrease_u, h.description "
-        "FROM history h JOIN batches b ON h.batch_id = b.id "
-        "WHERE h.change_type IN ('RD', 'RF', 'RN') "
-        "ORDER BY h.id ASC"
-    );
-    query.exec();
-
-    if (ReportGenerator::generateICR_PDF(fileName, headerData, query)) {
-        QMessageBox::information(this, "Success", "Full Receipt Report generated successfully.");
-    } else {
-        QMessageBox::critical(this, "Error", "Failed to generate PDF.");
-    }
+    // Generated in the background from one read snapshot; the operator keeps working
+    ReportJobQueue::instance().submit("Receipt Report (ICR)", fileName, [fileName, headerData, table](ReportJob &job) {
+        const QString receipts =
+            "FROM history h JOIN batches b ON h.batch_id = b.id "
+            "WHERE h.change_type IN ('RD', 'RF', 'RN') ";
+        job.setTotalFromQuery("SELECT COUNT(*) " + receipts);
+
+        QSqlQuery query(job.connection());
+        query.setForwardOnly(true);
+        query.prepare(
+            "SELECT h.record_date, h.change_type, h.items_count, b.batch_number, "
+            "b.physical_form, b.element, h.increase_u, b.weight_u235, h.decrease_u, h.description "
+            + receipts +
+            "ORDER BY h.id ASC"
+        );
+        if (!query.exec()) return false;
+        QueryRowSource rows(query);
+        const auto tick = [&job]() { return job.advance(); };
+        return table ? ReportGenerator::generateICR_Table(job.output(fileName), rows, tick)
+                     : ReportGenerator::generateICR_PDF(job.output(fileName), headerData, rows, tick);
+    }, this, [this](bool ok) {
+        if (ok) {
+            QMessageBox::information(this, "Success", "Full Receipt Report generated successfully.");
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to generate report.");
+        }
+    });
 }
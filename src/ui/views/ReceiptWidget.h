@@ -7,11 +7,13 @@
 #include <QDateEdit>
 #include <QSpinBox>
 #include <QDoubleSpinBox>
-#include <QTableWidget>
+#include <QTableView>
 #include <QGroupBox>
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QCompleter>
+#include "SqlPageModel.h"
+#include "SignatureStatus.h"
 
 class ReceiptWidget : public QWidget {
     Q_OBJECT
@@ -26,7 +28,7 @@ signals:
 
 private slots:
     void saveReceipt();
-    void exportPDF();
+    void exportReport();
     void deleteSelected();
 
 private:
@@ -57,7 +59,11 @@ private:
     QDateEdit      *dateEdit;
 
     // Display Table
-    QTableWidget *table;
+    QTableView *table;
+    QLabel *lblLoading; // shown while an async load is in flight
+    SqlPageModel *model;
+    QLabel *lblSignatures; // background signature check result
+    SignatureStatus *signatures;
 };
 
 #endif // RECEIPTWIDGET_H
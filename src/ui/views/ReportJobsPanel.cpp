@@ -0,0 +1,93 @@
+#include "ReportJobsPanel.h"
+#include "../../db/ReportJobQueue.h"
+#include <QHBoxLayout>
+#include <QLocale>
+#include <QTimer>
+
+// How long a finished job stays listed
+static const int LINGER_MS = 4000;
+
+ReportJobsPanel::ReportJobsPanel(QWidget *parent) : QWidget(parent) {
+    setObjectName("ReportJobsPanel");
+    setStyleSheet("QWidget#ReportJobsPanel { background-color: #f8f9fa; border-top: 1px solid #ccc; }");
+    lines = new QVBoxLayout(this);
+    lines->setContentsMargins(10, 4, 10, 4);
+    lines->setSpacing(2);
+    setVisible(false);
+
+    ReportJobQueue &queue = ReportJobQueue::instance();
+    connect(&queue, &ReportJobQueue::jobQueued, this, &ReportJobsPanel::addJob);
+    connect(&queue, &ReportJobQueue::jobStarted, this, &ReportJobsPanel::jobStarted);
+    connect(&queue, &ReportJobQueue::jobProgress, this, &ReportJobsPanel::updateProgress);
+    connect(&queue, &ReportJobQueue::jobFinished, this, &ReportJobsPanel::jobFinished);
+}
+
+void ReportJobsPanel::addJob(int jobId, const QString &title) {
+    Line line;
+    line.row = new QWidget;
+    QHBoxLayout *lay = new QHBoxLayout(line.row);
+    lay->setContentsMargins(0, 0, 0, 0);
+
+    QLabel *lblTitle = new QLabel(title);
+    lblTitle->setStyleSheet("font-weight: bold; color: #003366;");
+    line.status = new QLabel("Waiting...");
+    line.status->setStyleSheet("color: #7f8c8d;");
+    line.bar = new QProgressBar;
+    line.bar->setRange(0, 0); // busy until the row count is known
+    line.bar->setMaximumHeight(14);
+    line.bar->setTextVisible(false);
+    line.btnCancel = new QPushButton("Cancel");
+    line.btnCancel->setStyleSheet("background-color: #c0392b; color: white; font-weight: bold; padding: 2px 10px; border-radius: 4px; border: none;");
+    connect(line.btnCancel, &QPushButton::clicked, this, [jobId]() { ReportJobQueue::instance().cancel(jobId); });
+
+    lay->addWidget(lblTitle);
+    lay->addWidget(line.bar, 1);
+    lay->addWidget(line.status);
+    lay->addWidget(line.btnCancel);
+
+    lines->addWidget(line.row);
+    jobs.insert(jobId, line);
+    setVisible(true);
+}
+
+void ReportJobsPanel::jobStarted(int jobId) {
+    if (!jobs.contains(jobId)) return;
+    jobs[jobId].status->setText("Reading...");
+}
+
+void ReportJobsPanel::updateProgress(int jobId, qint64 rowsDone, qint64 rowsTotal) {
+    if (!jobs.contains(jobId)) return;
+    const Line &line = jobs[jobId];
+    if (rowsTotal > 0) {
+        line.bar->setRange(0, 100);
+        line.bar->setValue(int(qMin<qint64>(100, rowsDone * 100 / rowsTotal)));
+        line.status->setText(QString("%1 of %2 rows")
+                             .arg(QLocale().toString(rowsDone), QLocale().toString(rowsTotal)));
+    } else {
+        line.status->setText(QString("%1 rows").arg(QLocale().toString(rowsDone)));
+    }
+}
+
+void ReportJobsPanel::jobFinished(int jobId, bool ok, bool cancelled) {
+    if (!jobs.contains(jobId)) return;
+    const Line &line = jobs[jobId];
+    line.btnCancel->setVisible(false);
+    line.bar->setRange(0, 100);
+    line.bar->setValue(ok ? 100 : 0);
+    if (cancelled) {
+        line.status->setText("Cancelled");
+        line.status->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    } else if (ok) {
+        line.status->setText("Done");
+        line.status->setStyleSheet("color: #27ae60; font-weight: bold;");
+    } else {
+        line.status->setText("Failed");
+        line.status->setStyleSheet("color: red; font-weight: bold;");
+    }
+
+    QTimer::singleShot(LINGER_MS, this, [this, jobId]() {
+        const Line line = jobs.take(jobId);
+        if (line.row) line.row->deleteLater();
+        if (jobs.isEmpty()) setVisible(false);
+    });
+}
@@ -0,0 +1,38 @@
+#ifndef REPORTJOBSPANEL_H
+#define REPORTJOBSPANEL_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QHash>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+
+// Strip under the pages listing the report exports in flight
+// (ReportJobQueue): one line per job with its progress and a Cancel
+// button. Finished jobs stay a few seconds with their outcome; the strip
+// hides itself when nothing is listed.
+class ReportJobsPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit ReportJobsPanel(QWidget *parent = nullptr);
+
+private slots:
+    void addJob(int jobId, const QString &title);
+    void jobStarted(int jobId);
+    void updateProgress(int jobId, qint64 rowsDone, qint64 rowsTotal);
+    void jobFinished(int jobId, bool ok, bool cancelled);
+
+private:
+    struct Line {
+        QWidget *row = nullptr;
+        QLabel *status = nullptr;
+        QProgressBar *bar = nullptr;
+        QPushButton *btnCancel = nullptr;
+    };
+
+    QVBoxLayout *lines;
+    QHash<int, Line> jobs;
+};
+
+#endif // REPORTJOBSPANEL_H
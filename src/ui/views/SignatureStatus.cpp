@@ -0,0 +1,56 @@
+#include "SignatureStatus.h"
+#include <QLocale>
+
+SignatureStatus::SignatureStatus(QLabel *label, const QList<RowSignature::Table> &tables)
+    : QObject(label), label(label), tables(tables) {
+    verifier = new IntegrityVerifier(this);
+    connect(verifier, &IntegrityVerifier::findingsReady, this, &SignatureStatus::addFindings);
+    connect(verifier, &IntegrityVerifier::progress, this, &SignatureStatus::updateProgress);
+    connect(verifier, &IntegrityVerifier::finished, this, &SignatureStatus::sweepFinished);
+}
+
+void SignatureStatus::refresh() {
+    // A sweep in flight may have read rows from before the change: restart it
+    if (verifier->isRunning()) {
+        rerun = true;
+        verifier->cancel();
+        return;
+    }
+    found.clear();
+    label->setText("Verifying signatures...");
+    label->setStyleSheet("color: #7f8c8d; font-style: italic;");
+    verifier->start(tables);
+}
+
+void SignatureStatus::addFindings(const QList<IntegrityFinding> &findings) {
+    for (const IntegrityFinding &f : findings) found[f.table].insert(f.id);
+}
+
+void SignatureStatus::updateProgress(qint64 rowsChecked, qint64 rowsTotal) {
+    this->rowsTotal = rowsTotal;
+    if (rowsTotal == 0) return;
+    label->setText(QString("Verifying signatures... %1 of %2 rows")
+                   .arg(QLocale().toString(rowsChecked), QLocale().toString(rowsTotal)));
+}
+
+void SignatureStatus::sweepFinished(bool cancelled) {
+    if (rerun) {
+        rerun = false;
+        refresh();
+        return;
+    }
+    if (cancelled) return;
+
+    broken = found;
+    int failures = 0;
+    for (const QSet<qint64> &ids : broken) failures += ids.size();
+
+    if (failures == 0) {
+        label->setText(QString("Signatures verified (%1 rows)").arg(QLocale().toString(rowsTotal)));
+        label->setStyleSheet("color: #27ae60; font-weight: bold;");
+    } else {
+        label->setText(QString("SECURITY ALERT: %1 record(s) altered outside AIR").arg(failures));
+        label->setStyleSheet("color: red; font-weight: bold;");
+    }
+    emit changed();
+}
@@ -0,0 +1,42 @@
+#ifndef SIGNATURESTATUS_H
+#define SIGNATURESTATUS_H
+
+#include <QObject>
+#include <QLabel>
+#include <QHash>
+#include <QSet>
+#include "../../db/IntegrityVerifier.h"
+
+// Signature verification status of a listing. refresh() sweeps the view's
+// signed tables with an IntegrityVerifier (off the GUI thread, on every
+// core) and the label follows progress and result. Views ask isBroken()
+// for the record(s) a row shows - SqlPageModel's alert predicate - and
+// repaint on changed().
+class SignatureStatus : public QObject {
+    Q_OBJECT
+
+public:
+    SignatureStatus(QLabel *label, const QList<RowSignature::Table> &tables);
+
+    void refresh();
+    bool isBroken(RowSignature::Table table, qint64 id) const { return broken.value(table).contains(id); }
+
+signals:
+    void changed(); // a sweep completed; isBroken() answers may differ
+
+private:
+    void addFindings(const QList<IntegrityFinding> &findings);
+    void updateProgress(qint64 rowsChecked, qint64 rowsTotal);
+    void sweepFinished(bool cancelled);
+
+    QLabel *label;
+    QList<RowSignature::Table> tables;
+    IntegrityVerifier *verifier;
+
+    QHash<int, QSet<qint64>> broken;  // last completed sweep, by table
+    QHash<int, QSet<qint64>> found;   // sweep in progress
+    qint64 rowsTotal = 0;
+    bool rerun = false;               // refresh() came in during a sweep
+};
+
+#endif // SIGNATURESTATUS_H
@@ -0,0 +1,208 @@
+#include "SqlPageModel.h"
+#include <QColor>
+#include <algorithm>
+#include <utility>
+
+qint64 SqlPageModel::Row::id() const {
+    return model->id(index);
+}
+
+QVariant SqlPageModel::Row::value(const QString &field) const {
+    const int c = model->fields.value(field, -1);
+    return c < 0 ? QVariant() : model->values.at(index).value(c);
+}
+
+SqlPageModel::Column SqlPageModel::field(const QString &header, const QString &name) {
+    return { header, [name](const Row &r) { return r.value(name).toString(); } };
+}
+
+SqlPageModel::Column SqlPageModel::mass(const QString &header, const QString &name, int decimals) {
+    return { header, [name, decimals](const Row &r) { return Mass::fromStored(r.value(name)).toString(decimals); } };
+}
+
+SqlPageModel::Column SqlPageModel::mass(const QString &header, const QString &name) {
+    return { header, [name](const Row &r) { return Mass::fromStored(r.value(name)).toString(); } };
+}
+
+SqlPageModel::Column SqlPageModel::line(const QString &header) {
+    return { header, [](const Row &r) { return QString::number(r.line()); } };
+}
+
+SqlPageModel::Column SqlPageModel::constant(const QString &header, const QString &text) {
+    return { header, [text](const Row &) { return text; } };
+}
+
+SqlPageModel::SqlPageModel(PageQuery query, QList<Column> columns, QObject *parent, int pageSize)
+    : QAbstractTableModel(parent), query(std::move(query)), columns(std::move(columns)), pageSize(pageSize) {}
+
+// =========================================================
+// FETCHING
+// =========================================================
+
+void SqlPageModel::reload() {
+    // Rows stay listed until the first page replaces them
+    lastId = 0;
+    atEnd = false;
+    fetch(true);
+}
+
+bool SqlPageModel::canFetchMore(const QModelIndex &parent) const {
+    return !parent.isValid() && !atEnd && !busy;
+}
+
+void SqlPageModel::fetchMore(const QModelIndex &parent) {
+    if (canFetchMore(parent)) fetch(false);
+}
+
+void SqlPageModel::fetch(bool firstPage) {
+    setBusy(true);
+
+    PageRequest page;
+    page.afterId = lastId;
+    page.pageSize = pageSize;
+    PageQuery q = query;
+    // Same tag for every page: a reload supersedes a page still in flight
+    AsyncQuery::instance().submit(this, "page",
+        [q, page](const QSqlDatabase &conn) { return q(page, conn); },
+        [this, firstPage](QueryResult rows) { accept(rows, firstPage); });
+}
+
+void SqlPageModel::accept(QueryResult &rows, bool firstPage) {
+    append(rows, firstPage);
+    setBusy(false);
+}
+
+void SqlPageModel::append(QueryResult &rows, bool firstPage) {
+    const int n = rows.size();
+    if (n > 0) lastId = rows.valueAt(n - 1, "id").toLongLong();
+    atEnd = n < pageSize;
+
+    if (firstPage) {
+        beginResetModel();
+        ids.clear();
+        values.clear();
+        fields.clear();
+        const QStringList names = rows.columnNames();
+        for (int i = 0; i < names.size(); ++i) fields.insert(names[i], i);
+    } else if (n > 0) {
+        beginInsertRows(QModelIndex(), ids.size(), ids.size() + n - 1);
+    }
+
+    const int width = fields.size();
+    const int idColumn = fields.value("id", -1);
+    ids.reserve(ids.size() + n);
+    values.reserve(values.size() + n);
+    while (rows.next()) {
+        QVariantList row;
+        row.reserve(width);
+        for (int c = 0; c < width; ++c) row << rows.value(c);
+        ids << row.value(idColumn).toLongLong();
+        values << row;
+    }
+
+    if (firstPage) endResetModel();
+    else if (n > 0) endInsertRows();
+
+    // Rows written while this page was read, unless the page already had them
+    const QList<WrittenRow> pending = std::exchange(written, {});
+    if (!atEnd) return; // later pages will bring them
+    for (const WrittenRow &row : pending) {
+        if (ids.isEmpty() || row.id > ids.last()) insertWritten(row);
+    }
+}
+
+// =========================================================
+// PATCHING
+// =========================================================
+
+void SqlPageModel::appendRow(const WrittenRow &row) {
+    if (row.id <= 0) { reload(); return; } // not read back: list again
+    if (busy) { written << row; return; }  // the page in flight may or may not have it
+    if (atEnd) insertWritten(row);         // otherwise a later page brings it
+}
+
+void SqlPageModel::insertWritten(const WrittenRow &row) {
+    if (fields.isEmpty()) {
+        int c = 0;
+        for (auto it = row.values.cbegin(); it != row.values.cend(); ++it) fields.insert(it.key(), c++);
+    }
+    QVariantList rowValues(fields.size());
+    for (auto it = fields.cbegin(); it != fields.cend(); ++it) rowValues[it.value()] = row.values.value(it.key());
+
+    beginInsertRows(QModelIndex(), ids.size(), ids.size());
+    ids << row.id;
+    values << rowValues;
+    lastId = row.id;
+    endInsertRows();
+}
+
+void SqlPageModel::removeId(qint64 id) {
+    auto it = std::lower_bound(ids.cbegin(), ids.cend(), id);
+    if (it == ids.cend() || *it != id) return;
+    const int r = int(it - ids.cbegin());
+
+    beginRemoveRows(QModelIndex(), r, r);
+    ids.remove(r);
+    values.removeAt(r);
+    endRemoveRows();
+
+    // Line numbers below it moved up by one
+    if (r < ids.size())
+        emit dataChanged(index(r, 0), index(ids.size() - 1, columns.size() - 1), { Qt::DisplayRole });
+}
+
+void SqlPageModel::setBusy(bool on) {
+    if (busy == on) return;
+    busy = on;
+    emit loadingChanged(on);
+}
+
+// =========================================================
+// MODEL
+// =========================================================
+
+void SqlPageModel::setAlert(Alert predicate) {
+    alert = std::move(predicate);
+    refreshAlerts();
+}
+
+void SqlPageModel::refreshAlerts() {
+    if (!ids.isEmpty())
+        emit dataChanged(index(0, 0), index(ids.size() - 1, columns.size() - 1),
+                         { Qt::BackgroundRole, Qt::ForegroundRole, Qt::ToolTipRole });
+}
+
+int SqlPageModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ids.size();
+}
+
+int SqlPageModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : columns.size();
+}
+
+QVariant SqlPageModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= ids.size()) return QVariant();
+    const Row r = row(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return columns.at(index.column()).text(r);
+    case Qt::BackgroundRole:
+        if (alert && alert(r)) return QColor("#ffcdd2"); // Light Red
+        return QVariant();
+    case Qt::ForegroundRole:
+        if (alert && alert(r)) return QColor("red");
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (alert && alert(r)) return "SECURITY ALERT: Row data altered outside application!";
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant SqlPageModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section < columns.size())
+        return columns.at(section).header;
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
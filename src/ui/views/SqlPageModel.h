@@ -0,0 +1,101 @@
+#ifndef SQLPAGEMODEL_H
+#define SQLPAGEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+#include <functional>
+#include "../../db/DatabaseManager.h"
+#include "../../db/AsyncQuery.h"
+
+// Listing over a keyset page query (DatabaseManager::get*Page), fetched
+// lazily: reload() reads the first page off the GUI thread and the view
+// asks for the next one through canFetchMore()/fetchMore() when it scrolls
+// to the bottom, so the first paint costs one page however big the table is.
+//
+// Rows keep the query's values and the database id; cells are formatted by
+// the view's column list when they are painted, nothing is stored per cell.
+// Rows the alert predicate holds for are shown as tampered.
+//
+// After the view's own writes the listing is patched rather than reloaded:
+// appendRow() takes the row as DatabaseManager wrote it, removeId() drops
+// a deleted one.
+class SqlPageModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    using PageQuery = std::function<QSqlQuery(const PageRequest &, const QSqlDatabase &)>;
+
+    // One listed row, as seen by column formatters and the alert predicate
+    class Row {
+    public:
+        qint64 id() const;
+        int line() const { return index + 1; } // 1-based position in the listing
+        QVariant value(const QString &field) const;
+
+    private:
+        friend class SqlPageModel;
+        Row(const SqlPageModel *model, int index) : model(model), index(index) {}
+        const SqlPageModel *model;
+        int index;
+    };
+
+    struct Column {
+        QString header;
+        std::function<QString(const Row &)> text;
+    };
+    static Column field(const QString &header, const QString &name);                // value as text
+    static Column mass(const QString &header, const QString &name, int decimals);   // mg column, in grams
+    static Column mass(const QString &header, const QString &name);                 // grams, digits as needed
+    static Column line(const QString &header);                                       // 1, 2, 3...
+    static Column constant(const QString &header, const QString &text);
+
+    using Alert = std::function<bool(const Row &)>;
+
+    SqlPageModel(PageQuery query, QList<Column> columns, QObject *parent = nullptr, int pageSize = 200);
+
+    void reload();
+    bool isLoading() const { return busy; }
+
+    void appendRow(const WrittenRow &row); // row committed after the last one listed
+    void removeId(qint64 id);
+
+    Row row(int r) const { return Row(this, r); }
+    qint64 id(int r) const { return r >= 0 && r < ids.size() ? ids[r] : 0; }
+
+    void setAlert(Alert predicate);
+    void refreshAlerts(); // the predicate's answers changed
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void loadingChanged(bool loading);
+
+private:
+    void fetch(bool firstPage);
+    void accept(QueryResult &rows, bool firstPage);
+    void append(QueryResult &rows, bool firstPage);
+    void insertWritten(const WrittenRow &row);
+    void setBusy(bool on);
+
+    PageQuery query;
+    QList<Column> columns;
+    int pageSize;
+    Alert alert;
+
+    QHash<QString, int> fields;   // query column -> index in values
+    QVector<qint64> ids;
+    QList<QVariantList> values;
+
+    qint64 lastId = 0;            // keyset cursor: id of the last row listed
+    bool atEnd = true;
+    bool busy = false;
+    QList<WrittenRow> written;    // appended while a page was in flight
+};
+
+#endif // SQLPAGEMODEL_H
@@ -0,0 +1,161 @@
+#include "LIICsvImporter.h"
+#include <QFile>
+#include <QTextStream>
+#include <QLocale>
+
+// =========================================================
+// RECORD PARSING
+// =========================================================
+
+const QList<LIICsvImporter::Field> &LIICsvImporter::fields() {
+    static const QList<Field> list = {
+        {"kmp",            "KMP",            true,  false},
+        {"position",       "Position",       false, false},
+        {"batch",          "Batch/Item",     true,  false},
+        {"desc",           "Mat. Code (430)", false, false},
+        {"weight_elem",    "Element (g)",    false, true},
+        {"weight_fissile", "Fissile (g)",    false, true},
+        {"weight_pu",      "Plutonium (g)",  false, true},
+        {"burnup",         "Burnup",         false, true},
+    };
+    return list;
+}
+
+// Reads one logical record. A quoted field may contain line breaks, so keep
+// appending physical lines while the quote count is odd.
+static bool readRecord(QTextStream &in, QString &record, int &lineNo) {
+    if (in.atEnd()) return false;
+    record = in.readLine();
+    ++lineNo;
+    while (record.count('"') % 2 != 0 && !in.atEnd()) {
+        record += '\n' + in.readLine();
+        ++lineNo;
+    }
+    return true;
+}
+
+QStringList LIICsvImporter::splitRecord(const QString &record, QChar delimiter) {
+    QStringList out;
+    QString cur;
+    bool inQuotes = false;
+    for (int i = 0; i < record.size(); ++i) {
+        const QChar c = record.at(i);
+        if (inQuotes) {
+            if (c == '"') {
+                if (i + 1 < record.size() && record.at(i + 1) == '"') { cur += '"'; ++i; }
+                else inQuotes = false;
+            } else {
+                cur += c;
+            }
+        } else if (c == '"') {
+            inQuotes = true;
+        } else if (c == delimiter) {
+            out << cur.trimmed();
+            cur.clear();
+        } else {
+            cur += c;
+        }
+    }
+    out << cur.trimmed();
+    return out;
+}
+
+QStringList LIICsvImporter::readHeader(const QString &fileName, QChar delimiter, QString *error) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = file.errorString();
+        return {};
+    }
+    QTextStream in(&file);
+    QString record;
+    int lineNo = 0;
+    if (!readRecord(in, record, lineNo)) {
+        if (error) *error = "The file is empty.";
+        return {};
+    }
+    if (record.startsWith(QChar(0xFEFF))) record.remove(0, 1); // UTF-8 BOM
+    return splitRecord(record, delimiter);
+}
+
+// =========================================================
+// IMPORT LOOP (worker thread)
+// =========================================================
+
+LIICsvImporter::LIICsvImporter(const QString &fileName, QChar delimiter,
+                               const QMap<QString, int> &mapping, int batchSize)
+    : fileName(fileName), delimiter(delimiter), mapping(mapping),
+      batchSize(batchSize), cancelled(0) {}
+
+bool LIICsvImporter::parseRow(const QStringList &cols, QMap<QString, QVariant> &row, QString *reason) const {
+    const QLocale c = QLocale::c();
+    for (const Field &f : fields()) {
+        const int idx = mapping.value(f.key, -1);
+        const QString text = (idx >= 0 && idx < cols.size()) ? cols.at(idx) : QString();
+
+        if (f.required && text.isEmpty()) {
+            *reason = QString("%1 is empty.").arg(f.label);
+            return false;
+        }
+        if (!f.numeric) {
+            row[f.key] = text;
+            continue;
+        }
+        if (text.isEmpty()) { row[f.key] = 0.0; continue; }
+
+        bool ok = false;
+        double v = c.toDouble(text, &ok);
+        if (!ok) v = QLocale().toDouble(text, &ok); // accept the user's decimal separator too
+        if (!ok || v < 0) {
+            *reason = QString("%1 '%2' is not a non-negative number.").arg(f.label, text);
+            return false;
+        }
+        row[f.key] = v;
+    }
+    return true;
+}
+
+void LIICsvImporter::run() {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        emit finished(false, file.errorString());
+        return;
+    }
+    const qint64 total = file.size();
+    QTextStream in(&file);
+
+    QString record;
+    int lineNo = 0;
+    readRecord(in, record, lineNo); // skip header
+
+    QList<QMap<QString, QVariant>> rows;
+    QList<int> lines;
+    rows.reserve(batchSize);
+    lines.reserve(batchSize);
+
+    while (!cancelled.loadRelaxed()) {
+        const int startLine = lineNo + 1;
+        if (!readRecord(in, record, lineNo)) break;
+        if (record.trimmed().isEmpty()) continue;
+
+        QMap<QString, QVariant> row;
+        QString reason;
+        if (!parseRow(splitRecord(record, delimiter), row, &reason)) {
+            emit rowRejected(startLine, reason);
+            continue;
+        }
+        rows << row;
+        lines << startLine;
+
+        if (rows.size() >= batchSize) {
+            // Blocks until the GUI thread has committed the batch (backpressure)
+            emit batchReady(rows, lines);
+            rows.clear();
+            lines.clear();
+            emit progress(file.pos(), total);
+        }
+    }
+
+    if (!rows.isEmpty() && !cancelled.loadRelaxed()) emit batchReady(rows, lines);
+    emit progress(total, total);
+    emit finished(!cancelled.loadRelaxed(), cancelled.loadRelaxed() ? QString("Import cancelled.") : QString());
+}
@@ -0,0 +1,63 @@
+#ifndef LIICSVIMPORTER_H
+#define LIICSVIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QVariant>
+#include <QAtomicInt>
+
+// Streaming CSV/TSV reader for LII physical inventory listings.
+// Runs on a worker thread: the file is read one record at a time and handed
+// to the GUI thread in fixed-size batches, so memory stays bounded no matter
+// how large the listing is. Rows are type-checked here; the database layer
+// validates again before inserting.
+class LIICsvImporter : public QObject {
+    Q_OBJECT
+
+public:
+    struct Field {
+        QString key;       // lii_manual column / addLIIEntry key
+        QString label;     // shown in the mapping dialog
+        bool required;
+        bool numeric;
+    };
+
+    // Target columns in lii_manual, in mapping-dialog order
+    static const QList<Field> &fields();
+
+    // Reads only the header record (used to populate the column mapping)
+    static QStringList readHeader(const QString &fileName, QChar delimiter, QString *error = nullptr);
+
+    // Splits one logical CSV record (RFC 4180 quoting, "" as escaped quote)
+    static QStringList splitRecord(const QString &record, QChar delimiter);
+
+    // mapping: field key -> column index in the file (-1 / absent = not mapped)
+    LIICsvImporter(const QString &fileName, QChar delimiter,
+                   const QMap<QString, int> &mapping, int batchSize = 2000);
+
+    void cancel() { cancelled.storeRelaxed(1); }
+
+public slots:
+    void run();
+
+signals:
+    // lines[i] is the 1-based file line rows[i] started on (for error reporting)
+    void batchReady(const QList<QMap<QString, QVariant>> &rows, const QList<int> &lines);
+    void rowRejected(int line, const QString &reason);
+    void progress(qint64 bytesRead, qint64 totalBytes);
+    void finished(bool ok, const QString &error);
+
+private:
+    bool parseRow(const QStringList &cols, QMap<QString, QVariant> &row, QString *reason) const;
+
+    QString fileName;
+    QChar delimiter;
+    QMap<QString, int> mapping;
+    int batchSize;
+    QAtomicInt cancelled;
+};
+
+#endif // LIICSVIMPORTER_H
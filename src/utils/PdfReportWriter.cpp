@@ -0,0 +1,260 @@
+#include "PdfReportWriter.h"
+#include <QFontMetrics>
+#include <QPageSize>
+#include <algorithm>
+
+static const QColor HEADER_FILL(0xf0, 0xf0, 0xf0);
+static const QColor TOTAL_FILL(0xf9, 0xf9, 0xf9);
+
+PdfReportWriter::PdfReportWriter(const QString &filename, QPageLayout::Orientation orientation)
+    : writer(filename),
+      titleFont("Helvetica", 16, QFont::Bold), textFont("Helvetica", 10), boldFont("Helvetica", 10, QFont::Bold),
+      cellFont("Helvetica", 8), headerFont("Helvetica", 8, QFont::Bold),
+      titleMetrics(titleFont), textMetrics(textFont), boldMetrics(boldFont),
+      cellMetrics(cellFont), headerMetrics(headerFont) {
+    titleFont.setUnderline(true);
+    writer.setResolution(300);
+    writer.setPageSize(QPageSize(QPageSize::A4));
+    writer.setPageOrientation(orientation);
+    writer.setPageMargins(QMarginsF(12, 12, 12, 12), QPageLayout::Millimeter);
+
+    // Metrics depend on the resolution just set
+    titleMetrics = QFontMetrics(titleFont, &writer);
+    textMetrics = QFontMetrics(textFont, &writer);
+    boldMetrics = QFontMetrics(boldFont, &writer);
+    cellMetrics = QFontMetrics(cellFont, &writer);
+    headerMetrics = QFontMetrics(headerFont, &writer);
+    gridPen = QPen(Qt::black, mm(0.2));
+
+    area = QRect(QPoint(0, 0), writer.pageLayout().paintRectPixels(writer.resolution()).size());
+    // Room for the page number at the foot of every page
+    area.setBottom(area.bottom() - textMetrics.height() - mm(3));
+    pad = mm(1.2);
+    painter.begin(&writer);
+}
+
+int PdfReportWriter::mm(qreal millimetres) const {
+    return qRound(millimetres * writer.resolution() / 25.4);
+}
+
+int PdfReportWriter::textHeight(const QString &text, int width, const QFontMetrics &fm) const {
+    // Most cells are one short line: skip the word-wrap layout for those
+    if (!text.contains('\n') && fm.horizontalAdvance(text) <= width) return fm.height();
+    return fm.boundingRect(QRect(0, 0, width, 1 << 20), Qt::AlignHCenter | Qt::TextWordWrap, text).height();
+}
+
+int PdfReportWriter::rowHeight(const QStringList &cells, const QFontMetrics &fm) const {
+    int h = 0;
+    for (int c = 0; c < colW.size() && c < cells.size(); ++c)
+        h = qMax(h, textHeight(cells.at(c), colW[c] - 2 * pad, fm));
+    return h + 2 * pad;
+}
+
+// =========================================================
+// PAGES
+// =========================================================
+
+void PdfReportWriter::ensureSpace(int height) {
+    if (y + height > area.bottom() && y > 0) newPage();
+}
+
+void PdfReportWriter::newPage() {
+    drawPageNumber();
+    writer.newPage();
+    ++pageNumber;
+    y = 0;
+    rowsOnPage = 0;
+    if (!runningTitle.isEmpty()) {
+        painter.setFont(boldFont);
+        const int h = textHeight(runningTitle, area.width(), boldMetrics);
+        painter.drawText(QRect(0, y, area.width(), h), Qt::AlignLeft, runningTitle + " (continued)");
+        y += h + mm(2);
+    }
+}
+
+void PdfReportWriter::drawPageNumber() {
+    painter.setFont(textFont);
+    painter.drawText(QRect(0, area.bottom() + mm(3), area.width(), textMetrics.height()),
+                     Qt::AlignHCenter, QString("Page %1").arg(pageNumber));
+}
+
+// =========================================================
+// TEXT
+// =========================================================
+
+void PdfReportWriter::addTitle(const QString &title) {
+    if (!painter.isActive()) return;
+    const int h = textHeight(title, area.width(), titleMetrics);
+    ensureSpace(h);
+    painter.setFont(titleFont);
+    painter.drawText(QRect(0, y, area.width(), h), Qt::AlignHCenter | Qt::TextWordWrap, title);
+    y += h + mm(4);
+    runningTitle = title;
+}
+
+void PdfReportWriter::addTextGrid(const QList<QStringList> &rows, const QList<qreal> &widths, bool bold) {
+    if (!painter.isActive()) return;
+    const QFont &font = bold ? boldFont : textFont;
+    const QFontMetrics &fm = bold ? boldMetrics : textMetrics;
+
+    QList<qreal> w = widths;
+    if (w.isEmpty()) {
+        int n = 1;
+        for (const QStringList &r : rows) n = qMax(n, int(r.size()));
+        w = QList<qreal>(n, 1.0);
+    }
+    qreal total = 0;
+    for (qreal x : w) total += x;
+    QVector<int> left;
+    qreal acc = 0;
+    for (qreal x : w) { left << qRound(acc / total * area.width()); acc += x; }
+    left << area.width();
+
+    for (const QStringList &row : rows) {
+        auto cellRect = [&](int c, int h) {
+            const int right = c == row.size() - 1 ? area.width() : left[c + 1]; // last cell takes the rest
+            return QRect(left[c], y, right - left[c] - pad, h);
+        };
+        int h = 0;
+        for (int c = 0; c < row.size() && c < w.size(); ++c)
+            h = qMax(h, textHeight(row[c], cellRect(c, 0).width(), fm));
+        ensureSpace(h);
+        painter.setFont(font);
+        for (int c = 0; c < row.size() && c < w.size(); ++c)
+            painter.drawText(cellRect(c, h), Qt::AlignLeft | Qt::TextWordWrap, row[c]);
+        y += h + mm(1);
+    }
+    y += mm(3);
+}
+
+// =========================================================
+// TABLE
+// =========================================================
+
+void PdfReportWriter::beginTable(const QList<qreal> &widths, const QList<QList<HeaderCell>> &headerRows,
+                                 CarryRow carryRow) {
+    if (!painter.isActive()) return;
+    inTable = true;
+    carry = std::move(carryRow);
+
+    // 1. Column edges; the last column absorbs the rounding
+    qreal total = 0;
+    for (qreal x : widths) total += x;
+    colX.clear(); colW.clear();
+    qreal acc = 0;
+    for (qreal x : widths) { colX << qRound(acc / total * area.width()); acc += x; }
+    for (int c = 0; c < colX.size(); ++c)
+        colW << (c + 1 < colX.size() ? colX[c + 1] : area.width()) - colX[c];
+    shades = QVector<QColor>(colX.size());
+
+    // 2. Place the header cells on a grid, as a browser lays out a <thead>
+    const int rows = headerRows.size(), cols = colX.size();
+    struct Slot { int row, col; HeaderCell cell; };
+    QVector<Slot> placed;
+    QVector<QVector<bool>> used(rows, QVector<bool>(cols, false));
+    for (int r = 0; r < rows; ++r) {
+        int c = 0;
+        for (const HeaderCell &cell : headerRows[r]) {
+            while (c < cols && used[r][c]) ++c;
+            if (c >= cols) break;
+            for (int rr = r; rr < qMin(rows, r + cell.rowSpan); ++rr)
+                for (int cc = c; cc < qMin(cols, c + cell.colSpan); ++cc) used[rr][cc] = true;
+            placed.append({ r, c, cell });
+            c += cell.colSpan;
+        }
+    }
+    auto spanWidth = [&](const Slot &s) {
+        const int last = qMin(cols, s.col + s.cell.colSpan) - 1;
+        return colX[last] + colW[last] - colX[s.col];
+    };
+
+    // 3. Row heights: single-row cells first, then grow the last row a tall span covers
+    QVector<int> rowH(rows, headerMetrics.height() + 2 * pad);
+    for (const Slot &s : placed)
+        if (s.cell.rowSpan == 1)
+            rowH[s.row] = qMax(rowH[s.row], textHeight(s.cell.text, spanWidth(s) - 2 * pad, headerMetrics) + 2 * pad);
+    for (const Slot &s : placed) {
+        if (s.cell.rowSpan == 1) continue;
+        const int last = qMin(rows, s.row + s.cell.rowSpan) - 1;
+        int have = 0;
+        for (int r = s.row; r <= last; ++r) have += rowH[r];
+        const int need = textHeight(s.cell.text, spanWidth(s) - 2 * pad, headerMetrics) + 2 * pad;
+        if (need > have) rowH[last] += need - have;
+    }
+    QVector<int> rowTop(rows + 1, 0);
+    for (int r = 0; r < rows; ++r) rowTop[r + 1] = rowTop[r] + rowH[r];
+    headerHeight = rowTop[rows];
+
+    header.clear();
+    for (const Slot &s : placed) {
+        const int last = qMin(rows, s.row + s.cell.rowSpan);
+        header.append({ QRect(colX[s.col], rowTop[s.row], spanWidth(s), rowTop[last] - rowTop[s.row]), s.cell });
+    }
+
+    carryHeight = headerMetrics.height() + 2 * pad;
+
+    // 4. Header plus at least one row on this page
+    ensureSpace(headerHeight + carryHeight * 2);
+    drawHeader();
+}
+
+void PdfReportWriter::setColumnShade(int column, const QColor &color) {
+    if (column >= 0 && column < shades.size()) shades[column] = color;
+}
+
+void PdfReportWriter::drawHeader() {
+    painter.setFont(headerFont);
+    painter.setPen(gridPen);
+    for (const PlacedCell &p : header) {
+        if (!p.cell.framed) continue;
+        const QRect r = p.rect.translated(0, y);
+        painter.fillRect(r, HEADER_FILL);
+        painter.drawRect(r);
+        painter.drawText(r.adjusted(pad, pad, -pad, -pad), Qt::AlignCenter | Qt::TextWordWrap, p.cell.text);
+    }
+    y += headerHeight;
+    rowsOnPage = 0;
+}
+
+void PdfReportWriter::drawRow(const QStringList &cells, RowStyle style, int height) {
+    painter.setFont(style == Total ? headerFont : cellFont);
+    painter.setPen(gridPen);
+    for (int c = 0; c < colX.size(); ++c) {
+        const QRect r(colX[c], y, colW[c], height);
+        if (style == Total) painter.fillRect(r, TOTAL_FILL);
+        else if (shades[c].isValid()) painter.fillRect(r, shades[c]);
+        painter.drawRect(r);
+        painter.drawText(r.adjusted(pad, pad, -pad, -pad), Qt::AlignCenter | Qt::TextWordWrap, cells.value(c));
+    }
+    y += height;
+}
+
+void PdfReportWriter::addRow(const QStringList &cells, RowStyle style) {
+    if (!inTable) return;
+    const int h = rowHeight(cells, style == Total ? headerMetrics : cellMetrics);
+    const int reserve = carry ? carryHeight : 0;
+
+    // Page full: close it with the subtotals so far, reopen with them
+    if (y + h + reserve > area.bottom() && rowsOnPage > 0) {
+        if (carry) drawRow(carry("Carried forward"), Total, carryHeight);
+        newPage();
+        drawHeader();
+        if (carry) drawRow(carry("Brought forward"), Total, carryHeight);
+    }
+    drawRow(cells, style, h);
+    ++rowsOnPage;
+}
+
+void PdfReportWriter::endTable() {
+    if (!inTable) return;
+    inTable = false;
+    carry = CarryRow();
+    y += mm(4);
+}
+
+bool PdfReportWriter::finish() {
+    if (!painter.isActive()) return false;
+    endTable();
+    drawPageNumber();
+    return painter.end();
+}
@@ -0,0 +1,108 @@
+#ifndef PDFREPORTWRITER_H
+#define PDFREPORTWRITER_H
+
+#include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QList>
+#include <QPageLayout>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPen>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+// Paginated table report drawn straight onto a PDF, one page at a time.
+//
+// Rows are laid out and painted as they are added; a finished page goes to
+// the file and nothing of it is kept, so memory stays at one page however
+// long the report is (the HTML -> QTextDocument path held the whole report
+// as markup and as a document). The table header is repeated on every page
+// the table runs onto, pages are numbered, and a table with a carry row
+// closes each full page with "Carried forward" subtotals and opens the
+// next one with the same "Brought forward".
+//
+//     PdfReportWriter pdf(filename);
+//     pdf.addTitle("Nuclear Loss Items");
+//     pdf.addTextGrid({ { "COUNTRY:", country, "DATE:", date } }, { 15, 35, 15, 35 });
+//     pdf.beginTable(widths, header, carry);
+//     while (...) pdf.addRow(cells);
+//     pdf.endTable();
+//     return pdf.finish();
+class PdfReportWriter {
+public:
+    struct HeaderCell {
+        QString text;
+        int colSpan = 1;
+        int rowSpan = 1;
+        bool framed = true; // false: blank corner cell, no border or fill
+    };
+    enum RowStyle { Plain, Total };
+    // Cells of the subtotal row so far, `label` ("Carried forward" /
+    // "Brought forward") placed where the report wants it. Called before
+    // the row that does not fit is drawn, so it must return the total of
+    // the rows added so far.
+    using CarryRow = std::function<QStringList(const QString &label)>;
+
+    explicit PdfReportWriter(const QString &filename,
+                             QPageLayout::Orientation orientation = QPageLayout::Landscape);
+
+    // Underlined, centred heading; repeated small on later pages
+    void addTitle(const QString &title);
+    // Borderless rows of text in columns of relative `widths` (equal if
+    // empty); a row with fewer cells lets its last cell take the rest
+    void addTextGrid(const QList<QStringList> &rows, const QList<qreal> &widths = {}, bool bold = true);
+
+    // Starts a table with columns of relative `widths`. `header` rows are
+    // placed like an HTML <thead> (colSpan / rowSpan).
+    void beginTable(const QList<qreal> &widths, const QList<QList<HeaderCell>> &header,
+                    CarryRow carry = CarryRow());
+    void setColumnShade(int column, const QColor &color); // e.g. balance columns
+    void addRow(const QStringList &cells, RowStyle style = Plain);
+    void endTable();
+
+    // Ends the last page and closes the file; false if it could not be written
+    bool finish();
+
+private:
+    struct PlacedCell {
+        QRect rect; // relative to the top of the header
+        HeaderCell cell;
+    };
+
+    int mm(qreal millimetres) const;
+    int textHeight(const QString &text, int width, const QFontMetrics &fm) const;
+    int rowHeight(const QStringList &cells, const QFontMetrics &fm) const;
+    void ensureSpace(int height);
+    void newPage();
+    void drawPageNumber();
+    void drawHeader();
+    void drawRow(const QStringList &cells, RowStyle style, int height);
+
+    QPdfWriter writer;
+    QPainter painter;
+    QRect area;          // printable area, device pixels
+    int y = 0;           // top of the next thing drawn
+    int pageNumber = 1;
+    int pad;             // cell padding
+    QString runningTitle;
+
+    QFont titleFont, textFont, boldFont, cellFont, headerFont;
+    // Measured once for the writer's resolution, not per cell
+    QFontMetrics titleMetrics, textMetrics, boldMetrics, cellMetrics, headerMetrics;
+    QPen gridPen;
+
+    // Current table
+    bool inTable = false;
+    QVector<int> colX, colW;
+    QVector<QColor> shades;
+    QVector<PlacedCell> header;
+    int headerHeight = 0;
+    CarryRow carry;
+    int carryHeight = 0;
+    int rowsOnPage = 0;
+};
+
+#endif // PDFREPORTWRITER_H
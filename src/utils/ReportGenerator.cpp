@@ -1,12 +1,12 @@
 #include "ReportGenerator.h"
-#include <QPrinter>
-#include <QTextDocument>
+#include "PdfReportWriter.h"
+#include "RowTemplate.h"
+#include "TableWriter.h"
+#include "../db/LedgerBalanceEngine.h"
+#include "../db/Mass.h"
 #include <QFile>
-#include <QTextStream>
 #include <QVariant>
 #include <QDate>
-#include <QPageSize>
-#include <QPageLayout>
 #include <QDebug>
 
 // =============================================================================
@@ -14,411 +14,226 @@
 // =============================================================================
 
 // PDF Version (Uses QMap for Headers)
-bool ReportGenerator::generateICR_PDF(const QString &filename, const QMap<QString, QString> &headerData, QSqlQuery &data) {
-    QString html = generateICR_HTML(headerData, data);
-    
-    QTextDocument document;
-    document.setHtml(html);
-    
-    QPrinter printer(QPrinter::PrinterResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setPageSize(QPageSize::A4);
-    printer.setPageOrientation(QPageLayout::Landscape);
-    printer.setOutputFileName(filename);
-
-    document.print(&printer);
-    return true;
-}
-
-// Excel Version (Uses old signature with int reportNo - Fixes your Linker Error)
-bool ReportGenerator::generateICR_Excel(const QString &filename, const QString &mba, const QString &start, const QString &end, int reportNo, QSqlQuery &data) {
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
-
-    QTextStream out(&file);
-    out << "Inventory Change Report (ICR)\n";
-    out << "MBA:," << mba << "\n";
-    out << "Period:," << start << " to " << end << "\n";
-    out << "Report No:," << reportNo << "\n\n";
-    
-    out << "Date,Batch,Code,Items,Element,Increase U,Decrease U\n";
-
-    while(data.next()) {
-        out << data.value("record_date").toString() << ",";
-        out << data.value("batch_number").toString() << ",";
-        out << data.value("change_type").toString() << ",";
-        out << data.value("items_count").toInt() << ",";
-        out << data.value("element").toString() << ",";
-        out << data.value("increase_u").toDouble() << ",";
-        out << data.value("decrease_u").toDouble() << "\n";
-    }
-    file.close();
-    return true;
-}
-
-// HTML Helper (Uses QMap)
-QString ReportGenerator::generateICR_HTML(const QMap<QString, QString> &headerData, QSqlQuery &data) {
-    QString html = "<html><head><style>"
-                   "body { font-family: Helvetica; font-size: 10pt; }"
-                   "table { width: 100%; border-collapse: collapse; margin-top: 10px; }"
-                   "th, td { border: 1px solid black; padding: 5px; text-align: center; vertical-align: middle; font-size: 9pt; }"
-                   "th { background-color: #f0f0f0; font-weight: bold; }"
-                   ".meta-table { width: 100%; border: none; margin-bottom: 20px; font-weight: bold; }"
-                   ".meta-table td { border: none; text-align: left; padding: 2px; }"
-                   ".footer-table { width: 100%; border: none; margin-top: 40px; }"
-                   ".footer-table td { border: none; text-align: left; padding: 5px; font-size: 10pt; }"
-                   "h2 { text-align: center; font-size: 16pt; text-decoration: underline; margin-bottom: 5px; }"
-                   "</style></head><body>";
-
-    html += "<h2>Inventory Change Document</h2>";
-    
-    html += "<table class='meta-table'>"
-            "<tr>"
-            "<td width='15%'>COUNTRY:</td><td width='35%'>" + headerData["country"] + "</td>"
-            "<td width='15%'>DATE:</td><td width='35%'>" + headerData["date"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>FACILITY:</td><td>" + headerData["facility"] + "</td>"
-            "<td>REPORT NO:</td><td>" + headerData["reportNo"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>MBA:</td><td>" + headerData["mba"] + "</td>"
-            "<td></td><td></td>"
-            "</tr>"
-            "</table>";
-
-    html += "<table><thead>"
-            "<tr>"
-            "<th colspan='4' style='border:none;'></th>"
-            "<th colspan='4'>Uranium</th>"
-            "<th colspan='2'>Plutonium</th>"
-            "</tr>"
-            "<tr>"
-            "<th>Line</th><th>Batch Identity</th><th>No. of Items</th><th>Inventory<br>Change Code</th>"
-            "<th>Element<br>Code</th><th>Isotope<br>Code</th><th>Element<br>weight(g)</th><th>Isotope<br>weight(g)</th>"
-            "<th>Element<br>Code</th><th>Element<br>Weight(g)</th>"
-            "</tr></thead><tbody>";
+bool ReportGenerator::generateICR_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                      const RowTick &tick) {
+    PdfReportWriter pdf(filename);
+    pdf.addTitle("Inventory Change Document");
+    pdf.addTextGrid({ { "COUNTRY:", headerData["country"], "DATE:", headerData["date"] },
+                      { "FACILITY:", headerData["facility"], "REPORT NO:", headerData["reportNo"] },
+                      { "MBA:", headerData["mba"] } },
+                    { 15, 35, 15, 35 });
 
     int line = 1;
-    double totalItems = 0;
-    double sumU_Elem = 0, sumU_Iso = 0, sumPu = 0;
+    int totalItems = 0;
+    Mass sumU_Elem, sumU_Iso, sumPu; // exact: whole milligrams
+
+    auto totals = [&](const QString &label) {
+        return QStringList{ "", label, QString::number(totalItems), "", "", "",
+                            sumU_Elem.toString(0), sumU_Iso.toString(0), "", sumPu.toString(0) };
+    };
+    pdf.beginTable({ 5, 14, 8, 9, 8, 8, 12, 12, 8, 12 },
+                   { { { "", 4, 1, false }, { "Uranium", 4 }, { "Plutonium", 2 } },
+                     { { "Line" }, { "Batch Identity" }, { "No. of Items" }, { "Inventory\nChange Code" },
+                       { "Element\nCode" }, { "Isotope\nCode" }, { "Element\nweight(g)" }, { "Isotope\nweight(g)" },
+                       { "Element\nCode" }, { "Element\nWeight(g)" } } },
+                   totals);
+
+    static const RowTemplate layout({ "{count}", "{text}", "{count}", "{text}",
+                                      "{text}", "{text}", "{mass:0}", "{mass:0}",  // Uranium
+                                      "{text}", "{mass:0}" });                      // Plutonium
+    RowTemplate::Row row = layout.row();
+    const QString isoCode = "G", puCode = "P";
+
+    const int fBatch = data.field("batch_number"), fItems = data.field("items_count"),
+              fCode = data.field("change_type"), fElement = data.field("element"),
+              fInc = data.field("increase_u"), fDec = data.field("decrease_u"), fIso = data.field("weight_u235");
 
     while(data.next()) {
-        QString batch = data.value("batch_number").toString();
-        int items = data.value("items_count").toInt();
+        QString batch = data.text(fBatch);
+        int items = int(data.count(fItems));
         if(items == 0) items = 1;
-        QString code = data.value("change_type").toString();
-        QString rawEl = data.value("element").toString(); 
+        QString code = data.text(fCode);
+        QString rawEl = data.text(fElement); 
         QString elCode = rawEl.left(1); 
 
-        double wInc = data.value("increase_u").toDouble();
-        double wDec = data.value("decrease_u").toDouble();
-        double wElem = (wInc > 0) ? wInc : wDec;
-        
-        double wIso = data.value("weight_u235").toDouble();
+        const Mass wInc = data.mass(fInc);
+        const Mass wDec = data.mass(fDec);
+        const Mass wElem = (wInc > Mass()) ? wInc : wDec;
         
-        totalItems += items;
-
-        html += "<tr>";
-        html += "<td>" + QString::number(line++) + "</td>";
-        html += "<td>" + batch + "</td>";
-        html += "<td>" + QString::number(items) + "</td>";
-        html += "<td>" + code + "</td>";
+        const Mass wIso = data.mass(fIso);
 
+        row.setCount(0, line++);
+        row.setText(1, batch);
+        row.setCount(2, items);
+        row.setText(3, code);
         if(elCode != "P") {
-            sumU_Elem += wElem; sumU_Iso += wIso;
-            html += "<td>" + elCode + "</td><td>G</td>";
-            html += "<td>" + QString::number(wElem, 'f', 0) + "</td>";
-            html += "<td>" + QString::number(wIso, 'f', 0) + "</td>";
-            html += "<td></td><td></td>";
+            row.setText(4, elCode); row.setText(5, isoCode);
+            row.setMass(6, wElem); row.setMass(7, wIso);
+            row.clear(8); row.clear(9);
         } else {
-            sumPu += wElem;
-            html += "<td></td><td></td><td></td><td></td>";
-            html += "<td>P</td><td>" + QString::number(wElem, 'f', 0) + "</td>";
+            row.clear(4); row.clear(5); row.clear(6); row.clear(7);
+            row.setText(8, puCode); row.setMass(9, wElem);
         }
-        html += "</tr>";
+        // Drawn before the totals move: a page break carries the rows above it
+        pdf.addRow(row.cells());
+        if (tick && !tick()) return false;
+
+        totalItems += items;
+        if(elCode != "P") { sumU_Elem += wElem; sumU_Iso += wIso; }
+        else sumPu += wElem;
     }
 
-    html += "<tr style='font-weight:bold; background-color:#f9f9f9;'>"
-            "<td></td><td>Totals</td><td>" + QString::number(totalItems) + "</td>"
-            "<td></td><td></td><td></td>"
-            "<td>" + QString::number(sumU_Elem, 'f', 0) + "</td>"
-            "<td>" + QString::number(sumU_Iso, 'f', 0) + "</td>"
-            "<td></td><td>" + QString::number(sumPu, 'f', 0) + "</td>"
-            "</tr>";
-
-    html += "</tbody></table>";
-
-    html += "<table class='footer-table'>"
-            "<tr>"
-            "<td width='50%'><b>Shipper-Receiver Difference</b></td>"
-            "<td width='50%'><b>Shipment Date:</b> Start</td>"
-            "</tr>"
-            "<tr>"
-            "<td>Date Measured: _________________</td>"
-            "<td><b>Receiving Date:</b> " + headerData["date"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>Shipper: " + headerData["shipper"] + "</td>"
-            "<td>Receiver: " + headerData["receiver"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>Signature: ______________________</td>"
-            "<td>Signature: ______________________</td>"
-            "</tr>"
-            "</table>";
-
-    html += "</body></html>";
-    return html;
+    pdf.addRow(totals("Totals"), PdfReportWriter::Total);
+    pdf.endTable();
+
+    pdf.addTextGrid({ { "Shipper-Receiver Difference", "Shipment Date: Start" },
+                      { "Date Measured: _________________", "Receiving Date: " + headerData["date"] },
+                      { "Shipper: " + headerData["shipper"], "Receiver: " + headerData["receiver"] },
+                      { "Signature: ______________________", "Signature: ______________________" } },
+                    { 50, 50 }, false);
+    return pdf.finish();
 }
 
 // =============================================================================
 // 4. LIST OF INVENTORY ITEMS (LII)
 // =============================================================================
 
-bool ReportGenerator::generateLII_PDF(const QString &filename, const QMap<QString, QString> &headerData, QSqlQuery &data) {
-    QString html = generateLII_HTML(headerData, data);
-    
-    QTextDocument document;
-    document.setHtml(html);
-    
-    QPrinter printer(QPrinter::PrinterResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setPageSize(QPageSize::A4);
-    printer.setPageOrientation(QPageLayout::Landscape);
-    printer.setOutputFileName(filename);
-
-    document.print(&printer);
-    return true;
-}
-
-QString ReportGenerator::generateLII_HTML(const QMap<QString, QString> &headerData, QSqlQuery &data) {
-    QString html = "<html><head><style>"
-                   "body { font-family: Helvetica; font-size: 8pt; }"
-                   "table { width: 100%; border-collapse: collapse; margin-top: 10px; }"
-                   "th, td { border: 1px solid black; padding: 4px; text-align: center; vertical-align: middle; }"
-                   "th { background-color: #f0f0f0; font-weight: bold; }"
-                   ".meta-table { width: 100%; border: none; margin-bottom: 10px; }"
-                   ".meta-table td { border: none; text-align: left; padding: 2px; font-size: 10pt; }"
-                   "h2 { text-align: center; margin-bottom: 5px; text-decoration: underline; }"
-                   "</style></head><body>";
-
-    html += "<h2>LIST OF INVENTORY ITEMS (LII)</h2>";
-    
-    html += "<table class='meta-table'>"
-            "<tr><td width='15%'><b>COUNTRY:</b></td><td width='35%'>" + headerData["country"] + "</td>"
-            "<td width='15%'><b>DATE:</b></td><td width='35%'>" + headerData["date"] + "</td></tr>"
-            "<tr><td><b>FACILITY:</b></td><td>" + headerData["facility"] + "</td>"
-            "<td><b>REPORT NO:</b></td><td>" + headerData["reportNo"] + "</td></tr>"
-            "<tr><td><b>MBA:</b></td><td>" + headerData["mba"] + "</td><td></td><td></td></tr>"
-            "</table>";
-
-    html += "<table><thead>"
-            "<tr>"
-            "<th colspan='2'>Location</th>"
-            "<th colspan='2'>Identification</th>"
-            "<th rowspan='2'>Material<br>Description</th>"
-            "<th colspan='2'>Uranium</th>"
-            "<th rowspan='2'>Plutonium<br>(g)</th>"
-            "<th rowspan='2'>Thorium<br>(g)</th>"
-            "<th colspan='2'>Nuclear</th>"
-            "<th colspan='2'>Irradiated fuel</th>"
-            "</tr>"
-            "<tr>"
-            "<th>KMP</th><th>Position</th>"
-            "<th>Item</th><th>Batch</th>"
-            "<th>Element (g)</th><th>Fissile (g)</th>"
-            "<th>Loss (g)</th><th>Production (g)</th>"
-            "<th>Burnup</th><th>Cooling</th>"
-            "</tr></thead><tbody>";
-
-    // Loop through query
+bool ReportGenerator::generateLII_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                      const RowTick &tick) {
+    PdfReportWriter pdf(filename);
+    pdf.addTitle("LIST OF INVENTORY ITEMS (LII)");
+    pdf.addTextGrid({ { "COUNTRY:", headerData["country"], "DATE:", headerData["date"] },
+                      { "FACILITY:", headerData["facility"], "REPORT NO:", headerData["reportNo"] },
+                      { "MBA:", headerData["mba"] } },
+                    { 15, 35, 15, 35 });
+
+    pdf.beginTable({ 7, 7, 5, 10, 12, 8, 8, 7, 7, 7, 8, 7, 7 },
+                   { { { "Location", 2 }, { "Identification", 2 }, { "Material\nDescription", 1, 2 },
+                       { "Uranium", 2 }, { "Plutonium\n(g)", 1, 2 }, { "Thorium\n(g)", 1, 2 },
+                       { "Nuclear", 2 }, { "Irradiated fuel", 2 } },
+                     { { "KMP" }, { "Position" }, { "Item" }, { "Batch" },
+                       { "Element (g)" }, { "Fissile (g)" }, { "Loss (g)" }, { "Production (g)" },
+                       { "Burnup" }, { "Cooling" } } });
+
+    // FIX: Display "1" for Item count in PDF
+    static const RowTemplate layout({ "{text}", "{text}", "1", "{text}", "{text}",
+                                      "{mass:1}", "{mass:1}", "{mass:1}",
+                                      "0.00", "0.0", "0.0", "{real}", "-" });
+    RowTemplate::Row row = layout.row();
+
+    // Fields of lii_manual
+    const int fKmp = data.field("kmp"), fPos = data.field("position"), fBatch = data.field("batch"),
+              fDesc = data.field("desc"), fElem = data.field("weight_elem"), fFissile = data.field("weight_fissile"),
+              fPu = data.field("weight_pu"), fBurnup = data.field("burnup");
+
+    // Loop through rows
     while(data.next()) {
-        // MATCH THESE KEYS WITH LIIWidget::exportPDF temp table
-        QString kmp = data.value("kmp").toString();
-        QString pos = data.value("position").toString(); 
-        QString batch = data.value("batch").toString();
-        QString desc = data.value("desc").toString();
-        double u = data.value("weight_elem").toDouble();
-        double u235 = data.value("weight_fissile").toDouble();
-        double pu = data.value("weight_pu").toDouble();
-        double bu = data.value("burnup").toDouble();
-
-        html += "<tr>";
-        html += "<td>" + kmp + "</td>";
-        html += "<td>" + pos + "</td>";
-        
-        // FIX: Display "1" for Item count in PDF
-        html += "<td>1</td>";
-        
-        html += "<td>" + batch + "</td>";
-        html += "<td>" + desc + "</td>";
-        html += "<td>" + (u > 0 ? QString::number(u, 'f', 1) : "0.0") + "</td>";
-        html += "<td>" + (u235 > 0 ? QString::number(u235, 'f', 1) : "0.0") + "</td>";
-        html += "<td>" + (pu > 0 ? QString::number(pu, 'f', 1) : "0.0") + "</td>";
-        html += "<td>0.00</td>";
-        html += "<td>0.0</td><td>0.0</td>"; 
-        html += "<td>" + QString::number(bu) + "</td><td>-</td>";
-        html += "</tr>";
+        QString kmp = data.text(fKmp);
+        QString pos = data.text(fPos); 
+        QString batch = data.text(fBatch);
+        QString desc = data.text(fDesc);
+        const Mass u = data.mass(fElem);
+        const Mass u235 = data.mass(fFissile);
+        const Mass pu = data.mass(fPu);
+        double bu = data.real(fBurnup);
+
+        row.setText(0, kmp); row.setText(1, pos);
+        row.setText(3, batch); row.setText(4, desc);
+        row.setMass(5, u); row.setMass(6, u235); row.setMass(7, pu);
+        row.setReal(11, bu);
+        pdf.addRow(row.cells());
+        if (tick && !tick()) return false;
     }
-    html += "</tbody></table></body></html>";
-    return html;
+    return pdf.finish();
 }
 
 // =============================================================================
 // 6. NUCLEAR LOSS ITEMS (NLI)
 // =============================================================================
 
-bool ReportGenerator::generateNLI_PDF(const QString &filename, const QMap<QString, QString> &headerData, QSqlQuery &data) {
-    // 1. Generate the HTML content using the helper function
-    QString html = generateNLI_HTML(headerData, data);
-    
-    // 2. Set up the document
-    QTextDocument document;
-    document.setHtml(html);
-    
-    // 3. Configure Printer
-    QPrinter printer(QPrinter::PrinterResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setPageSize(QPageSize::A4);
-    printer.setPageOrientation(QPageLayout::Landscape); // Landscape fits the wide table better
-    printer.setOutputFileName(filename);
-
-    // 4. Print
-    document.print(&printer);
-    return true;
-}
+bool ReportGenerator::generateNLI_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                      const RowTick &tick) {
+    PdfReportWriter pdf(filename);
 
-QString ReportGenerator::generateNLI_HTML(const QMap<QString, QString> &headerData, QSqlQuery &data) {
-    QString html = "<html><head><style>"
-                   "body { font-family: Helvetica; font-size: 10pt; }"
-                   "table { width: 100%; border-collapse: collapse; margin-top: 15px; }"
-                   "th, td { border: 1px solid black; padding: 6px; text-align: center; font-size: 9pt; vertical-align: middle; }"
-                   "th { background-color: #f0f0f0; font-weight: bold; }"
-                   // Header Styles
-                   ".title-section { text-align: center; margin-bottom: 25px; }"
-                   "h1 { margin: 0; font-size: 18pt; text-decoration: underline; font-weight: bold; }"
-                   "h2 { margin: 5px 0 0 0; font-size: 12pt; font-weight: normal; }"
-                   // Metadata Table Styles
-                   ".meta-table { width: 100%; border: none; margin-bottom: 20px; }"
-                   ".meta-table td { border: none; text-align: left; padding: 4px; font-size: 10pt; font-weight: bold; }"
-                   "</style></head><body>";
-
-    // 1. Title Section
-    html += "<div class='title-section'>"
-            "<h1>Nuclear Loss Items</h1>"
-            "</div>";
-
-    // 2. Metadata Section
-    html += "<table class='meta-table'>"
-            "<tr>"
-            "<td width='15%'>COUNTRY:</td><td width='35%'>" + headerData["country"] + "</td>"
-            "<td width='15%'>DATE:</td><td width='35%'>" + headerData["date"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>FACILITY:</td><td>" + headerData["facility"] + "</td>"
-            "<td>REPORT NO:</td><td>" + headerData["reportNo"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>MBA:</td><td>" + headerData["mba"] + "</td>"
-            "<td></td><td></td>"
-            "</tr>"
-            "</table>";
-
-    // 3. Main Data Table
-    html += "<table><thead>"
-            // Row 1: Category Headers
-            "<tr>"
-            // colspan=4 covers: Line, Batch, Items, Code
-            "<th colspan='4' style='border:none; border-bottom:1px solid black; background-color:white;'></th>" 
-            "<th colspan='4'>Uranium</th>"
-            "<th colspan='2'>Plutonium</th>"
-            "</tr>"
-            // Row 2: Column Headers (Split Line and Batch)
-            "<tr>"
-            "<th width='5%'>Line</th>"
-            "<th width='12%'>Batch Identity</th>"
-            "<th width='8%'>No. of<br>Items</th>"
-            "<th width='8%'>Inventory<br>Change Code</th>"
-            // Uranium
-            "<th width='8%'>Element<br>Code</th>"
-            "<th width='8%'>Isotope<br>Code</th>"
-            "<th width='12%'>Element<br>weight (g)</th>"
-            "<th width='12%'>Isotope<br>weight (g)</th>"
-            // Plutonium
-            "<th width='8%'>Element<br>Code</th>"
-            "<th width='12%'>Element<br>Weight (g)</th>"
-            "</tr></thead><tbody>";
+    // 1. Title and metadata
+    pdf.addTitle("Nuclear Loss Items");
+    pdf.addTextGrid({ { "COUNTRY:", headerData["country"], "DATE:", headerData["date"] },
+                      { "FACILITY:", headerData["facility"], "REPORT NO:", headerData["reportNo"] },
+                      { "MBA:", headerData["mba"] } },
+                    { 15, 35, 15, 35 });
 
     int line = 1;
-    double totItems = 0;
-    double totUWt = 0, totUIso = 0, totPWt = 0;
+    int totItems = 0;
+    Mass totUWt, totUIso, totPWt; // exact: whole milligrams
+
+    // 2. Main data table; each full page carries its totals to the next
+    auto totals = [&](const QString &label) {
+        return QStringList{ "", label, QString::number(totItems), "", "", "",
+                            totUWt.toString(0), totUIso.toString(0), "", totPWt.toString(0) };
+    };
+    pdf.beginTable({ 5, 12, 8, 8, 8, 8, 12, 12, 8, 12 },
+                   { { { "", 4, 1, false }, { "Uranium", 4 }, { "Plutonium", 2 } },
+                     { { "Line" }, { "Batch Identity" }, { "No. of\nItems" }, { "Inventory\nChange Code" },
+                       { "Element\nCode" }, { "Isotope\nCode" }, { "Element\nweight (g)" }, { "Isotope\nweight (g)" },
+                       { "Element\nCode" }, { "Element\nWeight (g)" } } },
+                   totals);
+
+    static const RowTemplate layout({ "{count}", "{text}", "{count}", "{text}",
+                                      "{text}", "{text}", "{mass:0}", "{mass:0}",  // Uranium
+                                      "{text}", "{mass:0}" });                      // Plutonium
+    RowTemplate::Row row = layout.row();
+    const QString dash = "-";
+
+    const int fBatch = data.field("batch"), fItems = data.field("items"), fCode = data.field("code"),
+              fUElem = data.field("u_elem_code"), fUIso = data.field("u_iso_code"),
+              fUWt = data.field("u_weight"), fUIsoWt = data.field("u_iso_weight"),
+              fPElem = data.field("p_elem_code"), fPWt = data.field("p_weight");
 
     while(data.next()) {
-        QString batch = data.value("batch").toString();
-        int items = data.value("items").toInt();
-        QString code = data.value("code").toString();
+        QString batch = data.text(fBatch);
+        int items = int(data.count(fItems));
+        QString code = data.text(fCode);
         
-        QString u_elem = data.value("u_elem_code").toString();
-        QString u_iso = data.value("u_iso_code").toString();
-        double u_wt = data.value("u_weight").toDouble();
-        double u_iso_wt = data.value("u_iso_weight").toDouble();
+        QString u_elem = data.text(fUElem);
+        QString u_iso = data.text(fUIso);
+        const Mass u_wt = data.mass(fUWt);
+        const Mass u_iso_wt = data.mass(fUIsoWt);
         
-        QString p_elem = data.value("p_elem_code").toString();
-        double p_wt = data.value("p_weight").toDouble();
+        QString p_elem = data.text(fPElem);
+        const Mass p_wt = data.mass(fPWt);
 
-        totItems += items;
-        totUWt += u_wt;
-        totUIso += u_iso_wt;
-        totPWt += p_wt;
+        row.setCount(0, line++);
+        row.setText(1, batch);
+        row.setCount(2, items);
+        row.setText(3, code);
 
-        html += "<tr>";
-        // Separate columns for Line and Batch
-        html += "<td>" + QString::number(line++) + "</td>";
-        html += "<td>" + batch + "</td>";
-        html += "<td>" + QString::number(items) + "</td>";
-        html += "<td>" + code + "</td>";
-        
         // Uranium Data
-        if(u_wt > 0 || !u_elem.isEmpty()) {
-            html += "<td>" + u_elem + "</td>";
-            html += "<td>" + u_iso + "</td>";
-            html += "<td>" + QString::number(u_wt, 'f', 0) + "</td>";
-            html += "<td>" + QString::number(u_iso_wt, 'f', 0) + "</td>";
+        if(u_wt > Mass() || !u_elem.isEmpty()) {
+            row.setText(4, u_elem); row.setText(5, u_iso);
+            row.setMass(6, u_wt); row.setMass(7, u_iso_wt);
         } else {
-            html += "<td>-</td><td>-</td><td>-</td><td>-</td>";
+            for (int c = 4; c <= 7; ++c) row.setText(c, dash);
         }
 
         // Plutonium Data
-        if(p_wt > 0 || !p_elem.isEmpty()) {
-            html += "<td>" + p_elem + "</td>";
-            html += "<td>" + QString::number(p_wt, 'f', 0) + "</td>";
+        if(p_wt > Mass() || !p_elem.isEmpty()) {
+            row.setText(8, p_elem); row.setMass(9, p_wt);
         } else {
-            html += "<td>-</td><td>-</td>";
+            row.setText(8, dash); row.setText(9, dash);
         }
-        
-        html += "</tr>";
+
+        pdf.addRow(row.cells());
+        if (tick && !tick()) return false;
+
+        totItems += items;
+        totUWt += u_wt;
+        totUIso += u_iso_wt;
+        totPWt += p_wt;
     }
 
-    // 4. Totals Row
-    html += "<tr style='font-weight:bold; background-color:#f9f9f9;'>"
-            "<td colspan='2' style='text-align:right'>Totals</td>" // Span Line+Batch
-            "<td>" + QString::number(totItems) + "</td>"
-            "<td></td>" // Code
-            "<td></td>" // U Elem
-            "<td></td>" // U Iso
-            "<td>" + QString::number(totUWt, 'f', 0) + "</td>"
-            "<td>" + QString::number(totUIso, 'f', 0) + "</td>"
-            "<td></td>" // P Elem
-            "<td>" + QString::number(totPWt, 'f', 0) + "</td>"
-            "</tr>";
-
-    html += "</tbody></table>";
-
-    // FOOTER REMOVED as requested
-
-    html += "</body></html>";
-    return html;
+    // 3. Totals Row
+    pdf.addRow(totals("Totals"), PdfReportWriter::Total);
+    return pdf.finish();
 }
 
 
@@ -426,230 +241,260 @@ QString ReportGenerator::generateNLI_HTML(const QMap<QString, QString> &headerDa
 // 5. GENERAL LEDGER (GL) - FIXED LOGIC
 // =============================================================================
 
-bool ReportGenerator::generateGL_PDF(const QString &filename, const QMap<QString, QString> &headerInfo, QSqlQuery &data) {
-    QString html = generateGL_HTML(headerInfo, data);
-    
-    QTextDocument document;
-    document.setHtml(html);
-    
-    QPrinter printer(QPrinter::PrinterResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setPageSize(QPageSize::A4);
-    printer.setPageOrientation(QPageLayout::Landscape); 
-    printer.setOutputFileName(filename);
-
-    document.print(&printer);
-    return true;
-}
-
-QString ReportGenerator::generateGL_HTML(const QMap<QString, QString> &headerInfo, QSqlQuery &data) {
-    QString html = "<html><head><style>"
-                   "body { font-family: Helvetica; font-size: 9pt; }"
-                   "table { width: 100%; border-collapse: collapse; margin-top: 15px; }"
-                   "th, td { border: 1px solid black; padding: 4px; text-align: center; font-size: 8pt; }"
-                   "th { background-color: #f0f0f0; font-weight: bold; }"
-                   "h2 { text-align: center; margin-bottom: 20px; }"
-                   ".meta-table { width: 100%; border: none; margin-bottom: 5px; }"
-                   ".meta-table td { border: none; text-align: left; padding: 5px; font-size: 10pt; font-weight: bold; }"
-                   "</style></head><body>";
-
-    html += "<h2>General Ledger</h2>";
-
-    html += "<table class='meta-table'>"
-            "<tr>"
-            "<td width='60%'>Facility: " + headerInfo["facility"] + "</td>"
-            "<td width='40%'>MBA: " + headerInfo["mba"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td colspan='2'>Material Description: " + headerInfo["desc"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td colspan='2'>"
-            "Element Code: " + headerInfo["elemCode"] + "&nbsp;&nbsp;&nbsp;&nbsp;"
-            "Isotope Code: " + headerInfo["isoCode"] + "&nbsp;&nbsp;&nbsp;&nbsp;"
-            "Unit: " + headerInfo["unit"] +
-            "</td>"
-            "</tr>"
-            "</table>";
-
-    html += "<table><thead>"
-            "<tr>"
-            "<th rowspan='3'>Line</th>"
-            "<th rowspan='3'>Date</th>"
-            "<th rowspan='3'>ICD/PIL</th>"
-            "<th rowspan='3'>IC Code</th>"
-            "<th rowspan='3'>No. of<br>Items</th>"
-            "<th colspan='4'>Increases</th>"
-            "<th colspan='4'>Decreases</th>"
-            "<th colspan='2'>Inventory</th>"
-            "<th rowspan='3'>No. of<br>items</th>"
-            "</tr>"
-            "<tr>"
-            "<th colspan='2'>Receipts</th><th colspan='2'>Other</th>"
-            "<th colspan='2'>Shipments</th><th colspan='2'>Other</th>"
-            "<th colspan='2'></th>" 
-            "</tr>"
-            "<tr>"
-            "<th>U</th><th>U-235</th><th>U</th><th>U-235</th>"
-            "<th>U</th><th>U-235</th><th>U</th><th>U-235</th>"
-            "<th>U</th><th>U-235</th>"
-            "</tr></thead><tbody>";
-
+bool ReportGenerator::generateGL_PDF(const QString &filename, const QMap<QString, QString> &headerInfo, RowSource &data,
+                                     const RowTick &tick) {
+    PdfReportWriter pdf(filename);
+    pdf.addTitle("General Ledger");
+    pdf.addTextGrid({ { "Facility: " + headerInfo["facility"], "MBA: " + headerInfo["mba"] },
+                      { "Material Description: " + headerInfo["desc"] },
+                      { "Element Code: " + headerInfo["elemCode"] + "    "
+                        "Isotope Code: " + headerInfo["isoCode"] + "    "
+                        "Unit: " + headerInfo["unit"] } },
+                    { 60, 40 });
+
+    // The running balance is on every row, so nothing needs carrying forward
+    pdf.beginTable({ 4, 8, 9, 5, 5, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 5 },
+                   { { { "Line", 1, 3 }, { "Date", 1, 3 }, { "ICD/PIL", 1, 3 }, { "IC Code", 1, 3 },
+                       { "No. of\nItems", 1, 3 }, { "Increases", 4 }, { "Decreases", 4 }, { "Inventory", 2 },
+                       { "No. of\nitems", 1, 3 } },
+                     { { "Receipts", 2 }, { "Other", 2 }, { "Shipments", 2 }, { "Other", 2 }, { "", 2 } },
+                     { { "U" }, { "U-235" }, { "U" }, { "U-235" }, { "U" }, { "U-235" },
+                       { "U" }, { "U-235" }, { "U" }, { "U-235" } } });
+    for (int c : { 13, 14, 15 }) pdf.setColumnShade(c, QColor("#e8f5e9"));
+
+    static const RowTemplate layout({ "{count}", "{text}", "{text}", "{text}", "{count}",
+                                      "{mass}", "{mass}", "{mass}", "{mass}",    // Increases
+                                      "{mass}", "{mass}", "{mass}", "{mass}",    // Decreases
+                                      "{mass}", "{mass}", "{count}" });          // Inventory
+    RowTemplate::Row row = layout.row();
     int line = 1;
-    double runU = 0, runU235 = 0;
-    int runItems = 0;
+
+    const int fDate = data.field("date"), fRef = data.field("ref"), fCode = data.field("code"),
+              fType = data.field("type"), fU = data.field("u_weight"), fU235 = data.field("u235_weight"),
+              fItems = data.field("items"), fBalU = data.field("bal_u"), fBalU235 = data.field("bal_u235"),
+              fBalItems = data.field("bal_items");
 
     while(data.next()) {
-        QString date = data.value("date").toString();
-        QString ref = data.value("ref").toString();
-        QString code = data.value("code").toString();
-        QString type = data.value("type").toString();
+        QString date = data.text(fDate);
+        QString ref = data.text(fRef);
+        QString code = data.text(fCode);
+        const LedgerBalanceEngine::Type type = LedgerBalanceEngine::typeOf(data.text(fType));
         
-        double u = data.value("u_weight").toDouble();
-        double u235 = data.value("u235_weight").toDouble();
-        int items = data.value("items").toInt();
-
-        // --- FIXED REPORT LOGIC ---
-        if(type == "Receipt") {
-            // Receipt: Increases Items
-            runU += u; runU235 += u235; runItems += items;
-        } 
-        else if (type == "Shipment") {
-            // Shipment: Decreases Items
-            runU -= u; runU235 -= u235; runItems -= items;
-        }
-        else if (type == "Other Increase") {
-            runU += u; runU235 += u235;
+        const Mass u = data.mass(fU);
+        const Mass u235 = data.mass(fU235);
+        qint64 items = data.count(fItems);
+
+        // Running balance as stored on the ledger row
+        const Mass runU = data.mass(fBalU);
+        const Mass runU235 = data.mass(fBalU235);
+        const qint64 runItems = data.count(fBalItems);
+
+        row.setCount(0, line++);
+        row.setText(1, date);
+        row.setText(2, ref);
+        row.setText(3, code);
+        if (LedgerBalanceEngine::movesItems(type) && items > 0) row.setCount(4, items);
+        else row.clear(4);
+
+        // Same columns as the General Ledger view
+        int pair = -1;
+        switch (LedgerBalanceEngine::columnOf(type)) {
+        case LedgerBalanceEngine::Receipts:       pair = 5;  break;
+        case LedgerBalanceEngine::OtherIncreases: pair = 7;  break;
+        case LedgerBalanceEngine::Shipments:      pair = 9;  break;
+        case LedgerBalanceEngine::OtherDecreases: pair = 11; break; // Nuclear Loss / Other Decrease
+        case LedgerBalanceEngine::NoColumn:                  break; // PIL sets the balance only
         }
-        else if (type == "Other Decrease" || type == "Nuclear Loss") {
-            // Nuclear Loss: Decreases Weight ONLY. Items stay SAME.
-            runU -= u; runU235 -= u235;
-        }
-        else if (type == "PIL (Set Balance)") {
-            if(line == 1 && runU == 0) {
-                runU = u; runU235 = u235; runItems = items;
-            }
+        for (int c = 5; c <= 12; ++c) {
+            if (c == pair) row.setMass(c, u);
+            else if (c == pair + 1) row.setMass(c, u235);
+            else row.clear(c);
         }
 
-        html += "<tr>";
-        html += "<td>" + QString::number(line++) + "</td>";
-        html += "<td>" + date + "</td>";
-        html += "<td>" + ref + "</td>";
-        html += "<td>" + code + "</td>";
-        
-        QString displayItems = "";
-        if(type == "Receipt" || type == "Shipment") {
-             displayItems = (items > 0 ? QString::number(items) : "");
-        }
-        html += "<td>" + displayItems + "</td>";
+        row.setMass(13, runU);
+        row.setMass(14, runU235);
+        row.setCount(15, runItems);
+        pdf.addRow(row.cells());
+        if (tick && !tick()) return false;
+    }
+    return pdf.finish();
+}
 
-        QString rU="", r235="", oU="", o235="", sU="", s235="", odU="", od235="";
-        
-        if(type == "Receipt") {
-            rU = QString::number(u); r235 = QString::number(u235);
-        } else if (type == "Other Increase") {
-            oU = QString::number(u); o235 = QString::number(u235);
-        } else if (type == "Shipment") {
-            sU = QString::number(u); s235 = QString::number(u235);
-        } else { 
-            // Nuclear Loss / Other Decrease
-            odU = QString::number(u); od235 = QString::number(u235);
-        }
 
-        html += "<td>" + rU + "</td><td>" + r235 + "</td>";
-        html += "<td>" + oU + "</td><td>" + o235 + "</td>";
-        html += "<td>" + sU + "</td><td>" + s235 + "</td>";
-        html += "<td>" + odU + "</td><td>" + od235 + "</td>";
+// =============================================================================
+// MATERIAL BALANCE REPORT (MBR)
+// =============================================================================
 
-        html += "<td style='background-color:#e8f5e9'>" + QString::number(runU) + "</td>";
-        html += "<td style='background-color:#e8f5e9'>" + QString::number(runU235) + "</td>";
-        html += "<td style='background-color:#e8f5e9'>" + QString::number(runItems) + "</td>";
-        html += "</tr>";
+bool ReportGenerator::generateMBR_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                      const RowTick &tick) {
+    PdfReportWriter pdf(filename); // MBR is wide
+    pdf.addTitle("Material Balance Report");
+
+    // Recreate the header layout from the form
+    pdf.addTextGrid({ { "Country: " + headerData["country"],
+                        "Reporting Period From: " + headerData["periodFrom"] + "  To: " + headerData["periodTo"] },
+                      { "Facility: " + headerData["facility"], "Report No. " + headerData["reportNo"] },
+                      { "Material Balance Area: " + headerData["mba"] } },
+                    { 60, 40 });
+
+    // Table header matching the form's merged cells
+    pdf.beginTable({ 8, 10, 20, 10, 10, 8, 14, 10, 10 },
+                   { { { "Entry No.", 1, 2 }, { "Continuation", 1, 2 }, { "Entry Name", 1, 2 },
+                       { "Accountancy Data", 5 }, { "Report No", 1, 2 } },
+                     { { "Element" }, { "Weight of Element" }, { "Unit Kg/g" },
+                       { "Weight Of Fissile Isotopes\n(Uranium Only) (G)" }, { "Isotope Code" } } });
+
+    // Table Data: same cells as the MBR listing
+    static const RowTemplate layout({ "{count}", "{text}", "{text}", "{text}", "{mass}",
+                                      "{text}", "{mass}", "{text}", "{text}" });
+    RowTemplate::Row row = layout.row();
+    const int fCont = data.field("continuation"), fName = data.field("entry_name"),
+              fElement = data.field("element"), fWeight = data.field("weight"), fUnit = data.field("unit"),
+              fFissile = data.field("fissile"), fIsotope = data.field("isotope"), fReport = data.field("report_no");
+    int line = 1;
+    while(data.next()) {
+        row.setCount(0, line++);
+        row.setText(1, data.text(fCont));
+        row.setText(2, data.text(fName));
+        row.setText(3, data.text(fElement));
+        row.setMass(4, data.mass(fWeight));
+        row.setText(5, data.text(fUnit));
+        row.setMass(6, data.mass(fFissile));
+        row.setText(7, data.text(fIsotope));
+        row.setText(8, data.text(fReport));
+        pdf.addRow(row.cells());
+        if (tick && !tick()) return false;
     }
-
-    html += "</tbody></table></body></html>";
-    return html;
+    return pdf.finish();
 }
 
 
 // =============================================================================
-// MATERIAL BALANCE REPORT (MBR)
+// SPREADSHEETS (CSV / SpreadsheetML)
 // =============================================================================
-
-bool ReportGenerator::generateMBR_PDF(const QString &filename, const QMap<QString, QString> &headerData, QTableWidget *table) {
-    QString html = generateMBR_HTML(headerData, table);
-    
-    QTextDocument document;
-    document.setHtml(html);
-    
-    QPrinter printer(QPrinter::PrinterResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setPageSize(QPageSize::A4);
-    printer.setPageOrientation(QPageLayout::Landscape); // MBR is wide
-    printer.setOutputFileName(filename);
-
-    document.print(&printer);
-    return true;
+//
+// The stored rows, one spreadsheet row each, for analysis rather than
+// filing: no form header, no totals or carried balances except where the
+// ledger stores them, masses in grams with every digit kept.
+
+namespace {
+// `type` is the RowTemplate placeholder the value is written with
+struct TableColumn {
+    const char *header;
+    const char *field;
+    const char *type;
+};
 }
 
-QString ReportGenerator::generateMBR_HTML(const QMap<QString, QString> &headerData, QTableWidget *table) {
-    QString html = "<html><head><style>"
-                   "body { font-family: Helvetica; font-size: 10pt; }"
-                   "h1 { text-align: center; margin-bottom: 20px; }"
-                   ".header-table { width: 100%; border: none; margin-bottom: 20px; font-weight: bold; }"
-                   ".header-table td { border: none; padding: 4px; }"
-                   ".data-table { width: 100%; border-collapse: collapse; margin-top: 10px; }"
-                   ".data-table th, .data-table td { border: 1px solid black; padding: 5px; text-align: center; font-size: 9pt; }"
-                   ".data-table th { background-color: #f0f0f0; }"
-                   "</style></head><body>";
-
-    html += "<h1>Material Balance Report</h1>";
-
-    // Recreate the header layout from the image
-    html += "<table class='header-table'>"
-            "<tr>"
-            "<td width='60%'>Country: " + headerData["country"] + "</td>"
-            "<td width='40%'>Reporting Period From: " + headerData["periodFrom"] + "&nbsp;&nbsp;To: " + headerData["periodTo"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>Facility: " + headerData["facility"] + "</td>"
-            "<td>Report No. " + headerData["reportNo"] + "</td>"
-            "</tr>"
-            "<tr>"
-            "<td>Material Balance Area: " + headerData["mba"] + "</td>"
-            "<td></td>"
-            "</tr>"
-            "</table>";
-
-    // Table Header matching the image's merged cells
-    html += "<table class='data-table'>"
-            "<thead>"
-            "<tr>"
-            "<th rowspan='2'>Entry No.</th>"
-            "<th rowspan='2'>Continuation</th>"
-            "<th rowspan='2'>Entry Name</th>"
-            "<th colspan='5'>Accountancy Data</th>"
-            "<th rowspan='2'>Report No</th>"
-            "</tr>"
-            "<tr>"
-            "<th>Element</th>"
-            "<th>Weight of Element</th>"
-            "<th>Unit Kg/g</th>"
-            "<th>Weight Of Fissile Isotopes<br>(Uranium Only) (G)</th>"
-            "<th>Isotope Code</th>"
-            "</tr>"
-            "</thead><tbody>";
-
-    // Table Data
-    for (int i = 0; i < table->rowCount(); ++i) {
-        html += "<tr>";
-        for (int j = 0; j < table->columnCount(); ++j) {
-            QTableWidgetItem *item = table->item(i, j);
-            html += "<td>" + (item ? item->text() : "") + "</td>";
+static bool writeTable(const QString &filename, const QString &sheet, const QVector<TableColumn> &columns,
+                       RowSource &data, const ReportGenerator::RowTick &tick) {
+    QStringList headers, spec;
+    QVector<bool> numeric;
+    QVector<int> fields;
+    for (const TableColumn &c : columns) {
+        headers << c.header;
+        spec << c.type;
+        numeric << (qstrcmp(c.type, "{text}") != 0);
+        fields << data.field(c.field);
+    }
+    const RowTemplate layout(spec);
+
+    TableWriter out(filename);
+    if (!out.begin(sheet, headers, numeric)) return false;
+
+    RowTemplate::Row row = layout.row();
+    while (data.next()) {
+        for (int c = 0; c < fields.size(); ++c) {
+            const QVariant v = data.value(fields[c]);
+            if (v.isNull()) { row.clear(c); continue; } // blank, not 0
+            switch (layout.type(c)) {
+            case RowTemplate::Count: row.setCount(c, v.toLongLong()); break;
+            case RowTemplate::Real:  row.setReal(c, v.toDouble()); break;
+            case RowTemplate::Grams: row.setMass(c, Mass::fromStored(v)); break;
+            default:                 row.setText(c, v.toString()); break;
+            }
         }
-        html += "</tr>";
+        out.addRow(row.cells());
+        if (tick && !tick()) return false;
     }
+    return out.finish();
+}
+
+QString ReportGenerator::exportFilter() {
+    return "PDF Files (*.pdf);;CSV Files (*.csv);;Excel XML Spreadsheet (*.xml)";
+}
+
+bool ReportGenerator::isTable(const QString &filename) {
+    return filename.endsWith(".csv", Qt::CaseInsensitive) || filename.endsWith(".xml", Qt::CaseInsensitive);
+}
+
+bool ReportGenerator::generateICR_Table(const QString &filename, RowSource &data, const RowTick &tick) {
+    return writeTable(filename, "ICR", {
+        { "Date", "record_date", "{text}" },
+        { "Batch", "batch_number", "{text}" },
+        { "Code", "change_type", "{text}" },
+        { "Items", "items_count", "{count}" },
+        { "Form", "physical_form", "{text}" },
+        { "Element", "element", "{text}" },
+        { "Increase (g)", "increase_u", "{mass}" },
+        { "Decrease (g)", "decrease_u", "{mass}" },
+        { "U-235 (g)", "weight_u235", "{mass}" },
+        { "Description", "description", "{text}" },
+    }, data, tick);
+}
+
+bool ReportGenerator::generateLII_Table(const QString &filename, RowSource &data, const RowTick &tick) {
+    return writeTable(filename, "LII", {
+        { "KMP", "kmp", "{text}" },
+        { "Position", "position", "{text}" },
+        { "Batch", "batch", "{text}" },
+        { "Description", "desc", "{text}" },
+        { "Element (g)", "weight_elem", "{mass}" },
+        { "Fissile (g)", "weight_fissile", "{mass}" },
+        { "Pu (g)", "weight_pu", "{mass}" },
+        { "Burnup", "burnup", "{real}" },
+        { "Cooling", "cooling", "{real}" },
+    }, data, tick);
+}
+
+bool ReportGenerator::generateNLI_Table(const QString &filename, RowSource &data, const RowTick &tick) {
+    return writeTable(filename, "NLI", {
+        { "Batch", "batch", "{text}" },
+        { "Items", "items", "{count}" },
+        { "Code", "code", "{text}" },
+        { "U Element Code", "u_elem_code", "{text}" },
+        { "U Isotope Code", "u_iso_code", "{text}" },
+        { "U (g)", "u_weight", "{mass}" },
+        { "U Isotope (g)", "u_iso_weight", "{mass}" },
+        { "Pu Element Code", "p_elem_code", "{text}" },
+        { "Pu (g)", "p_weight", "{mass}" },
+    }, data, tick);
+}
+
+bool ReportGenerator::generateGL_Table(const QString &filename, RowSource &data, const RowTick &tick) {
+    return writeTable(filename, "General Ledger", {
+        { "Date", "date", "{text}" },
+        { "Reference", "ref", "{text}" },
+        { "Code", "code", "{text}" },
+        { "Type", "type", "{text}" },
+        { "Items", "items", "{count}" },
+        { "U (g)", "u_weight", "{mass}" },
+        { "U-235 (g)", "u235_weight", "{mass}" },
+        { "Balance Items", "bal_items", "{count}" },
+        { "Balance U (g)", "bal_u", "{mass}" },
+        { "Balance U-235 (g)", "bal_u235", "{mass}" },
+    }, data, tick);
+}
 
-    html += "</tbody></table></body></html>";
-    return html;
+bool ReportGenerator::generateMBR_Table(const QString &filename, RowSource &data, const RowTick &tick) {
+    return writeTable(filename, "MBR", {
+        { "Continuation", "continuation", "{text}" },
+        { "Entry Name", "entry_name", "{text}" },
+        { "Element", "element", "{text}" },
+        { "Weight (g)", "weight", "{mass}" },
+        { "Unit", "unit", "{text}" },
+        { "Fissile (g)", "fissile", "{mass}" },
+        { "Isotope Code", "isotope", "{text}" },
+        { "Report No", "report_no", "{text}" },
+    }, data, tick);
 }
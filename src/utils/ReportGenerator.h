@@ -2,42 +2,49 @@
 #define REPORTGENERATOR_H
 
 #include <QString>
-#include <QSqlQuery>
 #include <QMap> // <--- Added
-#include <QTableWidget>
+#include <functional>
+#include "RowSource.h"
 
 class ReportGenerator {
 public:
+    // Called once per data row written; returning false stops the report
+    // and the generator returns false (see ReportJob::advance)
+    using RowTick = std::function<bool()>;
+
     // ICR - UPDATED to accept Header Map
-    static bool generateICR_PDF(const QString &filename, const QMap<QString, QString> &headerData, QSqlQuery &data);
-    static bool generateICR_Excel(const QString &filename, const QString &mba, const QString &start, const QString &end, int reportNo, QSqlQuery &data);
+    static bool generateICR_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                const RowTick &tick = RowTick());
 
     // LII - UPDATED to accept Header Map
-    static bool generateLII_PDF(const QString &filename, const QMap<QString, QString> &headerData, QSqlQuery &data);
+    static bool generateLII_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                const RowTick &tick = RowTick());
     
     // NLI
-    static bool generateNLI_PDF(const QString &filename, const QMap<QString, QString> &headerData, QSqlQuery &data);
+    static bool generateNLI_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                const RowTick &tick = RowTick());
 
     // GENERAL LEDGER (Updated Signature)
     // Now accepts 'headerInfo' to pass Facility, Codes, Units from the UI
-    static bool generateGL_PDF(const QString &filename, const QMap<QString, QString> &headerInfo, QSqlQuery &data);
-    
-    // New MBR functions
-    static bool generateMBR_PDF(const QString &filename, const QMap<QString, QString> &headerData, QTableWidget *table);
-
-private:
-    // Updated Helper for ICR
-    static QString generateICR_HTML(const QMap<QString, QString> &headerData, QSqlQuery &data);
-    // NEW Helper for LII
-    static QString generateLII_HTML(const QMap<QString, QString> &headerData, QSqlQuery &data);
-    
-    static QString generateNLI_HTML(const QMap<QString, QString> &headerData, QSqlQuery &data);
+    static bool generateGL_PDF(const QString &filename, const QMap<QString, QString> &headerInfo, RowSource &data,
+                               const RowTick &tick = RowTick());
     
-    // Updated Helper
-    static QString generateGL_HTML(const QMap<QString, QString> &headerInfo, QSqlQuery &data);
-    
-    // New MBR HTML helper
-    static QString generateMBR_HTML(const QMap<QString, QString> &headerData, QTableWidget *table);
+    // MBR: fields of mbr_entries (DatabaseManager::getMBREntries)
+    static bool generateMBR_PDF(const QString &filename, const QMap<QString, QString> &headerData, RowSource &data,
+                                const RowTick &tick = RowTick());
+
+    // Spreadsheets of the same fields, one row per stored row: CSV, or
+    // SpreadsheetML for *.xml (TableWriter)
+    static bool generateICR_Table(const QString &filename, RowSource &data, const RowTick &tick = RowTick());
+    static bool generateLII_Table(const QString &filename, RowSource &data, const RowTick &tick = RowTick());
+    static bool generateNLI_Table(const QString &filename, RowSource &data, const RowTick &tick = RowTick());
+    static bool generateGL_Table(const QString &filename, RowSource &data, const RowTick &tick = RowTick());
+    static bool generateMBR_Table(const QString &filename, RowSource &data, const RowTick &tick = RowTick());
+
+    // Save-dialog filter offering the PDF and both spreadsheet formats, and
+    // whether the name chosen asks for a spreadsheet
+    static QString exportFilter();
+    static bool isTable(const QString &filename);
 };
 
 #endif // REPORTGENERATOR_H
@@ -0,0 +1,10 @@
+#include "RowSource.h"
+#include <QSqlRecord>
+
+int QueryRowSource::field(const QString &name) const {
+    return query.record().indexOf(name);
+}
+
+QVariant QueryRowSource::value(int field) const {
+    return field < 0 ? QVariant() : query.value(field);
+}
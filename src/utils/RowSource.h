@@ -0,0 +1,49 @@
+#ifndef ROWSOURCE_H
+#define ROWSOURCE_H
+
+#include <QSqlQuery>
+#include <QString>
+#include <QVariant>
+#include "../db/Mass.h"
+
+// Rows a report reads. Reports take this rather than a QSqlQuery; the one
+// source today is the export job's database cursor.
+//
+// Values are the stored ones (masses in mg, counts as integers), never
+// display text, so nothing is parsed back from a rounded string. Fields
+// are looked up by name once, before the loop; the typed reads then go
+// by index:
+//
+//     const int batch = data.field("batch"), weight = data.field("u_weight");
+//     while (data.next()) row.setMass(3, data.mass(weight));
+//
+// A field the source does not have is -1 and reads as empty / zero.
+class RowSource {
+public:
+    virtual ~RowSource() = default;
+
+    virtual int field(const QString &name) const = 0;
+    virtual bool next() = 0;
+    virtual QVariant value(int field) const = 0;
+
+    QString text(int field) const { return value(field).toString(); }
+    qint64 count(int field) const { return value(field).toLongLong(); }
+    double real(int field) const { return value(field).toDouble(); }
+    Mass mass(int field) const { return Mass::fromStored(value(field)); }
+};
+
+// Forward cursor over an executed query; rows are read as the report
+// consumes them, never held
+class QueryRowSource : public RowSource {
+public:
+    explicit QueryRowSource(QSqlQuery &query) : query(query) {}
+
+    int field(const QString &name) const override;
+    bool next() override { return query.next(); }
+    QVariant value(int field) const override;
+
+private:
+    QSqlQuery &query;
+};
+
+#endif // ROWSOURCE_H
@@ -0,0 +1,70 @@
+#include "RowTemplate.h"
+#include <charconv>
+
+RowTemplate::RowTemplate(const QStringList &spec) {
+    cells.reserve(spec.size());
+    for (const QString &entry : spec) {
+        Cell cell;
+        if (entry == "{text}")       cell.type = Text;
+        else if (entry == "{count}") cell.type = Count;
+        else if (entry == "{real}")  cell.type = Real;
+        else if (entry == "{mass}")  cell.type = Grams;
+        else if (entry.startsWith("{mass:") && entry.endsWith('}')) {
+            cell.type = Grams;
+            cell.decimals = qBound(0, entry.mid(6, entry.size() - 7).toInt(), 3);
+        } else {
+            cell.literal = entry;
+        }
+        cells << cell;
+    }
+}
+
+// =========================================================
+// ROW BUFFER
+// =========================================================
+
+RowTemplate::Row::Row(const RowTemplate *layout) : layout(layout) {
+    buffer.reserve(layout->cells.size());
+    for (const Cell &cell : layout->cells) buffer << cell.literal;
+}
+
+QString &RowTemplate::Row::reuse(int column) {
+    Q_ASSERT(layout->cells[column].type != Literal);
+    QString &cell = buffer[column];
+    cell.truncate(0);
+    return cell;
+}
+
+void RowTemplate::Row::setText(int column, const QString &text) {
+    buffer[column] = text; // shares the value, no copy
+}
+
+void RowTemplate::Row::setCount(int column, qint64 n) {
+    // Digits right to left into a local buffer, as Mass::appendTo
+    char text[24];
+    char *p = text + sizeof(text);
+    quint64 magnitude = n < 0 ? 0 - quint64(n) : quint64(n);
+    do { *--p = char('0' + magnitude % 10); magnitude /= 10; } while (magnitude > 0);
+    if (n < 0) *--p = '-';
+    reuse(column).append(QLatin1StringView(p, text + sizeof(text) - p));
+}
+
+void RowTemplate::Row::setReal(int column, double v) {
+    // Same text as QString::number(v): %g with 6 significant digits, but
+    // never with the process locale's decimal comma
+    char text[32];
+    const std::to_chars_result r = std::to_chars(text, text + sizeof(text), v, std::chars_format::general, 6);
+    reuse(column).append(QLatin1StringView(text, r.ptr - text));
+}
+
+void RowTemplate::Row::setMass(int column, Mass m) {
+    const int decimals = layout->cells[column].decimals;
+    if (decimals < 0) m.appendTo(reuse(column));
+    else m.appendTo(reuse(column), decimals);
+}
+
+void RowTemplate::Row::clear(int column) {
+    QString &cell = buffer[column];
+    if (cell.isDetached()) cell.truncate(0); // keep the capacity for the next number
+    else cell = QString();                   // shared text: just let go of it
+}
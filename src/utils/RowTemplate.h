@@ -0,0 +1,66 @@
+#ifndef ROWTEMPLATE_H
+#define ROWTEMPLATE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "../db/Mass.h"
+
+// Cell layout of a report table row, compiled once per report type.
+//
+// The spec has one entry per column: a typed placeholder - "{text}",
+// "{count}", "{real}", "{mass}" (grams, digits as needed) or "{mass:N}"
+// (N = 0-3 decimals) - or any other text, which is a literal printed on
+// every row. Templates are immutable, so one function-local static serves
+// every export of that report, on any thread:
+//
+//     static const RowTemplate layout({ "{count}", "{text}", "G", "{mass:0}" });
+//     RowTemplate::Row row = layout.row();
+//     while (data.next()) {
+//         row.setCount(0, line++);
+//         row.setText(1, data.text(batch));
+//         row.setMass(3, data.mass(weight));
+//         pdf.addRow(row.cells());
+//     }
+//
+// A Row is the render buffer of one export. Literal cells are filled in
+// when it is created and never touched again; numbers are formatted in
+// place into the same strings row after row, so once they have grown to
+// the widest value a row costs no allocation.
+class RowTemplate {
+public:
+    enum Type { Literal, Text, Count, Real, Grams };
+
+    explicit RowTemplate(const QStringList &spec);
+
+    class Row {
+    public:
+        void setText(int column, const QString &text);
+        void setCount(int column, qint64 n);
+        void setReal(int column, double v);
+        void setMass(int column, Mass m); // with the column's decimals
+        void clear(int column);           // placeholder left blank on this row
+
+        const QStringList &cells() const { return buffer; }
+
+    private:
+        friend class RowTemplate;
+        explicit Row(const RowTemplate *layout);
+        QString &reuse(int column); // emptied, capacity kept
+        const RowTemplate *layout;
+        QStringList buffer;
+    };
+
+    Row row() const { return Row(this); }
+    Type type(int column) const { return cells[column].type; }
+
+private:
+    struct Cell {
+        Type type = Literal;
+        QString literal;
+        int decimals = -1; // Grams: -1 = as many as needed
+    };
+    QVector<Cell> cells;
+};
+
+#endif // ROWTEMPLATE_H
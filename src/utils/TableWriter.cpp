@@ -0,0 +1,183 @@
+#include "TableWriter.h"
+
+// Written out once this much has been encoded
+static const qsizetype BUFFER_SIZE = 256 * 1024;
+// Excel's grid, header row included
+static const qint64 SHEET_ROWS = 1048576;
+
+TableWriter::Format TableWriter::formatFor(const QString &filename) {
+    return filename.endsWith(".xml", Qt::CaseInsensitive) ? SpreadsheetML : Csv;
+}
+
+TableWriter::TableWriter(const QString &filename) : TableWriter(filename, formatFor(filename)) {}
+
+TableWriter::TableWriter(const QString &filename, Format format)
+    : file(filename), format(format),
+      encoder(QStringEncoder::Utf8, QStringConverter::Flag::Stateless) {
+    buffer.reserve(BUFFER_SIZE + 4096);
+}
+
+bool TableWriter::begin(const QString &sheetName, const QStringList &headers, const QVector<bool> &numeric) {
+    this->sheetName = sheetName;
+    this->headers = headers;
+    this->numeric = numeric;
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    if (format == Csv) {
+        buffer.append("\xEF\xBB\xBF");
+        writeHeader();
+    } else {
+        buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+                      "<?mso-application progid=\"Excel.Sheet\"?>\r\n"
+                      "<Workbook xmlns=\"urn:schemas-microsoft-com:office:spreadsheet\""
+                      " xmlns:ss=\"urn:schemas-microsoft-com:office:spreadsheet\">\r\n"
+                      "<Styles><Style ss:ID=\"h\"><Font ss:Bold=\"1\"/></Style></Styles>\r\n");
+        openSheet();
+    }
+    return true;
+}
+
+void TableWriter::addRow(const QStringList &cells) {
+    if (format == Csv) {
+        for (int c = 0; c < cells.size(); ++c) {
+            if (c > 0) buffer.append(',');
+            putCsvField(cells.at(c));
+        }
+        buffer.append("\r\n");
+    } else {
+        if (rowsInSheet == SHEET_ROWS) {
+            closeSheet();
+            openSheet();
+        }
+        buffer.append("<Row>");
+        for (int c = 0; c < cells.size(); ++c) {
+            const QString &cell = cells.at(c);
+            if (cell.isEmpty()) {
+                buffer.append("<Cell/>");
+                continue;
+            }
+            buffer.append(c < numeric.size() && numeric[c] ? "<Cell><Data ss:Type=\"Number\">"
+                                                           : "<Cell><Data ss:Type=\"String\">");
+            putXmlText(cell);
+            buffer.append("</Data></Cell>");
+        }
+        buffer.append("</Row>\r\n");
+        ++rowsInSheet;
+    }
+    flushIfFull();
+}
+
+bool TableWriter::finish() {
+    if (!file.isOpen()) return false;
+    if (format == SpreadsheetML) {
+        closeSheet();
+        buffer.append("</Workbook>\r\n");
+    }
+    flush();
+    file.close();
+    return !failed && file.error() == QFileDevice::NoError;
+}
+
+// =========================================================
+// WORKSHEETS (SpreadsheetML)
+// =========================================================
+
+void TableWriter::openSheet() {
+    ++sheet;
+    buffer.append("<Worksheet ss:Name=\"");
+    putXmlText(sheet == 1 ? sheetName : sheetName + " (" + QString::number(sheet) + ")");
+    buffer.append("\"><Table>\r\n");
+    rowsInSheet = 0;
+    writeHeader();
+}
+
+void TableWriter::closeSheet() {
+    buffer.append("</Table></Worksheet>\r\n");
+}
+
+void TableWriter::writeHeader() {
+    if (format == Csv) {
+        for (int c = 0; c < headers.size(); ++c) {
+            if (c > 0) buffer.append(',');
+            putCsvField(headers.at(c));
+        }
+        buffer.append("\r\n");
+        return;
+    }
+    buffer.append("<Row>");
+    for (const QString &h : headers) {
+        buffer.append("<Cell ss:StyleID=\"h\"><Data ss:Type=\"String\">");
+        putXmlText(h);
+        buffer.append("</Data></Cell>");
+    }
+    buffer.append("</Row>\r\n");
+    ++rowsInSheet;
+}
+
+// =========================================================
+// ENCODING
+// =========================================================
+
+void TableWriter::put(QStringView text) {
+    // UTF-8 straight into the buffer's spare capacity: no QByteArray per cell
+    const qsizetype at = buffer.size();
+    buffer.resize(at + encoder.requiredSpace(text.size()));
+    char *end = encoder.appendToBuffer(buffer.data() + at, text);
+    buffer.resize(end - buffer.constData());
+}
+
+void TableWriter::putCsvField(QStringView text) {
+    bool quote = false;
+    for (QChar ch : text) {
+        if (ch == u',' || ch == u'"' || ch == u'\r' || ch == u'\n') { quote = true; break; }
+    }
+    if (!quote) {
+        put(text);
+        return;
+    }
+    buffer.append('"');
+    qsizetype from = 0;
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        if (text[i] != u'"') continue;
+        put(text.mid(from, i + 1 - from)); // up to and including the quote...
+        buffer.append('"');                // ...which is doubled
+        from = i + 1;
+    }
+    put(text.mid(from));
+    buffer.append('"');
+}
+
+void TableWriter::putXmlText(QStringView text) {
+    // Runs of plain text in one go; markup characters escaped, and control
+    // characters XML 1.0 cannot carry at all dropped
+    qsizetype from = 0;
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const char16_t ch = text[i].unicode();
+        const char *entity = nullptr;
+        switch (ch) {
+        case u'&': entity = "&amp;"; break;
+        case u'<': entity = "&lt;"; break;
+        case u'>': entity = "&gt;"; break;
+        case u'"': entity = "&quot;"; break;
+        case u'\n': entity = "&#10;"; break;
+        case u'\r': entity = "&#13;"; break;
+        case u'\t': continue;
+        default:
+            if (ch >= 0x20) continue;
+            entity = "";
+        }
+        put(text.mid(from, i - from));
+        buffer.append(entity);
+        from = i + 1;
+    }
+    put(text.mid(from));
+}
+
+void TableWriter::flushIfFull() {
+    if (buffer.size() >= BUFFER_SIZE) flush();
+}
+
+void TableWriter::flush() {
+    if (!buffer.isEmpty() && file.write(buffer) != buffer.size()) failed = true;
+    buffer.resize(0); // capacity kept (QByteArray::clear() would free it)
+}
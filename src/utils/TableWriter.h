@@ -0,0 +1,70 @@
+#ifndef TABLEWRITER_H
+#define TABLEWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringConverter>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// A report's rows written as a spreadsheet, straight through to the file.
+//
+// Cells are encoded into one output buffer that goes to disk whenever it
+// fills, so memory stays at the buffer however many rows are written and a
+// row costs no allocation once the buffer is sized. Two formats:
+//
+//   Csv            RFC 4180: comma separated, CRLF line ends, a field with
+//                  a comma, quote or line break quoted and its quotes
+//                  doubled. UTF-8 with a byte order mark, which Excel
+//                  needs to read it as UTF-8.
+//   SpreadsheetML  Excel 2003 XML workbook: numeric columns are typed as
+//                  numbers, and a table longer than a worksheet carries on
+//                  in the next sheet under the same header.
+//
+//     TableWriter out(filename);
+//     out.begin("LII", { "Batch", "Weight (g)" }, { false, true });
+//     while (...) out.addRow(cells);
+//     return out.finish();
+class TableWriter {
+public:
+    enum Format { Csv, SpreadsheetML };
+
+    // SpreadsheetML for *.xml, CSV for anything else
+    static Format formatFor(const QString &filename);
+
+    explicit TableWriter(const QString &filename);
+    TableWriter(const QString &filename, Format format);
+
+    // Opens the file and writes the header row. `numeric` flags the columns
+    // holding numbers (SpreadsheetML types their cells; CSV ignores it).
+    bool begin(const QString &sheetName, const QStringList &headers, const QVector<bool> &numeric);
+    void addRow(const QStringList &cells);
+    // Writes what is buffered and closes the file; false if any write failed
+    bool finish();
+
+private:
+    void openSheet();
+    void closeSheet();
+    void writeHeader();
+    void put(QStringView text);
+    void putCsvField(QStringView text);
+    void putXmlText(QStringView text);
+    void flushIfFull();
+    void flush();
+
+    QFile file;
+    Format format;
+    QStringEncoder encoder;
+    QByteArray buffer;
+    bool failed = false;
+
+    QString sheetName;
+    QStringList headers;
+    QVector<bool> numeric;
+    int sheet = 0;
+    qint64 rowsInSheet = 0;
+};
+
+#endif // TABLEWRITER_H